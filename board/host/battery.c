@@ -27,11 +27,13 @@ int sb_i2c_xfer(int port, uint16_t addr_flags, const uint8_t *out, int out_size,
 		return EC_ERROR_UNIMPLEMENTED;
 	if (out_size == 1) {
 		/* Read */
-		if (in_size != 2)
-			/* We are not doing a read16, assume read string */
-			return EC_SUCCESS;
-		else
+		if (in_size == 2)
 			*(uint16_t *)in = mock_smart_battery[out[0]];
+		else if (in_size % 2 == 0 &&
+			 out[0] + in_size / 2 <= SB_MANUFACTURER_NAME)
+			/* Burst read of consecutive word registers */
+			memcpy(in, &mock_smart_battery[out[0]], in_size);
+		/* Otherwise, assume read string */
 	} else {
 		/* write */
 		if (out_size != 3)
@@ -9,6 +9,12 @@
 
 #include "clock.h"
 #include "registers.h"
+#include "util.h"
+
+/* crc32_hash() feeds the unaligned head and the tail of buffers bytewise */
+#ifndef STM32_CRC_DR8
+#error "CONFIG_HW_CRC needs byte access to the CRC data register"
+#endif
 
 static inline void crc32_init(void)
 {
@@ -23,6 +29,45 @@ static inline void crc32_init(void)
 		;
 }
 
+/*
+ * Feed bytes to the CRC unit. The input bits are reflected per byte for
+ * these writes, instead of per word.
+ */
+static inline void crc32_hash_bytes(const uint8_t *p, int size)
+{
+	STM32_CRC_CR = STM32_CRC_CR_REV_OUT | STM32_CRC_CR_REV_IN_BYTE;
+	while (size--)
+		STM32_CRC_DR8 = *p++;
+	STM32_CRC_CR = STM32_CRC_CR_REV_OUT | STM32_CRC_CR_REV_IN_WORD;
+}
+
+/**
+ * Calculate CRC32 of data in arbitrary length.
+ *
+ * Feed the CRC unit whole words, using byte writes only for the unaligned
+ * head and the tail of the buffer.
+ *
+ * @param buf   Data for CRC32 to be calculated for.
+ * @param size  Size of <buf> in bytes.
+ */
+static inline void crc32_hash(const void *buf, int size)
+{
+	const uint8_t *p = buf;
+	int head = MIN(size, (int)(-(uintptr_t)p & 3));
+
+	if (head) {
+		crc32_hash_bytes(p, head);
+		p += head;
+		size -= head;
+	}
+
+	for (; size >= 4; size -= 4, p += 4)
+		STM32_CRC_DR = *(const uint32_t *)p;
+
+	if (size)
+		crc32_hash_bytes(p, size);
+}
+
 static inline void crc32_hash32(uint32_t val)
 {
 	STM32_CRC_DR = val;
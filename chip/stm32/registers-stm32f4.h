@@ -936,6 +936,9 @@ enum dma_channel {
 #define STM32_REQ_USART2_TX 4
 #define STM32_REQ_USART2_RX 4
 
+#define STM32_REQ_USART3_TX 4
+#define STM32_REQ_USART3_RX 4
+
 #define STM32_I2C1_TX_REQ_CH 1
 #define STM32_I2C1_RX_REQ_CH 1
 
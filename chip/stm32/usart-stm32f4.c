@@ -61,6 +61,8 @@ struct usart_hw_config const usart1_hw = {
 	.irq = STM32_IRQ_USART1,
 	.clock_register = &STM32_RCC_APB2ENR,
 	.clock_enable = STM32_RCC_PB2_USART1,
+	.rx_dma_request = STM32_REQ_USART1_RX,
+	.tx_dma_request = STM32_REQ_USART1_TX,
 	.ops = &usart_variant_hw_ops,
 };
 
@@ -79,6 +81,8 @@ struct usart_hw_config const usart2_hw = {
 	.irq = STM32_IRQ_USART2,
 	.clock_register = &STM32_RCC_APB1ENR,
 	.clock_enable = STM32_RCC_PB1_USART2,
+	.rx_dma_request = STM32_REQ_USART2_RX,
+	.tx_dma_request = STM32_REQ_USART2_TX,
 	.ops = &usart_variant_hw_ops,
 };
 
@@ -97,6 +101,8 @@ struct usart_hw_config const usart3_hw = {
 	.irq = STM32_IRQ_USART3,
 	.clock_register = &STM32_RCC_APB1ENR,
 	.clock_enable = STM32_RCC_PB1_USART3,
+	.rx_dma_request = STM32_REQ_USART3_RX,
+	.tx_dma_request = STM32_REQ_USART3_TX,
 	.ops = &usart_variant_hw_ops,
 };
 #endif
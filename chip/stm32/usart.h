@@ -104,6 +104,13 @@ struct usart_hw_config {
 	uint32_t volatile *clock_register;
 	uint32_t clock_enable;
 
+	/*
+	 * DMA request channels of the USART.  Only used on STM32F4, where they
+	 * select which peripheral a DMA stream serves.
+	 */
+	uint8_t rx_dma_request;
+	uint8_t tx_dma_request;
+
 	struct usart_hw_ops const *ops;
 };
 
@@ -261,11 +268,4 @@ struct usart_configs {
 
 struct usart_configs usart_get_configs(void);
 
-/*
- * This usart_tx structure contains function pointer to interrupt
- * handler implemented to send host response. Generic queue based
- * interrupt handler is not used for usart host transport.
- */
-extern struct usart_tx const usart_host_command_tx_interrupt;
-
 #endif /* __CROS_EC_USART_H */
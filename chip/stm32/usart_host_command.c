@@ -16,6 +16,7 @@
 #include "usart-stm32f4.h"
 #include "usart_host_command.h"
 #include "usart_rx_dma.h"
+#include "usart_tx_dma.h"
 #include "util.h"
 
 /* Console output macros */
@@ -57,39 +58,29 @@
 #define USART_MAX_REQUEST_SIZE 0x220
 #define USART_MAX_RESPONSE_SIZE 0x100
 
-/*
- * FIFO size for USART DMA. Should be big enough to handle worst case
- * data processing
- */
-#define USART_DMA_FIFO_SIZE 0x110
-
 /* Local definitions */
 
 /*
  * Raw USART RX/TX byte buffers.
+ *
+ * The RX DMA writes requests straight into usart_in_buffer, which is its
+ * circular FIFO, and the TX DMA sends the response straight out of
+ * usart_out_buffer, where the host command task builds it.  Neither is ever
+ * copied by the CPU.
  */
 static uint8_t usart_in_buffer[USART_MAX_REQUEST_SIZE] __aligned(4);
 static uint8_t usart_out_buffer[USART_MAX_RESPONSE_SIZE] __aligned(4);
 
 /*
  * Maintain head position of in buffer
- * Head always starts with zero and goes up to max bytes.
- * Once the buffer contents are read, it should go back to zero.
+ * Head always starts with zero and counts every byte received by the RX DMA,
+ * including overrun bytes that wrapped around the buffer. It goes back to
+ * zero when the RX DMA is restarted at the start of the buffer.
  */
 static uint16_t usart_in_head;
 
-/*
- * Maintain head position of out buffer
- * Head always starts from zero and goes up to max bytes.
- * Head is moved by tx interrupt handler to response size sent by host command
- * task. Once all the bytes are sent (head == tail) both should go back to 0.
- */
-static uint16_t usart_out_head;
-
-/*
- * Once the response is ready, get the datalen
- */
-static uint16_t usart_out_datalen;
+/* RX bytes dropped by the USART when the RX DMA was stopped */
+static uint32_t usart_rx_dropped;
 
 /*
  * Enumeration to maintain different states of incoming request from
@@ -130,9 +121,10 @@ static enum uart_host_command_state {
 	/*
 	 * Processing request
 	 * Once the process_request starts processing usart_in_buffer,
-	 * current_state is moved to processing state. Host should not send
-	 * any bytes in this state as it would be considered contiguous
-	 * request.
+	 * current_state is moved to processing state and RX DMA is stopped
+	 * until the response is sent, so usart_in_buffer can't be overwritten.
+	 * Host should not send any bytes in this state: they are dropped and
+	 * reported as contiguous request.
 	 */
 	USART_HOST_CMD_PROCESSING,
 
@@ -248,9 +240,10 @@ static void usart_host_command_process_response(struct host_packet *pkt);
  * A unnamed, valid, empty usart_rx_dma_state structure is required to manage
  * DMA based transmission.
  *
- * USART_DMA_FIFO_SIZE is size of the valid, unnamed  DMA circular buffer.
- * This buffer is large enough to process worst case interrupt latency this
- * layer can encounter.
+ * usart_in_buffer is used as the DMA circular buffer, so a request lands in
+ * place, starting at offset zero as the DMA is restarted after every request.
+ * Bytes received past its end wrap around, but those are only counted to
+ * detect the overrun and are never processed.
  */
 static struct usart_rx_dma const usart_host_command_rx_dma = {
 	.usart_rx = {
@@ -262,18 +255,38 @@ static struct usart_rx_dma const usart_host_command_rx_dma = {
 		.info      = USART_RX_DMA_INFO,
 	},
 	.state       = &((struct usart_rx_dma_state) {}),
-	.fifo_buffer = ((uint8_t[USART_DMA_FIFO_SIZE]) {}),
-	.fifo_size   = USART_DMA_FIFO_SIZE,
+	.fifo_buffer = usart_in_buffer,
+	.fifo_size   = sizeof(usart_in_buffer),
 	.channel     = STM32_DMAS_USART1_RX,
 };
 
+/*
+ * Configure dma instance for tx
+ *
+ * STM32_DMAS_USART1_TX is the DMA channel used to send the response directly
+ * from usart_out_buffer, in a single transfer.
+ */
+static struct usart_tx_dma const usart_host_command_tx_dma = {
+	.usart_tx = {
+		.consumer_ops = {
+				.written = NULL,
+			},
+		.init      = usart_tx_dma_init,
+		.interrupt = usart_host_command_tx_dma_interrupt,
+		.info      = NULL,
+	},
+	.state     = &((struct usart_tx_dma_state) {}),
+	.channel   = STM32_DMAS_USART1_TX,
+	.max_bytes = sizeof(usart_out_buffer),
+};
+
 /*
  * Configure USART structure with hardware, interrupt handlers, baudrate.
  */
 static struct usart_config const tl_usart = {
 	.hw = &CONFIG_UART_HOST_COMMAND_HW,
 	.rx = &usart_host_command_rx_dma.usart_rx,
-	.tx = &usart_host_command_tx_interrupt,
+	.tx = &usart_host_command_tx_dma.usart_tx,
 	.state = &((struct usart_state){}),
 	.baud = CONFIG_UART_HOST_COMMAND_BAUD_RATE,
 	.flags = 0,
@@ -352,8 +365,13 @@ static void usart_host_command_process_request(void)
 		return;
 	}
 
-	/* Move current_state to USART_HOST_CMD_PROCESSING */
+	/*
+	 * Move current_state to USART_HOST_CMD_PROCESSING, and stop RX DMA so
+	 * that the request is not overwritten while it is being processed.
+	 */
 	current_state = USART_HOST_CMD_PROCESSING;
+	usart_rx_dma_stop(&tl_usart);
+	usart_rx_dropped = tl_usart.state->rx_dropped;
 
 	/* Enable interrupts as current_state is safely handled. */
 	interrupt_enable();
@@ -409,13 +427,11 @@ static void usart_host_command_process_response(struct host_packet *pkt)
 	/* Enable interrupts before exiting critical section. */
 	interrupt_enable();
 
-	usart_out_datalen = pkt->response_size;
-	usart_out_head = 0;
-
-	/* Start sending response to host via usart tx by
-	 * triggering tx interrupt.
+	/*
+	 * Start sending response to host straight from usart_out_buffer.
+	 * usart_host_command_tx_complete() is called once it is sent.
 	 */
-	usart_tx_start(&tl_usart);
+	usart_tx_dma_send(&tl_usart, usart_out_buffer, pkt->response_size);
 }
 
 /*
@@ -436,12 +452,21 @@ static void usart_host_command_reset(void)
 	 */
 	interrupt_disable();
 
-	/* Clear in buffer, head and datalen */
-	usart_in_head = 0;
+	/*
+	 * Host should not send data before receiving a response. Since the
+	 * request was already sent to host command task, just notify console
+	 * about the bytes dropped meanwhile.
+	 */
+	if (current_state == USART_HOST_CMD_SENDING &&
+	    tl_usart.state->rx_dropped != usart_rx_dropped)
+		CPRINTS("USART HOST CMD ERROR: Contiguous packets detected.");
 
-	/* Clear out buffer, head and datalen */
-	usart_out_datalen = 0;
-	usart_out_head = 0;
+	/*
+	 * Clear in buffer head and restart RX DMA so the next request lands at
+	 * the start of usart_in_buffer.
+	 */
+	usart_in_head = 0;
+	usart_rx_dma_restart(&tl_usart);
 
 	/* Move to ready state*/
 	current_state = USART_HOST_CMD_READY_TO_RX;
@@ -468,8 +493,6 @@ void usart_host_command_init(void)
 
 	/* Initialize local variables */
 	usart_in_head = 0;
-	usart_out_head = 0;
-	usart_out_datalen = 0;
 
 	/* Move to ready state */
 	current_state = USART_HOST_CMD_READY_TO_RX;
@@ -478,9 +501,10 @@ void usart_host_command_init(void)
 /*
  * Function to handle incoming bytes from DMA interrupt handler
  *
+ * The bytes are already in usart_in_buffer, only count them.
  */
-size_t usart_host_command_rx_append_data(struct usart_config const *config,
-					 const uint8_t *src, size_t count)
+size_t usart_host_command_rx_received(struct usart_config const *config,
+				      size_t count)
 {
 	/* Define ec_host_request pointer to process in bytes later*/
 	struct ec_host_request *ec_request =
@@ -489,22 +513,11 @@ size_t usart_host_command_rx_append_data(struct usart_config const *config,
 	/* Once the header is received, store the datalen */
 	static int usart_in_datalen;
 
-	/*
-	 * Host can send extra bytes than in header data_len
-	 * Only copy valid bytes in buffer
-	 */
-	if (current_state == USART_HOST_CMD_READY_TO_RX ||
-	    current_state == USART_HOST_CMD_RECEIVING ||
-	    (usart_in_head + count) < USART_MAX_REQUEST_SIZE) {
-		/* Copy all the bytes from DMA FIFO */
-		memcpy(usart_in_buffer + usart_in_head, src, count);
-	}
-
 	/*
 	 * Add incoming byte count to usart_in_head.
-	 * Even if overflow bytes are not copied in buffer, maintain
-	 * the overflow count so that packet can be dropped later in this
-	 * function.
+	 * Host can send extra bytes than in header data_len. Even if those
+	 * wrapped around the buffer, maintain the overflow count so that
+	 * packet can be dropped later in this function.
 	 */
 	usart_in_head += count;
 
@@ -550,42 +563,19 @@ size_t usart_host_command_rx_append_data(struct usart_config const *config,
 		}
 	}
 
-	if (current_state == USART_HOST_CMD_PROCESSING)
-		/* Host should not send data before receiving a response.
-		 * Since the request was already sent to host command task,
-		 * just notify console about this. After response is sent
-		 * dma will be cleared to handle next packet
-		 */
-		CPRINTS("USART HOST CMD ERROR: Contiguous packets detected.");
-
 	/* Return count to show all incoming bytes were processed */
 	return count;
 }
 
 /*
- * This function processes the outgoing bytes from tl usart.
+ * This function is called from the TX DMA interrupt handler once the whole
+ * response has been sent.
  */
-size_t usart_host_command_tx_remove_data(struct usart_config const *config,
-					 uint8_t *dest)
+void usart_host_command_tx_complete(struct usart_config const *config)
 {
-	size_t bytes_remaining = 0;
-
-	if (current_state == USART_HOST_CMD_SENDING && usart_out_datalen != 0) {
-		/* Calculate byte_remaining in out_buffer */
-		bytes_remaining = usart_out_datalen - usart_out_head;
-
-		/* Get char on the head */
-		*((uint8_t *)dest) = usart_out_buffer[usart_out_head++];
-
-		/* If no bytes remaining, reset layer to accept next
-		 * request.
-		 */
-		if (bytes_remaining == 0)
-			usart_host_command_reset();
-	}
-
-	/* Return count of bytes remaining in out buffer */
-	return bytes_remaining;
+	/* Reset layer to accept next request. */
+	if (current_state == USART_HOST_CMD_SENDING)
+		usart_host_command_reset();
 }
 
 /*
@@ -14,16 +14,15 @@
 #include <stdarg.h> /* For va_list */
 
 /*
- * Add data to host command layer buffer.
+ * Account count bytes that the RX DMA has written to the request buffer.
  */
-size_t usart_host_command_rx_append_data(struct usart_config const *config,
-					 const uint8_t *src, size_t count);
+size_t usart_host_command_rx_received(struct usart_config const *config,
+				      size_t count);
 
 /*
- * Remove data from the host command layer buffer.
+ * Called once the TX DMA has finished sending the response.
  */
-size_t usart_host_command_tx_remove_data(struct usart_config const *config,
-					 uint8_t *dest);
+void usart_host_command_tx_complete(struct usart_config const *config);
 
 /*
  * Get USART protocol information. This function is called in runtime if
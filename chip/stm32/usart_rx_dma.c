@@ -15,7 +15,10 @@
 typedef size_t (*add_data_t)(struct usart_config const *config,
 			     const uint8_t *src, size_t count);
 
-void usart_rx_dma_init(struct usart_config const *config)
+/*
+ * (Re)start the circular RX DMA transfer at the start of the FIFO.
+ */
+static void usart_rx_dma_start(struct usart_config const *config)
 {
 	struct usart_rx_dma const *dma_config =
 		DOWNCAST(config->rx, struct usart_rx_dma const, usart_rx);
@@ -30,16 +33,51 @@ void usart_rx_dma_init(struct usart_config const *config)
 	};
 
 	if (IS_ENABLED(CHIP_FAMILY_STM32F4))
-		options.flags |= STM32_DMA_CCR_CHANNEL(STM32_REQ_USART1_RX);
+		options.flags |=
+			STM32_DMA_CCR_CHANNEL(config->hw->rx_dma_request);
+
+	dma_config->state->index = 0;
+
+	dma_start_rx(&options, dma_config->fifo_size, dma_config->fifo_buffer);
+}
+
+void usart_rx_dma_init(struct usart_config const *config)
+{
+	struct usart_rx_dma const *dma_config =
+		DOWNCAST(config->rx, struct usart_rx_dma const, usart_rx);
+
+	intptr_t base = config->hw->base;
 
 	STM32_USART_CR1(base) |= STM32_USART_CR1_RXNEIE;
 	STM32_USART_CR1(base) |= STM32_USART_CR1_RE;
 	STM32_USART_CR3(base) |= STM32_USART_CR3_DMAR;
 
-	dma_config->state->index = 0;
 	dma_config->state->max_bytes = 0;
 
-	dma_start_rx(&options, dma_config->fifo_size, dma_config->fifo_buffer);
+	usart_rx_dma_start(config);
+}
+
+void usart_rx_dma_stop(struct usart_config const *config)
+{
+	struct usart_rx_dma const *dma_config =
+		DOWNCAST(config->rx, struct usart_rx_dma const, usart_rx);
+
+	STM32_USART_CR3(config->hw->base) &= ~STM32_USART_CR3_DMAR;
+	dma_disable(dma_config->channel);
+}
+
+void usart_rx_dma_restart(struct usart_config const *config)
+{
+	intptr_t base = config->hw->base;
+
+	usart_rx_dma_stop(config);
+
+	/* Drop a byte left in the data register while reception was stopped */
+	if (STM32_USART_SR(base) & STM32_USART_SR_RXNE)
+		(void)STM32_USART_RDR(base);
+
+	usart_rx_dma_start(config);
+	STM32_USART_CR3(base) |= STM32_USART_CR3_DMAR;
 }
 
 static void usart_rx_dma_interrupt_common(struct usart_config const *config,
@@ -96,8 +134,50 @@ void usart_rx_dma_interrupt(struct usart_config const *config)
 #if defined(CONFIG_USART_HOST_COMMAND)
 void usart_host_command_rx_dma_interrupt(struct usart_config const *config)
 {
-	usart_rx_dma_interrupt_common(config,
-				      &usart_host_command_rx_append_data);
+	struct usart_rx_dma const *dma_config =
+		DOWNCAST(config->rx, struct usart_rx_dma const, usart_rx);
+
+	intptr_t base = config->hw->base;
+	dma_chan_t *channel;
+	size_t new_index;
+	size_t old_index = dma_config->state->index;
+	size_t new_bytes;
+
+	/*
+	 * While reception is stopped, the bytes are left in the data register
+	 * and raise RXNE: drop them so they don't overwrite the request being
+	 * processed.
+	 */
+	if (!(STM32_USART_CR3(base) & STM32_USART_CR3_DMAR)) {
+		if (STM32_USART_SR(base) & STM32_USART_SR_RXNE) {
+			(void)STM32_USART_RDR(base);
+			atomic_add((atomic_t *)&(config->state->rx_dropped), 1);
+		}
+		return;
+	}
+
+	channel = dma_get_channel(dma_config->channel);
+	new_index = dma_bytes_done(channel, dma_config->fifo_size);
+
+	if (new_index == old_index)
+		return;
+
+	/*
+	 * The DMA FIFO is the host command request buffer itself, so there
+	 * is nothing to copy out: only report how many bytes the DMA has
+	 * written since the last interrupt.
+	 */
+	if (new_index > old_index)
+		new_bytes = new_index - old_index;
+	else
+		new_bytes = dma_config->fifo_size - (old_index - new_index);
+
+	usart_host_command_rx_received(config, new_bytes);
+
+	if (dma_config->state->max_bytes < new_bytes)
+		dma_config->state->max_bytes = new_bytes;
+
+	dma_config->state->index = new_index;
 }
 #endif /* CONFIG_USART_HOST_COMMAND */
 
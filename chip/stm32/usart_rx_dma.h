@@ -101,9 +101,24 @@ struct usart_rx_dma {
 void usart_rx_dma_init(struct usart_config const *config);
 void usart_rx_dma_interrupt(struct usart_config const *config);
 
+/*
+ * Stop reception: the DMA no longer writes to the FIFO, and the bytes
+ * received until the next usart_rx_dma_restart() are dropped by
+ * usart_host_command_rx_dma_interrupt().
+ */
+void usart_rx_dma_stop(struct usart_config const *config);
+
+/*
+ * Restart reception at the start of the DMA FIFO, discarding any bytes that
+ * have not been consumed yet.
+ */
+void usart_rx_dma_restart(struct usart_config const *config);
+
 /*
  * Function pointers needed to initialize host command rx dma interrupt.
- * This should be only called from usart host command layer.
+ * This should be only called from usart host command layer, whose request
+ * buffer must be used as the DMA FIFO: received bytes are left in place and
+ * only their count is passed to usart_host_command_rx_received().
  */
 void usart_host_command_rx_dma_interrupt(struct usart_config const *config);
 
@@ -7,6 +7,7 @@
 #include "system.h"
 #include "task.h"
 #include "usart.h"
+#include "usart_host_command.h"
 #include "usart_tx_dma.h"
 #include "util.h"
 
@@ -44,6 +45,10 @@ static void usart_tx_dma_start(struct usart_config const *config,
 			(STM32_DMA_CCR_MSIZE_8_BIT | STM32_DMA_CCR_PSIZE_8_BIT),
 	};
 
+#ifdef CHIP_FAMILY_STM32F4
+	options.flags |= STM32_DMA_CCR_CHANNEL(config->hw->tx_dma_request);
+#endif
+
 	/*
 	 * Limit our DMA transfer.  If we didn't do this then it would be
 	 * possible to start a large DMA transfer of an entirely full buffer
@@ -99,3 +104,36 @@ void usart_tx_dma_interrupt(struct usart_config const *config)
 			usart_tx_dma_stop(config, dma_config);
 	}
 }
+
+#if defined(CONFIG_USART_HOST_COMMAND)
+void usart_tx_dma_send(struct usart_config const *config, const void *buffer,
+		       size_t count)
+{
+	struct usart_tx_dma const *dma_config =
+		DOWNCAST(config->tx, struct usart_tx_dma const, usart_tx);
+
+	dma_config->state->chunk.buffer = (void *)buffer;
+	dma_config->state->chunk.count = count;
+
+	/* Keep the USART clocked until the last byte has been shifted out */
+	disable_sleep(SLEEP_MASK_UART);
+
+	usart_tx_dma_start(config, dma_config);
+}
+
+void usart_host_command_tx_dma_interrupt(struct usart_config const *config)
+{
+	struct usart_tx_dma const *dma_config =
+		DOWNCAST(config->tx, struct usart_tx_dma const, usart_tx);
+
+	if (!dma_config->state->dma_active ||
+	    !(STM32_USART_SR(config->hw->base) & STM32_USART_SR_TC))
+		return;
+
+	usart_tx_dma_stop(config, dma_config);
+
+	enable_sleep(SLEEP_MASK_UART);
+
+	usart_host_command_tx_complete(config);
+}
+#endif /* CONFIG_USART_HOST_COMMAND */
@@ -87,4 +87,14 @@ void usart_tx_dma_flush(struct consumer const *consumer);
 void usart_tx_dma_init(struct usart_config const *config);
 void usart_tx_dma_interrupt(struct usart_config const *config);
 
+/*
+ * Send a single buffer owned by the caller, bypassing the TX queue.  The
+ * buffer must stay untouched until the transfer completes.  Only used by the
+ * usart host command layer, together with the interrupt handler below which
+ * calls usart_host_command_tx_complete() once the last byte has been sent.
+ */
+void usart_tx_dma_send(struct usart_config const *config, const void *buffer,
+		       size_t count);
+void usart_host_command_tx_dma_interrupt(struct usart_config const *config);
+
 #endif /* __CROS_EC_USART_TX_DMA_H */
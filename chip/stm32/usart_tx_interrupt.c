@@ -10,7 +10,6 @@
 #include "system.h"
 #include "task.h"
 #include "usart.h"
-#include "usart_host_command.h"
 #include "util.h"
 
 typedef size_t (*remove_data_t)(struct usart_config const *config,
@@ -102,23 +101,3 @@ struct usart_tx const usart_tx_interrupt = {
 	.interrupt = usart_tx_interrupt_handler,
 	.info      = NULL,
 };
-
-#if defined(CONFIG_USART_HOST_COMMAND)
-
-static void
-usart_host_command_tx_interrupt_handler(struct usart_config const *config)
-{
-	usart_tx_interrupt_handler_common(config,
-					  &usart_host_command_tx_remove_data);
-}
-
-struct usart_tx const usart_host_command_tx_interrupt = {
-	.consumer_ops = {
-		.written = usart_written,
-	},
-
-	.init      = usart_tx_init,
-	.interrupt = usart_host_command_tx_interrupt_handler,
-	.info      = NULL,
-};
-#endif /* CONFIG_USART_HOST_COMMAND */
@@ -29,6 +29,13 @@
 #define CPRINTS(format, args...)
 #endif
 
+/*
+ * The transmit path waits for TASK_EVENT_DMA_TC in the PD task, which the
+ * shared PD task can't attribute to a port.
+ */
+BUILD_ASSERT(!IS_ENABLED(CONFIG_USB_PD_TASK_SHARED),
+	     "STM32 PD PHY doesn't support CONFIG_USB_PD_TASK_SHARED");
+
 #define PD_DATARATE 300000 /* Hz */
 
 /*
@@ -458,7 +465,7 @@ void pd_rx_handler(void)
 #ifdef CONFIG_USB_CTVPD
 	/* Charge-Through Side detach event */
 	if (pending & EXTI_COMP2_MASK) {
-		task_wake(PD_PORT_TO_TASK_ID(0));
+		pd_task_wake(0);
 		/* Clear interrupt */
 		STM32_EXTI_PR = EXTI_COMP2_MASK;
 		pending &= ~EXTI_COMP2_MASK;
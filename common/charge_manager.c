@@ -18,6 +18,7 @@
 #include "hooks.h"
 #include "host_command.h"
 #include "system.h"
+#include "task.h"
 #include "tcpm/tcpm.h"
 #include "timer.h"
 #include "typec_control.h"
@@ -82,6 +83,20 @@ BUILD_ASSERT(ARRAY_SIZE(charge_supplier_name) == CHARGE_SUPPLIER_COUNT);
 static struct charge_port_info available_charge[CHARGE_SUPPLIER_COUNT]
 					       [CHARGE_PORT_COUNT];
 
+/*
+ * Charge ports ranked by their best supplier: higher supplier priority first,
+ * then higher power. Only the ports flagged in rank_dirty are re-ranked when
+ * a charge port is selected, so a charge update costs a rescan of its own
+ * port's suppliers and a binary search in the ranking, instead of a rescan
+ * of the whole available_charge table.
+ */
+static int port_best_supplier[CHARGE_PORT_COUNT];
+static int port_best_power[CHARGE_PORT_COUNT];
+static uint8_t port_rank[CHARGE_PORT_COUNT];
+static atomic_t rank_dirty;
+K_MUTEX_DEFINE(rank_lock);
+BUILD_ASSERT(CHARGE_PORT_COUNT <= 32);
+
 /* Keep track of when the supplier on each port is registered. */
 static timestamp_t registration_time[CHARGE_PORT_COUNT];
 
@@ -237,6 +252,13 @@ static void charge_manager_init(void)
 		if (is_pd_port(i) && !IS_ENABLED(CONFIG_USB_PD_TCPMV2))
 			source_port_rp[i] = CONFIG_USB_PD_PULLUP;
 	}
+
+	for (i = 0; i < CHARGE_PORT_COUNT; ++i) {
+		port_best_supplier[i] = CHARGE_SUPPLIER_NONE;
+		port_rank[i] = i;
+		if (is_valid_port(i))
+			atomic_or(&rank_dirty, BIT(i));
+	}
 }
 DECLARE_HOOK(HOOK_INIT, charge_manager_init, HOOK_PRIO_INIT_CHARGE_MANAGER);
 
@@ -642,6 +664,114 @@ static int charge_manager_get_ceil(int port)
 	return ceil;
 }
 
+/**
+ * Check whether the charge manager is allowed to charge from a port.
+ *
+ * @param port	Charge port.
+ * @return	true if the port may be selected as the charge port.
+ */
+static bool is_charge_candidate(int port)
+{
+	if (!is_valid_port(port))
+		return false;
+
+#ifndef CONFIG_CHARGE_MANAGER_DRP_CHARGING
+	/* Don't charge from a dual-role port unless it is our override port. */
+	if (dualrole_capability[port] != CAP_DEDICATED &&
+	    override_port != port &&
+	    !charge_manager_spoof_dualrole_capability())
+		return false;
+#endif
+
+	return true;
+}
+
+/**
+ * Compare the rank of two charge ports.
+ *
+ * Ties between suppliers of equal priority and power are broken by supplier
+ * then by port number, so the first supplier to be listed wins.
+ *
+ * @return	true if port a ranks strictly before port b.
+ */
+static bool port_ranks_before(int a, int b)
+{
+	int sa = port_best_supplier[a];
+	int sb = port_best_supplier[b];
+
+	if (sa == CHARGE_SUPPLIER_NONE || sb == CHARGE_SUPPLIER_NONE)
+		return sb == CHARGE_SUPPLIER_NONE &&
+		       (sa != CHARGE_SUPPLIER_NONE || a < b);
+	if (supplier_priority[sa] != supplier_priority[sb])
+		return supplier_priority[sa] < supplier_priority[sb];
+	if (port_best_power[a] != port_best_power[b])
+		return port_best_power[a] > port_best_power[b];
+	if (sa != sb)
+		return sa < sb;
+	return a < b;
+}
+
+/**
+ * Check whether two charge ports offer equal priority and power.
+ */
+static bool port_ranks_tied(int a, int b)
+{
+	return supplier_priority[port_best_supplier[a]] ==
+		       supplier_priority[port_best_supplier[b]] &&
+	       port_best_power[a] == port_best_power[b];
+}
+
+/**
+ * Pick the best supplier of a port and move the port to its place in the
+ * ranking. Must be called with rank_lock held.
+ *
+ * @param port	Charge port.
+ */
+static void charge_manager_rank_port(int port)
+{
+	struct charge_port_info charge;
+	int best = CHARGE_SUPPLIER_NONE, best_power = 0;
+	int i, lo, hi, mid;
+
+	/*
+	 * available_charge can be changed at any time by other tasks, so
+	 * read each entry once. The port is flagged again if it changes.
+	 */
+	for (i = 0; i < CHARGE_SUPPLIER_COUNT; ++i) {
+		charge = available_charge[i][port];
+		if (charge.current == 0 || charge.voltage == 0)
+			continue;
+		if (best == CHARGE_SUPPLIER_NONE ||
+		    supplier_priority[i] < supplier_priority[best] ||
+		    (supplier_priority[i] == supplier_priority[best] &&
+		     POWER(charge) > best_power)) {
+			best = i;
+			best_power = POWER(charge);
+		}
+	}
+
+	/* Take the port out of the ranking... */
+	for (i = 0; port_rank[i] != port; ++i)
+		;
+	memmove(&port_rank[i], &port_rank[i + 1], CHARGE_PORT_COUNT - 1 - i);
+
+	port_best_supplier[port] = best;
+	port_best_power[port] = best_power;
+
+	/* ...and put it back in its place. */
+	lo = 0;
+	hi = CHARGE_PORT_COUNT - 1;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (port_ranks_before(port_rank[mid], port))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	memmove(&port_rank[lo + 1], &port_rank[lo], CHARGE_PORT_COUNT - 1 - lo);
+	port_rank[lo] = port;
+}
+
 /**
  * Select the best charge port or the override port, as defined by the supplier
  * hierarchy and the available power.
@@ -653,7 +783,8 @@ static void charge_manager_get_best_port(int *new_port, int *new_supplier)
 {
 	int supplier = CHARGE_SUPPLIER_NONE;
 	int port = CHARGE_PORT_NONE;
-	int best_port_power = -1, candidate_port_power;
+	int best = CHARGE_PORT_NONE;
+	uint32_t dirty;
 	int i, j;
 
 	if (override_port == OVERRIDE_DONT_CHARGE) {
@@ -662,89 +793,71 @@ static void charge_manager_get_best_port(int *new_port, int *new_supplier)
 		return;
 	}
 
+	mutex_lock(&rank_lock);
+
+	/* Re-rank the ports whose available charge changed. */
+	dirty = atomic_clear(&rank_dirty);
+	while (dirty)
+		charge_manager_rank_port(get_next_bit(&dirty));
+
 	/*
 	 * Charge supplier selection logic:
-	 * 1. Prefer DPS charge port.
-	 * 2. Prefer higher priority supply.
-	 * 3. Prefer higher power over lower in case priority is tied.
-	 * 4. Prefer current charge port over new port in case (1)
-	 *    and (2) are tied.
-	 * available_charge can be changed at any time by other tasks,
-	 * so make no assumptions about its consistency.
+	 * 1. Prefer override port.
+	 * 2. Prefer DPS charge port.
+	 * 3. Prefer higher priority supply.
+	 * 4. Prefer higher power over lower in case priority is tied.
+	 * 5. Prefer current charge port and supplier over new ones in case
+	 *    (3) and (4) are tied.
 	 */
-	for (i = 0; i < CHARGE_SUPPLIER_COUNT; ++i) {
-		for (j = 0; j < CHARGE_PORT_COUNT; ++j) {
-			/* Skip this port if it is not valid. */
-			if (!is_valid_port(j))
-				continue;
-
-			/*
-			 * Skip this supplier if there is no
-			 * available charge.
-			 */
-			if (available_charge[i][j].current == 0 ||
-			    available_charge[i][j].voltage == 0)
-				continue;
-
-			/*
-			 * Don't select this port if we have a
-			 * charge on another override port.
-			 */
-			if (override_port != OVERRIDE_OFF &&
-			    override_port == port && override_port != j)
-				continue;
-
-#ifndef CONFIG_CHARGE_MANAGER_DRP_CHARGING
-			/*
-			 * Don't charge from a dual-role port unless
-			 * it is our override port.
-			 */
-			if (dualrole_capability[j] != CAP_DEDICATED &&
-			    override_port != j &&
-			    !charge_manager_spoof_dualrole_capability())
-				continue;
-#endif
+	if (override_port != OVERRIDE_OFF && is_valid_port(override_port) &&
+	    port_best_supplier[override_port] != CHARGE_SUPPLIER_NONE) {
+		port = override_port;
+		supplier = port_best_supplier[port];
+	}
 
-			candidate_port_power = POWER(available_charge[i][j]);
+	/*
+	 * The ranking is ordered, so stop at the first port which ranks lower
+	 * than the best candidate.
+	 */
+	for (i = 0; port == CHARGE_PORT_NONE && i < CHARGE_PORT_COUNT; ++i) {
+		j = port_rank[i];
+		if (port_best_supplier[j] == CHARGE_SUPPLIER_NONE)
+			break;
+		if (!is_charge_candidate(j))
+			continue;
+		if (best == CHARGE_PORT_NONE)
+			best = j;
+		else if (!port_ranks_tied(best, j))
+			break;
+		if (j == charge_port)
+			port = j;
+	}
+	if (port == CHARGE_PORT_NONE)
+		port = best;
+	if (port != CHARGE_PORT_NONE)
+		supplier = port_best_supplier[port];
+
+	/* Don't switch between suppliers of equal rank on the active port. */
+	if (port != CHARGE_PORT_NONE && port == charge_port &&
+	    charge_supplier != CHARGE_SUPPLIER_NONE &&
+	    charge_supplier != supplier &&
+	    supplier_priority[charge_supplier] == supplier_priority[supplier] &&
+	    available_charge[charge_supplier][port].voltage != 0 &&
+	    POWER(available_charge[charge_supplier][port]) ==
+		    port_best_power[port])
+		supplier = charge_supplier;
 
-			/* Select DPS port if provided. */
-			if (IS_ENABLED(CONFIG_USB_PD_DPS) &&
-			    override_port == OVERRIDE_OFF &&
-			    i == CHARGE_SUPPLIER_PD &&
-			    j == dps_get_charge_port()) {
-				supplier = i;
-				port = j;
-				break;
-				/* Select if no supplier chosen yet. */
-			} else if (supplier == CHARGE_SUPPLIER_NONE ||
-				   /* ..or if supplier priority is higher. */
-				   supplier_priority[i] <
-					   supplier_priority[supplier] ||
-				   /* ..or if this is our override port. */
-				   (j == override_port &&
-				    port != override_port) ||
-				   /* ..or if priority is tied and.. */
-				   (supplier_priority[i] ==
-					    supplier_priority[supplier] &&
-				    /*
-				     * candidate port can supply more power or
-				     * ..
-				     */
-				    (candidate_port_power > best_port_power ||
-				     /*
-				      * candidate port is the active
-				      * port and can supply the same
-				      * amount of power.
-				      */
-				     (candidate_port_power == best_port_power &&
-				      charge_port == j)))) {
-				supplier = i;
-				port = j;
-				best_port_power = candidate_port_power;
-			}
+	/* Select DPS port if provided, whatever the ranking. */
+	if (IS_ENABLED(CONFIG_USB_PD_DPS) && override_port == OVERRIDE_OFF) {
+		j = dps_get_charge_port();
+		if (is_charge_candidate(j) &&
+		    available_charge[CHARGE_SUPPLIER_PD][j].current != 0 &&
+		    available_charge[CHARGE_SUPPLIER_PD][j].voltage != 0) {
+			port = j;
+			supplier = CHARGE_SUPPLIER_PD;
 		}
 	}
-
+	mutex_unlock(&rank_lock);
 #ifdef CONFIG_BATTERY
 	/*
 	 * if no battery present then retain same charge port
@@ -825,6 +938,7 @@ static void charge_manager_refresh(void)
 			available_charge[i][new_port].current = 0;
 			available_charge[i][new_port].voltage = 0;
 		}
+		atomic_or(&rank_dirty, BIT(new_port));
 	}
 
 	active_charge_port_initialized = 1;
@@ -1118,6 +1232,7 @@ static void charge_manager_make_change(enum charge_manager_change_type change,
 	if (change == CHANGE_CHARGE) {
 		available_charge[supplier][port].current = charge->current;
 		available_charge[supplier][port].voltage = charge->voltage;
+		atomic_or(&rank_dirty, BIT(port));
 		registration_time[port] = get_time();
 
 		/*
@@ -161,6 +161,34 @@ static int battery_was_removed;
 
 static int problems_exist;
 
+/*
+ * With CONFIG_CHARGE_STATE_EVENT_DRIVEN, the default poll period is stretched
+ * by 2^poll_shift while nothing the charge loop acts on changes. The readings
+ * the loop last acted on are kept in poll_ref; the analog ones may drift by
+ * the deadbands below before they count as a change.
+ */
+#define POLL_DEADBAND_MV 20
+#define POLL_DEADBAND_MA 100
+#define POLL_DEADBAND_DK 5 /* 0.1 K */
+
+static int poll_shift;
+#ifdef CONFIG_CHARGE_STATE_EVENT_DRIVEN
+static struct {
+	enum charge_state state;
+	int ac;
+	int requested_voltage;
+	int requested_current;
+	int chg_status;
+	enum battery_present is_present;
+	int batt_flags;
+	int batt_status;
+	int state_of_charge;
+	int voltage;
+	int current;
+	int temperature;
+} poll_ref;
+#endif
+
 static const char *const prob_text[] = {
 	"static update",     "set voltage",	 "set current", "set mode",
 	"set input current", "post init",	 "chg params",	"batt params",
@@ -350,6 +378,8 @@ static void dump_charge_state(void)
 	ccprintf("Battery sustainer = %s (%d%% ~ %d%%)\n",
 		 battery_sustainer_enabled() ? "on" : "off", sustain_soc.lower,
 		 sustain_soc.upper);
+	if (IS_ENABLED(CONFIG_CHARGE_STATE_EVENT_DRIVEN))
+		ccprintf("poll_shift = %d\n", poll_shift);
 #undef DUMP
 }
 
@@ -1052,6 +1082,8 @@ DECLARE_HOOK(HOOK_INIT, charger_init, HOOK_PRIO_DEFAULT);
 
 void charge_wakeup(void)
 {
+	/* Something happened, go back to the default poll period. */
+	poll_shift = 0;
 	task_wake(TASK_ID_CHARGER);
 }
 DECLARE_HOOK(HOOK_CHIPSET_RESUME, charge_wakeup, HOOK_PRIO_DEFAULT);
@@ -1527,6 +1559,57 @@ static void process_preferred_voltage(void)
 		pd_set_new_power_request(port);
 }
 
+#ifdef CONFIG_CHARGE_STATE_EVENT_DRIVEN
+/*
+ * Check whether anything the charge loop acts on changed since the poll
+ * period was last reset, and stretch or reset the poll period accordingly.
+ */
+static void update_poll_shift(int battery_critical)
+{
+	/* Only the flags describing the battery state, not the volatile ones */
+	const int flags_mask = BATT_FLAG_RESPONSIVE | BATT_FLAG_WANT_CHARGE |
+			       BATT_FLAG_BAD_ANY;
+	bool changed =
+		curr.state != poll_ref.state || curr.ac != poll_ref.ac ||
+		curr.requested_voltage != poll_ref.requested_voltage ||
+		curr.requested_current != poll_ref.requested_current ||
+		curr.chg.status != poll_ref.chg_status ||
+		curr.batt.is_present != poll_ref.is_present ||
+		(curr.batt.flags & flags_mask) != poll_ref.batt_flags ||
+		curr.batt.status != poll_ref.batt_status ||
+		curr.batt.state_of_charge != poll_ref.state_of_charge ||
+		ABS(curr.batt.voltage - poll_ref.voltage) > POLL_DEADBAND_MV ||
+		ABS(curr.batt.current - poll_ref.current) > POLL_DEADBAND_MA ||
+		ABS(curr.batt.temperature - poll_ref.temperature) >
+			POLL_DEADBAND_DK;
+
+	/*
+	 * Keep the default period while something is wrong, and close to the
+	 * low battery thresholds, which must be reported in time.
+	 */
+	if (!changed && !problems_exist && !battery_critical &&
+	    curr.batt.state_of_charge > BATTERY_LEVEL_LOW) {
+		if (poll_shift < CONFIG_CHARGE_STATE_MAX_POLL_SHIFT)
+			poll_shift++;
+		return;
+	}
+
+	poll_shift = 0;
+	poll_ref.state = curr.state;
+	poll_ref.ac = curr.ac;
+	poll_ref.requested_voltage = curr.requested_voltage;
+	poll_ref.requested_current = curr.requested_current;
+	poll_ref.chg_status = curr.chg.status;
+	poll_ref.is_present = curr.batt.is_present;
+	poll_ref.batt_flags = curr.batt.flags & flags_mask;
+	poll_ref.batt_status = curr.batt.status;
+	poll_ref.state_of_charge = curr.batt.state_of_charge;
+	poll_ref.voltage = curr.batt.voltage;
+	poll_ref.current = curr.batt.current;
+	poll_ref.temperature = curr.batt.temperature;
+}
+#endif /* CONFIG_CHARGE_STATE_EVENT_DRIVEN */
+
 /* Calculate the sleep duration, before we run around the task loop again */
 int calculate_sleep_dur(int battery_critical, int sleep_usec)
 {
@@ -1558,6 +1641,14 @@ int calculate_sleep_dur(int battery_critical, int sleep_usec)
 			/* AC present, so pay closer attention */
 			sleep_usec = CHARGE_POLL_PERIOD_CHARGE;
 		}
+
+		/*
+		 * Nothing changed lately, only check for drift. Shift in 64
+		 * bits, the long periods overflow an int when stretched.
+		 */
+		if (IS_ENABLED(CONFIG_CHARGE_STATE_EVENT_DRIVEN))
+			sleep_usec = MIN((uint64_t)sleep_usec << poll_shift,
+					 (uint64_t)CHARGE_MAX_SLEEP_USEC);
 	}
 
 	/* Adjust for time spent in the charge loop */
@@ -1693,6 +1784,10 @@ void charger_task(void *u)
 		/* Report our state */
 		local_state.is_full = is_full;
 
+#ifdef CONFIG_CHARGE_STATE_EVENT_DRIVEN
+		update_poll_shift(battery_critical);
+#endif
+
 		sleep_usec = calculate_sleep_dur(battery_critical, sleep_usec);
 		task_wait_event(sleep_usec);
 	}
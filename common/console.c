@@ -134,6 +134,39 @@ static const struct console_command *find_command(const char *name)
 	const struct console_command *cmd, *match = NULL;
 	int match_length = strlen(name);
 
+	if (IS_ENABLED(CONFIG_CONSOLE_CMD_SECTION_SORTED)) {
+		const struct console_command *l = __cmds, *r = __cmds_end;
+
+		/*
+		 * Use binary search to locate the first command which is not
+		 * less than name. Since a prefix sorts before any longer
+		 * string it starts, that is the only candidate for an exact
+		 * match, and the command after it decides whether a partial
+		 * match is ambiguous.
+		 */
+		while (l < r) {
+			cmd = l + (r - l) / 2;
+
+			if (strcasecmp(cmd->name, name) < 0)
+				l = cmd + 1;
+			else
+				r = cmd;
+		}
+
+		if (l == __cmds_end ||
+		    strncasecmp(name, l->name, match_length))
+			return NULL;
+
+		if (l->name[match_length] == '\0')
+			return l;
+
+		if (l + 1 < __cmds_end &&
+		    !strncasecmp(name, l[1].name, match_length))
+			return NULL;
+
+		return l;
+	}
+
 	for (cmd = __cmds; cmd < __cmds_end; cmd++) {
 		if (!strncasecmp(name, cmd->name, match_length)) {
 			if (match)
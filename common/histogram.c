@@ -0,0 +1,33 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Power-of-two microsecond histograms, shared with ectool */
+
+#include "histogram.h"
+
+uint32_t histogram_percentile(const uint16_t *histogram, int buckets,
+			      uint32_t max_us, int percent)
+{
+	uint64_t total = 0;
+	uint64_t sum = 0;
+	uint32_t bound;
+	int i;
+
+	for (i = 0; i < buckets; i++)
+		total += histogram[i];
+
+	for (i = 0; i < buckets - 1; i++) {
+		sum += histogram[i];
+		if (sum * 100 >= total * percent)
+			break;
+	}
+
+	/* The last bucket is open ended */
+	if (i == buckets - 1)
+		return max_us;
+
+	bound = (2U << i) - 1;
+	return bound < max_us ? bound : max_us;
+}
@@ -0,0 +1 @@
+histogram.c
\ No newline at end of file
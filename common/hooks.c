@@ -9,6 +9,7 @@
 #include "console.h"
 #include "hooks.h"
 #include "link_defs.h"
+#include "task.h"
 #include "timer.h"
 #include "util.h"
 
@@ -72,6 +73,22 @@ static const struct hook_ptrs hook_list[] = {
 /* Times for deferrable functions */
 static int hook_task_started;
 
+/*
+ * Pending deferred routines are kept in a binary min-heap ordered by firing
+ * time, so arming, cancelling and dispatching a routine is O(log n) and the
+ * next wake time is always at the root.
+ *
+ * The linker reserves __deferred_heap with room for two uint16_t per deferred
+ * routine: the first DEFERRED_FUNCS_COUNT entries hold routine indices in heap
+ * order, and the next DEFERRED_FUNCS_COUNT entries map a routine index to its
+ * heap position plus one (zero means the routine is not pending).
+ *
+ * All heap accesses must be done with interrupts disabled.
+ */
+#define deferred_heap (__deferred_heap)
+#define deferred_heap_pos (__deferred_heap + DEFERRED_FUNCS_COUNT)
+static int deferred_heap_size;
+
 #ifdef CONFIG_HOOK_DEBUG
 /* Stats for hooks */
 static uint64_t max_hook_tick_delay;
@@ -82,6 +99,11 @@ static uint64_t avg_hook_tick_delay;
 static uint64_t avg_hook_second_delay;
 static uint64_t avg_hook_run_time[ARRAY_SIZE(hook_list)];
 
+/* Interrupt-off time spent by hook_task() managing deferred routines */
+static uint64_t max_deferred_irq_off_time;
+static uint64_t avg_deferred_irq_off_time;
+static int max_deferred_pending;
+
 static inline void update_hook_average(uint64_t *avg, uint64_t time)
 {
 	*avg = (*avg * 7 + time) >> 3;
@@ -104,6 +126,13 @@ static void record_hook_delay(uint64_t now, uint64_t last, uint64_t interval,
 		CPRINTS("Hook at interval %d us delayed by %d us",
 			(uint32_t)interval, (uint32_t)delayed);
 }
+
+static void record_deferred_irq_off(uint64_t irq_off_time)
+{
+	if (irq_off_time > max_deferred_irq_off_time)
+		max_deferred_irq_off_time = irq_off_time;
+	update_hook_average(&avg_deferred_irq_off_time, irq_off_time);
+}
 #endif
 
 void hook_notify(enum hook_type type)
@@ -148,19 +177,115 @@ void hook_notify(enum hook_type type)
 #endif
 }
 
+static inline void deferred_heap_set(int pos, int i)
+{
+	deferred_heap[pos] = i;
+	deferred_heap_pos[i] = pos + 1;
+}
+
+/* Move the routine at heap position pos towards the root. */
+static void deferred_heap_sift_up(int pos)
+{
+	int i = deferred_heap[pos];
+
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+
+		if (__deferred_until[deferred_heap[parent]] <=
+		    __deferred_until[i])
+			break;
+
+		deferred_heap_set(pos, deferred_heap[parent]);
+		pos = parent;
+	}
+	deferred_heap_set(pos, i);
+}
+
+/* Move the routine at heap position pos towards the leaves. */
+static void deferred_heap_sift_down(int pos)
+{
+	int i = deferred_heap[pos];
+
+	while (1) {
+		int child = 2 * pos + 1;
+
+		if (child >= deferred_heap_size)
+			break;
+
+		if (child + 1 < deferred_heap_size &&
+		    __deferred_until[deferred_heap[child + 1]] <
+			    __deferred_until[deferred_heap[child]])
+			child++;
+
+		if (__deferred_until[i] <=
+		    __deferred_until[deferred_heap[child]])
+			break;
+
+		deferred_heap_set(pos, deferred_heap[child]);
+		pos = child;
+	}
+	deferred_heap_set(pos, i);
+}
+
+/* Arm (or re-arm) deferred routine i to fire at the given time. */
+static void deferred_heap_schedule(int i, uint64_t until)
+{
+	int pos = deferred_heap_pos[i] - 1;
+
+	__deferred_until[i] = until;
+
+	if (pos < 0) {
+		pos = deferred_heap_size++;
+		deferred_heap_set(pos, i);
+#ifdef CONFIG_HOOK_DEBUG
+		if (deferred_heap_size > max_deferred_pending)
+			max_deferred_pending = deferred_heap_size;
+#endif
+	}
+
+	deferred_heap_sift_up(pos);
+	deferred_heap_sift_down(deferred_heap_pos[i] - 1);
+}
+
+/* Disarm deferred routine i, if pending. */
+static void deferred_heap_cancel(int i)
+{
+	int pos = deferred_heap_pos[i] - 1;
+	int last;
+
+	__deferred_until[i] = 0;
+
+	if (pos < 0)
+		return;
+
+	deferred_heap_pos[i] = 0;
+	last = deferred_heap[--deferred_heap_size];
+	if (pos == deferred_heap_size)
+		return;
+
+	deferred_heap_set(pos, last);
+	deferred_heap_sift_up(pos);
+	deferred_heap_sift_down(deferred_heap_pos[last] - 1);
+}
+
 int hook_call_deferred(const struct deferred_data *data, int us)
 {
 	int i = data - __deferred_funcs;
+	uint32_t key;
 
 	if (data < __deferred_funcs || data >= __deferred_funcs_end)
 		return EC_ERROR_INVAL; /* Routine not registered */
 
 	if (us == -1) {
 		/* Cancel */
-		__deferred_until[i] = 0;
+		key = irq_lock();
+		deferred_heap_cancel(i);
+		irq_unlock(key);
 	} else {
 		/* Set alarm */
-		__deferred_until[i] = get_time().val + us;
+		key = irq_lock();
+		deferred_heap_schedule(i, get_time().val + us);
+		irq_unlock(key);
 
 		/* Wake task so it can re-sleep for the proper time */
 		if (hook_task_started)
@@ -187,25 +312,41 @@ void hook_task(void *u)
 	while (1) {
 		uint64_t t = get_time().val;
 		int next = 0;
-		int i;
+#ifdef CONFIG_HOOK_DEBUG
+		uint64_t irq_off_start;
+		uint64_t irq_off_time = 0;
+#endif
 
 		interrupt_disable();
-		/* Handle deferred routines */
-		for (i = 0; i < DEFERRED_FUNCS_COUNT; i++) {
-			if (__deferred_until[i] && __deferred_until[i] < t) {
-				/*
-				 * Call deferred function.  Clear timer first,
-				 * so it can request itself be called later.
-				 */
-				__deferred_until[i] = 0;
-				interrupt_enable();
-				CPRINTS("hook call deferred 0x%p",
-					__deferred_funcs[i].routine);
-				__deferred_funcs[i].routine();
-				interrupt_disable();
-			}
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_start = get_time().val;
+#endif
+		/* Handle deferred routines, earliest first */
+		while (deferred_heap_size &&
+		       __deferred_until[deferred_heap[0]] < t) {
+			int i = deferred_heap[0];
+
+			/*
+			 * Call deferred function.  Clear timer first,
+			 * so it can request itself be called later.
+			 */
+			deferred_heap_cancel(i);
+#ifdef CONFIG_HOOK_DEBUG
+			irq_off_time += get_time().val - irq_off_start;
+#endif
+			interrupt_enable();
+			CPRINTS("hook call deferred 0x%p",
+				__deferred_funcs[i].routine);
+			__deferred_funcs[i].routine();
+			interrupt_disable();
+#ifdef CONFIG_HOOK_DEBUG
+			irq_off_start = get_time().val;
+#endif
 		}
 
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_time += get_time().val - irq_off_start;
+#endif
 		interrupt_enable();
 		if (t - last_tick >= HOOK_TICK_INTERVAL) {
 #ifdef CONFIG_HOOK_DEBUG
@@ -232,18 +373,27 @@ void hook_task(void *u)
 		if (last_tick + HOOK_TICK_INTERVAL > t)
 			next = last_tick + HOOK_TICK_INTERVAL - t;
 
+		/* The earliest pending deferred routine is at the heap root */
 		interrupt_disable();
-		for (i = 0; i < DEFERRED_FUNCS_COUNT && next > 0; i++) {
-			if (!__deferred_until[i])
-				continue;
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_start = get_time().val;
+#endif
+		if (deferred_heap_size && next > 0) {
+			uint64_t until = __deferred_until[deferred_heap[0]];
 
-			if (__deferred_until[i] < t)
+			if (until < t)
 				next = 0;
-			else if (__deferred_until[i] - t < next)
-				next = __deferred_until[i] - t;
+			else if (until - t < next)
+				next = until - t;
 		}
 
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_time += get_time().val - irq_off_start;
+#endif
 		interrupt_enable();
+#ifdef CONFIG_HOOK_DEBUG
+		record_deferred_irq_off(irq_off_time);
+#endif
 
 		/*
 		 * If nothing is immediately pending, sleep until the next
@@ -285,6 +435,14 @@ static int command_stats(int argc, const char **argv)
 			 (uint32_t)max_hook_run_time[i],
 			 (uint32_t)avg_hook_run_time[i]);
 
+	ccprintf("Deferred routines:\n");
+	ccprintf("  Pending:     %7d (max %d of %d)\n", deferred_heap_size,
+		 max_deferred_pending, (int)DEFERRED_FUNCS_COUNT);
+	ccprintf("  Max IRQ off: %7d us\n",
+		 (uint32_t)max_deferred_irq_off_time);
+	ccprintf("  Average:     %7d us\n",
+		 (uint32_t)avg_deferred_irq_off_time);
+
 	return EC_SUCCESS;
 }
 DECLARE_CONSOLE_COMMAND(hookstats, command_stats, NULL, "Print stats of hooks");
@@ -83,6 +83,14 @@ static const uint16_t hc_suppressed_cmd[] = { CONFIG_SUPPRESSED_HOST_COMMANDS };
 static uint32_t hc_suppressed_cnt[ARRAY_SIZE(hc_suppressed_cmd)];
 #endif
 
+#ifdef CONFIG_HOST_COMMAND_STATS
+/* Handler timing statistics, one slot per command seen */
+static struct ec_host_command_stats_slot
+	hc_stats[CONFIG_HOST_COMMAND_STATS_SLOTS];
+static int hc_stats_slots;
+static uint32_t hc_stats_untracked;
+#endif
+
 test_mockable void host_send_response(struct host_cmd_handler_args *args)
 {
 #ifdef CONFIG_HOST_COMMAND_STATUS
@@ -337,46 +345,148 @@ host_packet_bad:
 	host_packet_respond(&args0);
 }
 
-const struct host_command *find_host_command(int command)
+test_export_static const struct host_command *
+find_host_command_linear(int command)
 {
-	if (IS_ENABLED(CONFIG_SYSTEM_SAFE_MODE) && system_is_in_safe_mode()) {
-		if (!command_is_allowed_in_safe_mode(command))
+	const struct host_command *cmd;
+
+	for (cmd = __hcmds; cmd < __hcmds_end; cmd++) {
+		if (command == cmd->command)
+			return cmd;
+	}
+
+	return NULL;
+}
+
+test_export_static const struct host_command *
+find_host_command_sorted(int command)
+{
+	const struct host_command *l, *r, *m;
+	uint32_t num;
+
+	/* Use binary search to locate host command handler */
+	l = __hcmds;
+	r = __hcmds_end - 1;
+
+	while (1) {
+		if (l > r)
 			return NULL;
+
+		num = r - l;
+		m = l + (num / 2);
+
+		if (m->command < command)
+			l = m + 1;
+		else if (m->command > command)
+			r = m - 1;
+		else
+			return m;
 	}
-	if (IS_ENABLED(CONFIG_ZEPHYR)) {
-		return zephyr_find_host_command(command);
-	} else if (IS_ENABLED(CONFIG_HOSTCMD_SECTION_SORTED)) {
-		const struct host_command *l, *r, *m;
-		uint32_t num;
+}
 
-		/* Use binary search to locate host command handler */
-		l = __hcmds;
-		r = __hcmds_end - 1;
+static const struct host_command *find_host_command_search(int command)
+{
+	if (IS_ENABLED(CONFIG_HOSTCMD_SECTION_SORTED))
+		return find_host_command_sorted(command);
+	else
+		return find_host_command_linear(command);
+}
 
-		while (1) {
-			if (l > r)
-				return NULL;
+#ifdef CONFIG_HOSTCMD_SECTION_INDEXED
+/* Number of command codes covered by one index page */
+#define HCMD_INDEX_PAGE_SIZE 64
 
-			num = r - l;
-			m = l + (num / 2);
+/* Command codes covered by the index */
+#define HCMD_INDEX_RANGE (HCMD_INDEX_PAGE_SIZE * 256)
 
-			if (m->command < command)
-				l = m + 1;
-			else if (m->command > command)
-				r = m - 1;
+/* Index entries which don't refer to an index page or a command */
+#define HCMD_INDEX_NONE 0
+#define HCMD_INDEX_SEARCH 0xff
+
+BUILD_ASSERT(CONFIG_HOSTCMD_INDEX_PAGES < HCMD_INDEX_SEARCH);
+
+/*
+ * Two-level index of the host command section. The directory is indexed by
+ * command / HCMD_INDEX_PAGE_SIZE and holds the index page number plus one.
+ * Index pages hold the __hcmds offset plus one of each command in their range.
+ * Either level may hold HCMD_INDEX_NONE if there is no such command, or
+ * HCMD_INDEX_SEARCH if the command didn't fit in the index.
+ */
+static uint8_t hcmd_index_dir[HCMD_INDEX_RANGE / HCMD_INDEX_PAGE_SIZE];
+static uint8_t hcmd_index_pages[CONFIG_HOSTCMD_INDEX_PAGES]
+			       [HCMD_INDEX_PAGE_SIZE];
+static bool hcmd_index_ready;
+
+static void host_command_index_init(void)
+{
+	const struct host_command *cmd;
+	int pages = 0;
+
+	for (cmd = __hcmds; cmd < __hcmds_end; cmd++) {
+		int entry = cmd - __hcmds + 1;
+		uint8_t *dir, *page;
+
+		if (cmd->command >= HCMD_INDEX_RANGE)
+			continue;
+
+		dir = &hcmd_index_dir[cmd->command / HCMD_INDEX_PAGE_SIZE];
+		if (*dir == HCMD_INDEX_NONE) {
+			if (pages < CONFIG_HOSTCMD_INDEX_PAGES)
+				*dir = ++pages;
 			else
-				return m;
+				*dir = HCMD_INDEX_SEARCH;
 		}
-	} else {
-		const struct host_command *cmd;
+		if (*dir == HCMD_INDEX_SEARCH)
+			continue;
 
-		for (cmd = __hcmds; cmd < __hcmds_end; cmd++) {
-			if (command == cmd->command)
-				return cmd;
-		}
+		if (entry > HCMD_INDEX_SEARCH)
+			entry = HCMD_INDEX_SEARCH;
+		page = hcmd_index_pages[*dir - 1];
+		page[cmd->command % HCMD_INDEX_PAGE_SIZE] = entry;
+	}
+
+	hcmd_index_ready = true;
+}
+
+test_export_static const struct host_command *
+find_host_command_indexed(int command)
+{
+	uint8_t entry;
+
+	/* Commands may arrive in interrupt context before the index is built */
+	if (!hcmd_index_ready || command < 0 || command >= HCMD_INDEX_RANGE)
+		return find_host_command_search(command);
 
+	entry = hcmd_index_dir[command / HCMD_INDEX_PAGE_SIZE];
+	if (entry == HCMD_INDEX_NONE)
 		return NULL;
+
+	if (entry != HCMD_INDEX_SEARCH) {
+		entry = hcmd_index_pages[entry - 1]
+					[command % HCMD_INDEX_PAGE_SIZE];
+		if (entry == HCMD_INDEX_NONE)
+			return NULL;
+		if (entry != HCMD_INDEX_SEARCH)
+			return __hcmds + entry - 1;
+	}
+
+	return find_host_command_search(command);
+}
+#endif /* CONFIG_HOSTCMD_SECTION_INDEXED */
+
+const struct host_command *find_host_command(int command)
+{
+	if (IS_ENABLED(CONFIG_SYSTEM_SAFE_MODE) && system_is_in_safe_mode()) {
+		if (!command_is_allowed_in_safe_mode(command))
+			return NULL;
 	}
+	if (IS_ENABLED(CONFIG_ZEPHYR))
+		return zephyr_find_host_command(command);
+#ifdef CONFIG_HOSTCMD_SECTION_INDEXED
+	return find_host_command_indexed(command);
+#else
+	return find_host_command_search(command);
+#endif
 }
 
 void host_command_task(void *u)
@@ -387,6 +497,9 @@ void host_command_task(void *u)
 	t1.val = 0;
 
 	host_command_init();
+#ifdef CONFIG_HOSTCMD_SECTION_INDEXED
+	host_command_index_init();
+#endif
 #ifdef CONFIG_SUPPRESSED_HOST_COMMANDS
 	suppressed_cmd_deadline.val = get_time().val + SUPPRESSED_CMD_INTERVAL;
 #endif
@@ -471,6 +584,44 @@ DECLARE_HOOK(HOOK_SYSJUMP, dump_host_command_suppressed_, HOOK_PRIO_DEFAULT);
 }
 #endif /* CONFIG_SUPPRESSED_HOST_COMMANDS */
 
+#ifdef CONFIG_HOST_COMMAND_STATS
+/**
+ * Account a host command handler run in the statistics.
+ *
+ * @param command	Host command number
+ * @param us		Handler run time in microseconds
+ */
+static void host_command_stats_record(uint16_t command, uint32_t us)
+{
+	struct ec_host_command_stats_slot *slot;
+	int bucket;
+
+	for (slot = hc_stats; slot < hc_stats + hc_stats_slots; slot++) {
+		if (slot->command == command)
+			break;
+	}
+
+	if (slot == hc_stats + hc_stats_slots) {
+		if (hc_stats_slots == ARRAY_SIZE(hc_stats)) {
+			hc_stats_untracked++;
+			return;
+		}
+		hc_stats_slots++;
+		slot->command = command;
+		slot->min_us = UINT32_MAX;
+	}
+
+	slot->count++;
+	slot->total_us += us;
+	slot->min_us = MIN(slot->min_us, us);
+	slot->max_us = MAX(slot->max_us, us);
+
+	bucket = us ? MIN(__fls(us), EC_HOST_COMMAND_STATS_BUCKETS - 1) : 0;
+	if (slot->histogram[bucket] < UINT16_MAX)
+		slot->histogram[bucket]++;
+}
+#endif /* CONFIG_HOST_COMMAND_STATS */
+
 /**
  * Print debug output for the host command request, before it's processed.
  *
@@ -565,6 +716,15 @@ uint16_t host_command_process(struct host_cmd_handler_args *args)
 			rv = EC_RES_INVALID_COMMAND;
 		else if (!(EC_VER_MASK(args->version) & cmd->version_mask))
 			rv = EC_RES_INVALID_VERSION;
+#ifdef CONFIG_HOST_COMMAND_STATS
+		else if (!in_interrupt_context()) {
+			timestamp_t t0 = get_time();
+
+			rv = cmd->handler(args);
+			host_command_stats_record(args->command,
+						  time_since32(t0));
+		}
+#endif
 		else
 			rv = cmd->handler(args);
 	}
@@ -600,6 +760,49 @@ uint8_t host_command_get_saved_result(void)
 }
 #endif /* CONFIG_HOST_COMMAND_STATUS */
 
+#ifdef CONFIG_HOST_COMMAND_STATS
+/*****************************************************************************/
+/* Host commands */
+
+static enum ec_status
+host_command_stats(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_host_command_stats *p = args->params;
+	struct ec_response_host_command_stats *r = args->response;
+	int max_slots;
+	int i;
+
+	switch (p->action) {
+	case EC_HOST_COMMAND_STATS_GET:
+		break;
+	case EC_HOST_COMMAND_STATS_RESET:
+		memset(hc_stats, 0, sizeof(hc_stats));
+		hc_stats_slots = 0;
+		hc_stats_untracked = 0;
+		return EC_RES_SUCCESS;
+	default:
+		return EC_RES_INVALID_PARAM;
+	}
+
+	if (args->response_max < sizeof(*r))
+		return EC_RES_RESPONSE_TOO_BIG;
+
+	max_slots = (args->response_max - sizeof(*r)) / sizeof(r->slots[0]);
+
+	r->num_slots = hc_stats_slots;
+	r->untracked = hc_stats_untracked;
+	for (i = 0; i < max_slots && p->index + i < hc_stats_slots; i++)
+		r->slots[i] = hc_stats[p->index + i];
+	r->count = i;
+
+	args->response_size = sizeof(*r) + i * sizeof(r->slots[0]);
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_HOST_COMMAND_STATS, host_command_stats,
+		     EC_VER_MASK(0));
+#endif /* CONFIG_HOST_COMMAND_STATS */
+
 /*****************************************************************************/
 /* Console commands */
 
@@ -0,0 +1,131 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Asynchronous I2C requests */
+
+#include "builtin/assert.h"
+#include "common.h"
+#include "hooks.h"
+#include "i2c.h"
+#include "task.h"
+#include "util.h"
+
+/* Requests waiting to be executed, in submission order. */
+static struct i2c_xfer_req *queue_head;
+static struct i2c_xfer_req *queue_tail;
+
+static int i2c_xfer_req_run(const struct i2c_xfer_req *req)
+{
+	const struct i2c_xfer_desc *x;
+	int rv = EC_SUCCESS;
+
+	for (x = req->xfer; x && rv == EC_SUCCESS; x = x->next)
+		rv = i2c_xfer_unlocked(req->port, x->addr_flags, x->out,
+				       x->out_size, x->in, x->in_size,
+				       I2C_XFER_SINGLE);
+	return rv;
+}
+
+static void i2c_xfer_req_complete(struct i2c_xfer_req *req)
+{
+	if (req->complete)
+		req->complete(req);
+	else if (req->event)
+		task_set_event(req->task, req->event);
+}
+
+static void i2c_async_run(void);
+DECLARE_DEFERRED(i2c_async_run);
+
+static void i2c_async_run(void)
+{
+	struct i2c_xfer_req *batch = NULL;
+	struct i2c_xfer_req **tail = &batch;
+	struct i2c_xfer_req **prev, *req;
+	uint32_t key;
+	int port;
+
+	/*
+	 * Pull the requests for the port at the head of the queue, keeping
+	 * their order. The other ports are left for the next call, so that
+	 * one deferred call holds the hooks task for a single bus only.
+	 */
+	key = irq_lock();
+	if (!queue_head) {
+		irq_unlock(key);
+		return;
+	}
+	port = queue_head->port;
+	queue_tail = NULL;
+	prev = &queue_head;
+	while ((req = *prev) != NULL) {
+		if (req->port != port) {
+			queue_tail = req;
+			prev = &req->link;
+			continue;
+		}
+		*prev = req->link;
+		req->link = NULL;
+		*tail = req;
+		tail = &req->link;
+	}
+	irq_unlock(key);
+
+	if (queue_head)
+		hook_call_deferred(&i2c_async_run_data, 0);
+
+	i2c_lock(port, 1);
+	for (req = batch; req; req = req->link)
+		req->rv = i2c_xfer_req_run(req);
+	i2c_lock(port, 0);
+
+	/*
+	 * Complete once the bus is released, so that the callbacks can
+	 * access it or submit the request again.
+	 */
+	while (batch) {
+		req = batch;
+		batch = req->link;
+		req->pending = false;
+		i2c_xfer_req_complete(req);
+	}
+}
+
+int i2c_xfer_submit(struct i2c_xfer_req *req)
+{
+	uint32_t key;
+
+	if (req == NULL || req->xfer == NULL)
+		return EC_ERROR_INVAL;
+
+	/* Nothing runs the queue before the tasks are started. */
+	if (!task_start_called()) {
+		i2c_lock(req->port, 1);
+		req->rv = i2c_xfer_req_run(req);
+		i2c_lock(req->port, 0);
+		i2c_xfer_req_complete(req);
+		return EC_SUCCESS;
+	}
+
+	/* The hooks task can't wait for the queue it runs. */
+	ASSERT(req->complete || req->task != TASK_ID_HOOKS);
+
+	key = irq_lock();
+	if (req->pending) {
+		irq_unlock(key);
+		return EC_ERROR_BUSY;
+	}
+	req->pending = true;
+	req->link = NULL;
+	if (queue_tail)
+		queue_tail->link = req;
+	else
+		queue_head = req;
+	queue_tail = req;
+	irq_unlock(key);
+
+	hook_call_deferred(&i2c_async_run_data, 0);
+	return EC_SUCCESS;
+}
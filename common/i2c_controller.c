@@ -21,6 +21,7 @@
 #include "printf.h"
 #include "system.h"
 #include "task.h"
+#include "timer.h"
 #include "util.h"
 
 #ifdef CONFIG_ZEPHYR
@@ -191,20 +192,21 @@ static int i2c_xfer_no_retry(const int port, const uint16_t addr_flags,
 }
 #endif /* CONFIG_I2C_XFER_LARGE_TRANSFER */
 
-int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
-		      const uint8_t *out, int out_size, uint8_t *in,
-		      int in_size, int flags)
+/**
+ * Run a transaction, retrying it while the bus is busy.
+ *
+ * @param retries	Set to the number of attempts retried
+ */
+static int i2c_xfer_retry(const int port, const uint16_t addr_flags,
+			  const uint8_t *out, int out_size, uint8_t *in,
+			  int in_size, int flags, int *retries)
 {
 	int i;
 	int ret = EC_SUCCESS;
 	uint16_t no_pec_af = addr_flags & ~I2C_FLAG_PEC;
 
-	if (!i2c_port_is_locked(port)) {
-		CPUTS("Access I2C without lock!");
-		return EC_ERROR_INVAL;
-	}
-
 	for (i = 0; i <= CONFIG_I2C_NACK_RETRY_COUNT; i++) {
+		*retries = i;
 #ifdef CONFIG_ZEPHYR
 		struct i2c_msg msg[2];
 		int num_msgs = 0;
@@ -278,6 +280,32 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 	return ret;
 }
 
+int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
+		      const uint8_t *out, int out_size, uint8_t *in,
+		      int in_size, int flags)
+{
+	__maybe_unused timestamp_t start;
+	int retries;
+	int ret;
+
+	if (!i2c_port_is_locked(port)) {
+		CPUTS("Access I2C without lock!");
+		return EC_ERROR_INVAL;
+	}
+
+	if (!IS_ENABLED(CONFIG_I2C_STATS))
+		return i2c_xfer_retry(port, addr_flags, out, out_size, in,
+				      in_size, flags, &retries);
+
+	start = get_time();
+	ret = i2c_xfer_retry(port, addr_flags, out, out_size, in, in_size,
+			     flags, &retries);
+	i2c_stats_notify(port, addr_flags, out_size + in_size, ret, retries,
+			 time_since32(start));
+
+	return ret;
+}
+
 int i2c_xfer(const int port, const uint16_t addr_flags, const uint8_t *out,
 	     int out_size, uint8_t *in, int in_size)
 {
@@ -5,9 +5,11 @@
 
 #include "common.h"
 #include "console.h"
+#include "host_command.h"
 #include "i2c.h"
 #include "stdbool.h"
 #include "stddef.h"
+#include "task.h"
 #include "util.h"
 
 #define CPUTS(outstr) cputs(CC_I2C, outstr)
@@ -54,6 +56,145 @@ trace_enabled:
 	CPRINTF("\n");
 }
 
+#ifdef CONFIG_I2C_STATS
+/* Transaction statistics, one slot per port and peripheral address seen */
+static struct ec_i2c_stats_slot stats[CONFIG_I2C_STATS_SLOTS];
+static int stats_slots;
+static uint32_t stats_untracked;
+
+void i2c_stats_notify(int port, uint16_t addr_flags, size_t size, int ret,
+		      int retries, uint32_t us)
+{
+	struct ec_i2c_stats_slot *slot;
+	uint16_t addr = I2C_STRIP_FLAGS(addr_flags);
+	uint32_t key;
+	int bucket;
+
+	/* Transactions on different ports may run concurrently. */
+	key = irq_lock();
+
+	for (slot = stats; slot < stats + stats_slots; slot++) {
+		if (slot->port == port && slot->addr == addr)
+			break;
+	}
+
+	if (slot == stats + stats_slots) {
+		if (stats_slots == ARRAY_SIZE(stats)) {
+			stats_untracked++;
+			irq_unlock(key);
+			return;
+		}
+		stats_slots++;
+		slot->port = port;
+		slot->addr = addr;
+	}
+
+	slot->count++;
+	slot->bytes += size;
+	slot->retries += retries;
+	if (ret == EC_ERROR_TIMEOUT)
+		slot->timeouts++;
+	else if (ret != EC_SUCCESS)
+		slot->errors++;
+	slot->busy_us += us;
+	slot->max_us = MAX(slot->max_us, us);
+
+	bucket = us ? MIN(__fls(us), EC_I2C_STATS_BUCKETS - 1) : 0;
+	if (slot->histogram[bucket] < UINT16_MAX)
+		slot->histogram[bucket]++;
+
+	irq_unlock(key);
+}
+
+static void i2c_stats_reset(void)
+{
+	uint32_t key = irq_lock();
+
+	memset(stats, 0, sizeof(stats));
+	stats_slots = 0;
+	stats_untracked = 0;
+
+	irq_unlock(key);
+}
+
+static int command_i2ctrace_stats(void)
+{
+	struct ec_i2c_stats_slot slot;
+	uint32_t untracked;
+	uint32_t key;
+	bool valid;
+	int i;
+
+	ccprintf("port address   count     bytes  busy(us) retries timeouts "
+		 "errors max(us)\n");
+
+	for (i = 0; i < ARRAY_SIZE(stats); i++) {
+		/* Print a copy, as the slot may be updated meanwhile */
+		key = irq_lock();
+		valid = i < stats_slots;
+		if (valid)
+			slot = stats[i];
+		irq_unlock(key);
+
+		if (!valid)
+			break;
+
+		ccprintf("%-4d 0x%-5X %7u %9u %9llu %7u %8u %6u %7u\n",
+			 slot.port, slot.addr, slot.count, slot.bytes,
+			 (unsigned long long)slot.busy_us, slot.retries,
+			 slot.timeouts, slot.errors, slot.max_us);
+		cflush();
+	}
+
+	key = irq_lock();
+	untracked = stats_untracked;
+	irq_unlock(key);
+
+	if (untracked)
+		ccprintf("%u transactions with untracked peripherals\n",
+			 untracked);
+
+	return EC_SUCCESS;
+}
+
+static enum ec_status i2c_stats_host_cmd(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_i2c_stats *p = args->params;
+	struct ec_response_i2c_stats *r = args->response;
+	uint32_t key;
+	int max_slots;
+	int i;
+
+	switch (p->action) {
+	case EC_I2C_STATS_GET:
+		break;
+	case EC_I2C_STATS_RESET:
+		i2c_stats_reset();
+		return EC_RES_SUCCESS;
+	default:
+		return EC_RES_INVALID_PARAM;
+	}
+
+	if (args->response_max < sizeof(*r))
+		return EC_RES_RESPONSE_TOO_BIG;
+
+	max_slots = (args->response_max - sizeof(*r)) / sizeof(r->slots[0]);
+
+	key = irq_lock();
+	r->num_slots = stats_slots;
+	r->untracked = stats_untracked;
+	for (i = 0; i < max_slots && p->index + i < stats_slots; i++)
+		r->slots[i] = stats[p->index + i];
+	irq_unlock(key);
+	r->count = i;
+
+	args->response_size = sizeof(*r) + i * sizeof(r->slots[0]);
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_I2C_STATS, i2c_stats_host_cmd, EC_VER_MASK(0));
+#endif /* CONFIG_I2C_STATS */
+
 static int command_i2ctrace_list(void)
 {
 	size_t i;
@@ -166,6 +307,18 @@ static int command_i2ctrace(int argc, const char **argv)
 	if (!strcasecmp(argv[1], "list") && argc == 2)
 		return command_i2ctrace_list();
 
+#ifdef CONFIG_I2C_STATS
+	if (!strcasecmp(argv[1], "stats")) {
+		if (argc == 2)
+			return command_i2ctrace_stats();
+		if (argc == 3 && !strcasecmp(argv[2], "reset")) {
+			i2c_stats_reset();
+			return EC_SUCCESS;
+		}
+		return EC_ERROR_PARAM2;
+	}
+#endif
+
 	if (argc < 3)
 		return EC_ERROR_PARAM_COUNT;
 
@@ -199,5 +352,9 @@ static int command_i2ctrace(int argc, const char **argv)
 }
 DECLARE_CONSOLE_COMMAND(i2ctrace, command_i2ctrace,
 			"[list | disable <id> | enable <port> <address> | "
-			"enable <port> <address-low> <address-high>]",
+			"enable <port> <address-low> <address-high>"
+#ifdef CONFIG_I2C_STATS
+			" | stats [reset]"
+#endif
+			"]",
 			"Trace I2C transactions");
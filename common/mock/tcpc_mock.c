@@ -135,6 +135,11 @@ static int mock_set_rx_enable(int port, int enable)
 	return EC_SUCCESS;
 }
 
+__maybe_unused static int mock_sop_prime_enable(int port, bool enable)
+{
+	return EC_SUCCESS;
+}
+
 static int mock_get_message_raw(int port, uint32_t *payload, int *head)
 {
 	return EC_SUCCESS;
@@ -211,6 +216,9 @@ const struct tcpm_drv mock_tcpc_driver = {
 	.set_vconn = &mock_set_vconn,
 	.set_msg_header = &mock_set_msg_header,
 	.set_rx_enable = &mock_set_rx_enable,
+#ifdef CONFIG_USB_PD_DECODE_SOP
+	.sop_prime_enable = &mock_sop_prime_enable,
+#endif
 	.get_message_raw = &mock_get_message_raw,
 	.transmit = &mock_transmit,
 	.tcpc_alert = &mock_tcpc_alert,
@@ -22,6 +22,8 @@ struct tcpci_reg {
 	uint8_t size;
 	uint16_t value;
 	const char *name;
+	/* Number of times the register was read */
+	int reads;
 };
 
 #define TCPCI_REG(reg_name, reg_size) \
@@ -516,6 +518,11 @@ uint16_t mock_tcpci_get_reg(int reg_offset)
 	return tcpci_regs[reg_offset].value;
 }
 
+int mock_tcpci_get_reg_reads(int reg_offset)
+{
+	return tcpci_regs[reg_offset].reads;
+}
+
 int tcpci_i2c_xfer(int port, uint16_t addr_flags, const uint8_t *out,
 		   int out_size, uint8_t *in, int in_size, int flags)
 {
@@ -598,6 +605,7 @@ int tcpci_i2c_xfer(int port, uint16_t addr_flags, const uint8_t *out,
 				 in_size, reg->size);
 			return EC_ERROR_UNKNOWN;
 		}
+		reg->reads++;
 		if (reg->size == 1)
 			in[0] = reg->value;
 		else if (reg->size == 2) {
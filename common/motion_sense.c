@@ -854,6 +854,13 @@ void motion_sense_task(void *u)
 	while (1) {
 		ts_begin_task = get_time();
 		atomic_add(&motion_sense_task_loops, 1);
+
+		/*
+		 * Drain all the sensors before publishing any of their data, so
+		 * the AP sees the samples of one task loop in a single commit.
+		 */
+		if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+			motion_sense_fifo_batch_begin();
 		for (i = 0; i < motion_sensor_count; ++i) {
 			sensor = &motion_sensors[i];
 
@@ -866,6 +873,8 @@ void motion_sense_task(void *u)
 				ready_status |= BIT(i);
 			}
 		}
+		if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+			motion_sense_fifo_batch_end();
 		if (IS_ENABLED(CONFIG_GESTURE_DETECTION))
 			check_and_queue_gestures(&event);
 		if (IS_ENABLED(CONFIG_LID_ANGLE)) {
@@ -1292,6 +1301,21 @@ static enum ec_status host_cmd_motion_sense(struct host_cmd_handler_args *args)
 			&(args->response_size));
 		args->response_size += sizeof(out->fifo_read);
 		break;
+	case MOTIONSENSE_CMD_FIFO_READ_PACKED: {
+		uint16_t size;
+
+		if (!IS_ENABLED(CONFIG_ACCEL_FIFO))
+			return EC_RES_INVALID_PARAM;
+		out->fifo_read_packed.number_data =
+			motion_sense_fifo_read_packed(
+				args->response_max -
+					sizeof(out->fifo_read_packed),
+				in->fifo_read_packed.max_data_vector,
+				out->fifo_read_packed.data, &size);
+		out->fifo_read_packed.size = size;
+		args->response_size = sizeof(out->fifo_read_packed) + size;
+		break;
+	}
 	case MOTIONSENSE_CMD_FIFO_INT_ENABLE:
 		if (!IS_ENABLED(CONFIG_ACCEL_FIFO))
 			return EC_RES_INVALID_PARAM;
@@ -9,6 +9,7 @@
 #include "math_util.h"
 #include "mkbp_event.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_fifo_packed.h"
 #include "online_calibration.h"
 #include "stdbool.h"
 #include "tablet_mode.h"
@@ -59,6 +60,19 @@ static uint16_t fifo_sensor_lost[MAX_MOTION_SENSORS];
 /** Metadata for the fifo, used for staging and spreading data. */
 static struct fifo_staged fifo_staged;
 
+/**
+ * Set while a batch of commits is open, see motion_sense_fifo_batch_begin().
+ * While set, committed entries stay after the tail of the queue, hidden from
+ * the AP, and are only published when the batch ends.
+ */
+static bool fifo_batch_open;
+
+/**
+ * Number of entries committed during the current batch, sitting after the tail
+ * of the queue and before the staged entries.
+ */
+static uint16_t fifo_sealed;
+
 /**
  * Cached expected timestamp per sensor. If a sensor's timestamp pre-dates this
  * timestamp it will be fast forwarded.
@@ -208,15 +222,30 @@ static void fifo_pop(void)
 	}
 }
 
+/**
+ * Make the entries committed during the current batch readable by the AP.
+ *
+ * WARNING: This function MUST be called from within a locked context of
+ * g_sensor_mutex.
+ */
+static void fifo_publish_sealed(void)
+{
+	queue_advance_tail(&fifo, fifo_sealed);
+	fifo_sealed = 0;
+}
+
 /**
  * Make sure that the fifo has at least 1 empty spot to stage data into.
  */
 static void fifo_ensure_space(void)
 {
 	/* If we already have space just bail. */
-	if (queue_space(&fifo) > fifo_staged.count)
+	if (queue_space(&fifo) > fifo_sealed + fifo_staged.count)
 		return;
 
+	/* Data committed in this batch may be dropped: publish it first. */
+	fifo_publish_sealed();
+
 	/*
 	 * Pop at least 1 spot, but if all the following conditions are met we
 	 * will continue to pop:
@@ -317,7 +346,7 @@ fifo_stage_unit(struct ec_response_motion_sensor_data *data,
 	 * because it will always be past the tail and thus the AP will never
 	 * read this until motion_sense_fifo_commit_data() is called.
 	 */
-	chunk = queue_get_write_chunk(&fifo, fifo_staged.count);
+	chunk = queue_get_write_chunk(&fifo, fifo_sealed + fifo_staged.count);
 
 	if (!chunk.buffer) {
 		/*
@@ -382,7 +411,7 @@ static inline struct ec_response_motion_sensor_data *
 peek_fifo_staged(size_t offset)
 {
 	return (struct ec_response_motion_sensor_data *)queue_get_write_chunk(
-		       &fifo, offset)
+		       &fifo, fifo_sealed + offset)
 		.buffer;
 }
 
@@ -570,7 +599,7 @@ commit_data_end:
 
 		/* Get the sensor number and point to the timestamp entry. */
 		sensor_num = data->sensor_num;
-		data = peek_fifo_staged(i - 1);
+		data = i ? peek_fifo_staged(i - 1) : NULL;
 		if (!data) {
 			continue;
 		}
@@ -611,8 +640,14 @@ commit_data_end:
 				next_timestamp[sensor_num].prev);
 	}
 
-	/* Advance the tail and clear the staged metadata. */
-	queue_advance_tail(&fifo, fifo_staged.count);
+	/*
+	 * Advance the tail, or in a batch, keep the entries hidden until the
+	 * batch ends.
+	 */
+	if (fifo_batch_open)
+		fifo_sealed += fifo_staged.count;
+	else
+		queue_advance_tail(&fifo, fifo_staged.count);
 
 	/* Reset metadata for next staging cycle. */
 	memset(&fifo_staged, 0, sizeof(fifo_staged));
@@ -620,6 +655,23 @@ commit_data_end:
 	mutex_unlock(&g_sensor_mutex);
 }
 
+void motion_sense_fifo_batch_begin(void)
+{
+	mutex_lock(&g_sensor_mutex);
+	fifo_batch_open = true;
+	mutex_unlock(&g_sensor_mutex);
+}
+
+void motion_sense_fifo_batch_end(void)
+{
+	motion_sense_fifo_commit_data();
+
+	mutex_lock(&g_sensor_mutex);
+	fifo_batch_open = false;
+	fifo_publish_sealed();
+	mutex_unlock(&g_sensor_mutex);
+}
+
 void motion_sense_fifo_get_info(
 	struct ec_response_motion_sense_fifo_info *fifo_info, int reset)
 {
@@ -681,6 +733,32 @@ int motion_sense_fifo_read(int capacity_bytes, int max_count, void *out,
 	return count;
 }
 
+int motion_sense_fifo_read_packed(int capacity_bytes, int max_count,
+				  void *out, uint16_t *out_size)
+{
+	struct motion_sense_fifo_packed_state state;
+	uint8_t *buf = (uint8_t *)out;
+	int count = 0, len;
+	size_t used = 0;
+
+	motion_sense_fifo_packed_init(&state);
+
+	mutex_lock(&g_sensor_mutex);
+	while (count < max_count && queue_count(&fifo)) {
+		len = motion_sense_fifo_pack(&state, get_fifo_head(),
+					     buf + used, capacity_bytes - used);
+		if (!len)
+			break;
+		queue_advance_head(&fifo, 1);
+		used += len;
+		count++;
+	}
+	mutex_unlock(&g_sensor_mutex);
+	*out_size = used;
+
+	return count;
+}
+
 void motion_sense_fifo_reset(void)
 {
 	static uint8_t fifo_info_buffer
@@ -691,6 +769,8 @@ void motion_sense_fifo_reset(void)
 
 	next_timestamp_initialized = 0;
 	memset(&fifo_staged, 0, sizeof(fifo_staged));
+	fifo_batch_open = false;
+	fifo_sealed = 0;
 	motion_sense_fifo_init();
 	queue_init(&fifo);
 	motion_sense_fifo_get_info(fifo_info, /*reset=*/true);
@@ -0,0 +1,162 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/*
+ * Encoder and decoder for MOTIONSENSE_CMD_FIFO_READ_PACKED records, shared by
+ * the EC and ectool.
+ */
+
+#include "common.h"
+#include "motion_sense_fifo_packed.h"
+
+#include <string.h>
+
+#define FULL_SIZE (1 + sizeof(struct ec_response_motion_sensor_data))
+#define TIMESTAMP_SIZE 4
+#define DELTA_SIZE 5
+
+static inline uint8_t packed_header(enum ec_motion_packed_type type,
+				    uint8_t sensor_num)
+{
+	return (type << EC_MOTION_PACKED_TYPE_SHIFT) | sensor_num;
+}
+
+static inline int is_timestamp(const struct ec_response_motion_sensor_data *e)
+{
+	return e->flags & MOTIONSENSE_SENSOR_FLAG_TIMESTAMP;
+}
+
+/* Record the entry as the new reference for the following deltas. */
+static void update_state(struct motion_sense_fifo_packed_state *state,
+			 const struct ec_response_motion_sensor_data *entry)
+{
+	if (is_timestamp(entry)) {
+		state->timestamp = entry->timestamp;
+		state->has_timestamp = 1;
+	} else if (entry->sensor_num < EC_MOTION_PACKED_MAX_SENSORS) {
+		memcpy(state->data[entry->sensor_num], entry->data,
+		       sizeof(entry->data));
+		state->has_data |= BIT(entry->sensor_num);
+	}
+}
+
+void motion_sense_fifo_packed_init(struct motion_sense_fifo_packed_state *state)
+{
+	memset(state, 0, sizeof(*state));
+}
+
+/* Try to encode the entry as a compact record; return its size or 0. */
+static int pack_compact(const struct motion_sense_fifo_packed_state *state,
+			const struct ec_response_motion_sensor_data *entry,
+			uint8_t *out, size_t size)
+{
+	int i;
+
+	if (entry->sensor_num > EC_MOTION_PACKED_SENSOR_MASK)
+		return 0;
+
+	if (is_timestamp(entry)) {
+		uint32_t delta = entry->timestamp - state->timestamp;
+
+		/* The reserved field is not sent, it decodes as 0. */
+		if (!state->has_timestamp || delta > UINT16_MAX ||
+		    size < TIMESTAMP_SIZE)
+			return 0;
+
+		out[0] = packed_header(EC_MOTION_PACKED_TIMESTAMP,
+				       entry->sensor_num);
+		out[1] = entry->flags;
+		out[2] = delta & 0xff;
+		out[3] = delta >> 8;
+		return TIMESTAMP_SIZE;
+	}
+
+	if (entry->sensor_num >= EC_MOTION_PACKED_MAX_SENSORS ||
+	    !(state->has_data & BIT(entry->sensor_num)) || size < DELTA_SIZE)
+		return 0;
+
+	out[0] = packed_header(EC_MOTION_PACKED_DELTA, entry->sensor_num);
+	out[1] = entry->flags;
+	for (i = 0; i < 3; i++) {
+		/* Axes wrap around, so that unsigned data works as well. */
+		int16_t delta = (int16_t)(uint16_t)(
+			entry->data[i] - state->data[entry->sensor_num][i]);
+
+		if (delta < INT8_MIN || delta > INT8_MAX)
+			return 0;
+		out[2 + i] = (uint8_t)delta;
+	}
+	return DELTA_SIZE;
+}
+
+int motion_sense_fifo_pack(struct motion_sense_fifo_packed_state *state,
+			   const struct ec_response_motion_sensor_data *entry,
+			   uint8_t *out, size_t size)
+{
+	int len = pack_compact(state, entry, out, size);
+
+	if (!len) {
+		if (size < FULL_SIZE)
+			return 0;
+		out[0] = packed_header(EC_MOTION_PACKED_FULL, 0);
+		memcpy(out + 1, entry, sizeof(*entry));
+		len = FULL_SIZE;
+	}
+
+	update_state(state, entry);
+	return len;
+}
+
+int motion_sense_fifo_unpack(struct motion_sense_fifo_packed_state *state,
+			     const uint8_t *in, size_t size,
+			     struct ec_response_motion_sensor_data *entry)
+{
+	uint8_t sensor_num;
+	int i, len;
+
+	if (size < 1)
+		return 0;
+
+	sensor_num = in[0] & EC_MOTION_PACKED_SENSOR_MASK;
+	memset(entry, 0, sizeof(*entry));
+
+	switch (in[0] >> EC_MOTION_PACKED_TYPE_SHIFT) {
+	case EC_MOTION_PACKED_FULL:
+		if (size < FULL_SIZE)
+			return 0;
+		memcpy(entry, in + 1, sizeof(*entry));
+		len = FULL_SIZE;
+		break;
+	case EC_MOTION_PACKED_TIMESTAMP:
+		if (size < TIMESTAMP_SIZE || !state->has_timestamp)
+			return 0;
+		entry->flags = in[1];
+		entry->sensor_num = sensor_num;
+		entry->timestamp = state->timestamp + (in[2] | (in[3] << 8));
+		if (!is_timestamp(entry))
+			return 0;
+		len = TIMESTAMP_SIZE;
+		break;
+	case EC_MOTION_PACKED_DELTA:
+		if (size < DELTA_SIZE ||
+		    sensor_num >= EC_MOTION_PACKED_MAX_SENSORS ||
+		    !(state->has_data & BIT(sensor_num)))
+			return 0;
+		entry->flags = in[1];
+		entry->sensor_num = sensor_num;
+		for (i = 0; i < 3; i++)
+			entry->data[i] = (int16_t)(uint16_t)(
+				state->data[sensor_num][i] + (int8_t)in[2 + i]);
+		if (is_timestamp(entry))
+			return 0;
+		len = DELTA_SIZE;
+		break;
+	default:
+		return 0;
+	}
+
+	update_state(state, entry);
+	return len;
+}
@@ -0,0 +1 @@
+motion_sense_fifo_packed.c
\ No newline at end of file
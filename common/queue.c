@@ -148,11 +148,11 @@ size_t queue_add_units(struct queue const *q, const void *src, size_t count)
 	return queue_add_memcpy(q, src, count, memcpy);
 }
 
-size_t queue_add_memcpy(struct queue const *q, const void *src, size_t count,
-			void *(*memcpy)(void *dest, const void *src, size_t n))
+static void
+queue_write_safe(struct queue const *q, const void *src, size_t tail,
+		 size_t transfer,
+		 void *(*memcpy)(void *dest, const void *src, size_t n))
 {
-	size_t transfer = MIN(count, queue_space(q));
-	size_t tail = q->state->tail & q->buffer_units_mask;
 	size_t first = MIN(transfer, q->buffer_units - tail);
 
 	memcpy(q->buffer + tail * q->unit_bytes, src, first * q->unit_bytes);
@@ -161,6 +161,15 @@ size_t queue_add_memcpy(struct queue const *q, const void *src, size_t count,
 		memcpy(q->buffer,
 		       ((uint8_t const *)src) + first * q->unit_bytes,
 		       (transfer - first) * q->unit_bytes);
+}
+
+size_t queue_add_memcpy(struct queue const *q, const void *src, size_t count,
+			void *(*memcpy)(void *dest, const void *src, size_t n))
+{
+	size_t transfer = MIN(count, queue_space(q));
+	size_t tail = q->state->tail & q->buffer_units_mask;
+
+	queue_write_safe(q, src, tail, transfer, memcpy);
 
 	return queue_advance_tail(q, transfer);
 }
@@ -232,6 +241,103 @@ size_t queue_peek_memcpy(struct queue const *q, void *dest, size_t i,
 	return transfer;
 }
 
+/*
+ * Single producer / single consumer access.
+ *
+ * The producer only ever writes the tail and the consumer only ever writes
+ * the head.  Each side reads the other side's index with acquire semantics,
+ * so that it sees the buffer accesses made before that index was published,
+ * and publishes its own index with release semantics, once it is done with
+ * the units it covers.
+ */
+
+/* Called by the producer: the head may move concurrently. */
+static size_t queue_spsc_space(struct queue const *q, size_t tail)
+{
+	size_t head = __atomic_load_n(&q->state->head, __ATOMIC_ACQUIRE);
+
+	return q->buffer_units - (tail - head);
+}
+
+/* Called by the consumer: the tail may move concurrently. */
+static size_t queue_spsc_count(struct queue const *q, size_t head)
+{
+	return __atomic_load_n(&q->state->tail, __ATOMIC_ACQUIRE) - head;
+}
+
+struct queue_chunk queue_spsc_get_write_chunk(struct queue const *q)
+{
+	size_t tail = q->state->tail;
+	size_t offset = tail & q->buffer_units_mask;
+
+	return ((struct queue_chunk){
+		.count = MIN(queue_spsc_space(q, tail),
+			     q->buffer_units - offset),
+		.buffer = q->buffer + (offset * q->unit_bytes),
+	});
+}
+
+struct queue_chunk queue_spsc_get_read_chunk(struct queue const *q)
+{
+	size_t head = q->state->head;
+	size_t offset = head & q->buffer_units_mask;
+
+	return ((struct queue_chunk){
+		.count = MIN(queue_spsc_count(q, head),
+			     q->buffer_units - offset),
+		.buffer = q->buffer + (offset * q->unit_bytes),
+	});
+}
+
+size_t queue_spsc_advance_tail(struct queue const *q, size_t count)
+{
+	size_t tail = q->state->tail;
+	size_t transfer = MIN(count, queue_spsc_space(q, tail));
+
+	__atomic_store_n(&q->state->tail, tail + transfer, __ATOMIC_RELEASE);
+
+	return transfer;
+}
+
+size_t queue_spsc_advance_head(struct queue const *q, size_t count)
+{
+	size_t head = q->state->head;
+	size_t transfer = MIN(count, queue_spsc_count(q, head));
+
+	__atomic_store_n(&q->state->head, head + transfer, __ATOMIC_RELEASE);
+
+	return transfer;
+}
+
+size_t queue_spsc_add_units(struct queue const *q, const void *src,
+			    size_t count)
+{
+	size_t tail = q->state->tail;
+	size_t transfer = MIN(count, queue_spsc_space(q, tail));
+
+	queue_write_safe(q, src, tail & q->buffer_units_mask, transfer,
+			 memcpy);
+
+	/* Publish all the units at once, after they are written. */
+	__atomic_store_n(&q->state->tail, tail + transfer, __ATOMIC_RELEASE);
+
+	return transfer;
+}
+
+size_t queue_spsc_remove_units(struct queue const *q, void *dest, size_t count)
+{
+	size_t head = q->state->head;
+	size_t transfer = MIN(count, queue_spsc_count(q, head));
+
+	queue_read_safe(q, dest, head & q->buffer_units_mask, transfer,
+			memcpy);
+
+	/* Free all the units at once, after they are read. */
+	__atomic_store_n(&q->state->head, head + transfer, __ATOMIC_RELEASE);
+
+	return transfer;
+}
+
 void queue_begin(struct queue const *q, struct queue_iterator *it)
 {
 	if (queue_is_empty(q))
@@ -104,8 +104,9 @@ static void mont_mul_1(const struct rsa_public_key *key, uint32_t *c,
 /**
  * Montgomery c[] = a[] * b[] / R % mod
  */
-static void mont_mul(const struct rsa_public_key *key, uint32_t *c,
-		     const uint32_t *a, const uint32_t *b)
+test_export_static void mont_mul(const struct rsa_public_key *key,
+				 uint32_t *c, const uint32_t *a,
+				 const uint32_t *b)
 {
 	uint32_t i;
 	for (i = 0; i < RSANUMWORDS; ++i)
@@ -115,6 +116,89 @@ static void mont_mul(const struct rsa_public_key *key, uint32_t *c,
 		mont_mul_add(key, c, a[i], b);
 }
 
+/**
+ * Montgomery t[RSANUMWORDS..] = a[] * a[] / R % mod
+ *
+ * Computes the full square first, which only needs half of the cross
+ * products as a[i] * a[j] == a[j] * a[i], then reduces it. This saves about a
+ * quarter of the multiplications of mont_mul().
+ *
+ * @param key	Key to use
+ * @param t	Work buffer; must be 2 x RSANUMWORDS elements long and not
+ *		overlap a[]. The result is left in its upper half.
+ * @param a	Number to square
+ */
+test_export_static void mont_sqr(const struct rsa_public_key *key,
+				 uint32_t *t, const uint32_t *a)
+{
+	uint64_t A;
+	uint32_t carry, shift;
+	uint32_t i, j;
+
+	for (i = 0; i < 2 * RSANUMWORDS; ++i)
+		t[i] = 0;
+
+	/* Cross products a[i] * a[j], i < j */
+	for (i = 0; i < RSANUMWORDS; ++i) {
+		carry = 0;
+		for (j = i + 1; j < RSANUMWORDS; ++j) {
+			A = mulaa32(a[i], a[j], t[i + j], carry);
+			t[i + j] = (uint32_t)A;
+			carry = A >> 32;
+		}
+		t[i + RSANUMWORDS] = carry;
+	}
+
+	/* Double them, and add the squares a[i] * a[i] */
+	carry = 0;
+	shift = 0;
+	for (i = 0; i < RSANUMWORDS; ++i) {
+		uint32_t lo = t[2 * i];
+		uint32_t hi = t[2 * i + 1];
+
+		A = mulaa32(a[i], a[i], (lo << 1) | shift, carry);
+		t[2 * i] = (uint32_t)A;
+		A = (A >> 32) + ((hi << 1) | (lo >> 31));
+		t[2 * i + 1] = (uint32_t)A;
+		carry = A >> 32;
+		shift = hi >> 31;
+	}
+
+	/* Montgomery reduction, one word at a time */
+	shift = 0;
+	for (i = 0; i < RSANUMWORDS; ++i) {
+		uint32_t d0 = t[i] * key->n0inv;
+
+		carry = 0;
+		for (j = 0; j < RSANUMWORDS; ++j) {
+			A = mulaa32(d0, key->n[j], t[i + j], carry);
+			t[i + j] = (uint32_t)A;
+			carry = A >> 32;
+		}
+
+		A = (uint64_t)t[i + RSANUMWORDS] + carry + shift;
+		t[i + RSANUMWORDS] = (uint32_t)A;
+		shift = A >> 32;
+	}
+
+	if (shift)
+		sub_mod(key, t + RSANUMWORDS);
+}
+
+/* Convert from big endian byte array to little endian word array. */
+static void load_be(uint32_t *a, const uint8_t *in)
+{
+	int i;
+
+	for (i = 0; i < RSANUMWORDS; ++i) {
+		uint32_t tmp = (in[((RSANUMWORDS - 1 - i) * 4) + 0] << 24) |
+			       (in[((RSANUMWORDS - 1 - i) * 4) + 1] << 16) |
+			       (in[((RSANUMWORDS - 1 - i) * 4) + 2] << 8) |
+			       (in[((RSANUMWORDS - 1 - i) * 4) + 3] << 0);
+		a[i] = tmp;
+	}
+}
+
 /**
  * In-place public exponentiation.
  * Exponent depends on the configuration (65537 (default), or 3).
@@ -133,28 +217,30 @@ static void mod_pow(const struct rsa_public_key *key, uint8_t *inout,
 	uint32_t *aaa = aa_r; /* Re-use location. */
 	int i;
 
-	/* Convert from big endian byte array to little endian word array. */
-	for (i = 0; i < RSANUMWORDS; ++i) {
-		uint32_t tmp = (inout[((RSANUMWORDS - 1 - i) * 4) + 0] << 24) |
-			       (inout[((RSANUMWORDS - 1 - i) * 4) + 1] << 16) |
-			       (inout[((RSANUMWORDS - 1 - i) * 4) + 2] << 8) |
-			       (inout[((RSANUMWORDS - 1 - i) * 4) + 3] << 0);
-		a[i] = tmp;
-	}
+	load_be(a, inout);
 
 	/* TODO(drinkcat): This operation could be precomputed to save time. */
 	mont_mul(key, a_r, a, key->rr); /* a_r = a * RR / R mod M */
+
+	/*
+	 * mont_sqr() needs a 2 x RSANUMWORDS work area, so squares are done
+	 * into two adjacent words arrays, and their result (left in the
+	 * second one) copied back where needed.
+	 */
 #ifdef CONFIG_RSA_EXPONENT_3
-	mont_mul(key, aa_r, a_r, a_r);
-	mont_mul(key, a, aa_r, a_r);
-	mont_mul_1(key, aaa, a);
+	memcpy(a, a_r, RSANUMBYTES);
+	mont_sqr(key, a_r, a); /* aa_r = a_r * a_r / R mod M */
+	mont_mul(key, a_r, aa_r, a); /* a_r = aa_r * a_r / R mod M */
+	mont_mul_1(key, aaa, a_r);
 #else
-	/* Exponent 65537 */
-	for (i = 0; i < 16; i += 2) {
-		mont_mul(key, aa_r, a_r, a_r); /* aa_r = a_r * a_r / R mod M */
-		mont_mul(key, a_r, aa_r, aa_r); /* a_r = aa_r * aa_r / R mod M
-						 */
+	/* Exponent 65537: 16 squares, then multiply by a */
+	memcpy(aa_r, a_r, RSANUMBYTES);
+	for (i = 0; i < 16; ++i) {
+		mont_sqr(key, a, aa_r); /* a_r = aa_r * aa_r / R mod M */
+		memcpy(aa_r, a_r, RSANUMBYTES);
 	}
+	/* a was overwritten, load it again from the untouched input. */
+	load_be(a, inout);
 	mont_mul(key, aaa, a_r, a); /* aaa = a_r * a / R mod M */
 #endif
 
@@ -0,0 +1,119 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Task wake-up latency statistics */
+
+#include "atomic.h"
+#include "common.h"
+#include "console.h"
+#include "histogram.h"
+#include "host_command.h"
+#include "task.h"
+#include "timer.h"
+#include "util.h"
+
+#if !defined(CONFIG_ZEPHYR) && !defined(CORE_CORTEX_M) && !defined(CORE_HOST)
+#error "CONFIG_TASK_WAKE_LATENCY is only hooked into Cortex-M, host and Zephyr"
+#endif
+
+/* The pending wake-ups are tracked in a single bitmap */
+BUILD_ASSERT(TASK_ID_COUNT <= 32);
+
+/* Tasks with an event set since they were last switched in */
+static atomic_t tasks_wake_pending;
+
+/* Wake-up latency statistics for each task */
+static struct {
+	uint32_t start; /* Time of the first pending event */
+	uint32_t count; /* Number of wake-ups */
+	uint32_t max; /* Maximum latency (us) */
+	uint16_t dist[EC_TASK_WAKE_LATENCY_BUCKETS]; /* log2 latency (us) */
+} wake_latency[TASK_ID_COUNT];
+
+void task_wake_latency_start(task_id_t tskid)
+{
+	/* Not a task, e.g. TASK_ID_INVALID on Zephyr */
+	if (tskid >= TASK_ID_COUNT)
+		return;
+
+	if (!task_start_called() || tskid == task_get_current() ||
+	    (tasks_wake_pending & BIT(tskid)))
+		return;
+
+	wake_latency[tskid].start = get_time().le.lo;
+	atomic_or(&tasks_wake_pending, BIT(tskid));
+}
+
+void task_wake_latency_end(task_id_t tskid)
+{
+	uint32_t latency;
+	int bucket;
+
+	if (tskid >= TASK_ID_COUNT)
+		return;
+
+	if (!(atomic_clear_bits(&tasks_wake_pending, BIT(tskid)) & BIT(tskid)))
+		return;
+
+	latency = get_time().le.lo - wake_latency[tskid].start;
+	wake_latency[tskid].count++;
+	wake_latency[tskid].max = MAX(wake_latency[tskid].max, latency);
+
+	bucket = latency ?
+			 MIN(__fls(latency), EC_TASK_WAKE_LATENCY_BUCKETS - 1) :
+			 0;
+	if (wake_latency[tskid].dist[bucket] < UINT16_MAX)
+		wake_latency[tskid].dist[bucket]++;
+}
+
+void task_print_wake_latency(void)
+{
+	int i;
+
+	ccputs("Task Name          Wakeups  Max(us)  p50(us)  p99(us)\n");
+
+	for (i = 0; i < TASK_ID_COUNT; i++) {
+		ccprintf("%4d %-16s %8u %8u %8u %8u\n", i, task_get_name(i),
+			 wake_latency[i].count, wake_latency[i].max,
+			 histogram_percentile(wake_latency[i].dist,
+					      EC_TASK_WAKE_LATENCY_BUCKETS,
+					      wake_latency[i].max, 50),
+			 histogram_percentile(wake_latency[i].dist,
+					      EC_TASK_WAKE_LATENCY_BUCKETS,
+					      wake_latency[i].max, 99));
+		cflush();
+	}
+}
+
+static enum ec_status
+host_command_task_wake_latency(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_task_wake_latency *p = args->params;
+	struct ec_response_task_wake_latency *r = args->response;
+	int i;
+
+	if (p->task_id >= TASK_ID_COUNT)
+		return EC_RES_INVALID_PARAM;
+
+	r->num_tasks = TASK_ID_COUNT;
+	r->wakeups = wake_latency[p->task_id].count;
+	r->max_us = wake_latency[p->task_id].max;
+	memcpy(r->histogram, wake_latency[p->task_id].dist,
+	       sizeof(r->histogram));
+	args->response_size = sizeof(*r);
+
+	if (p->flags & EC_TASK_WAKE_LATENCY_RESET) {
+		for (i = 0; i < TASK_ID_COUNT; i++) {
+			wake_latency[i].count = 0;
+			wake_latency[i].max = 0;
+			memset(wake_latency[i].dist, 0,
+			       sizeof(wake_latency[i].dist));
+		}
+	}
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_TASK_WAKE_LATENCY, host_command_task_wake_latency,
+		     EC_VER_MASK(0));
@@ -6,6 +6,7 @@
 
 ifneq ($(CONFIG_USB_PD_TCPMV2),)
 common-usbc-$(CONFIG_USB_PD_TCPMV2) += usb_pd_timer.o usb_sm.o usbc_task.o
+common-usbc-$(CONFIG_USB_PD_TRACE) += usb_pd_trace.o
 
 # Type-C state machines
 ifneq ($(CONFIG_USB_TYPEC_SM),)
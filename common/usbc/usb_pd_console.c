@@ -14,6 +14,23 @@
 #include "usb_tc_sm.h"
 #include "util.h"
 
+#ifdef CONFIG_USB_SM_STATS
+static void sm_stats_print(const char *name, struct sm_stats *stats,
+			   bool reset)
+{
+	if (reset) {
+		memset(stats, 0, sizeof(*stats));
+		return;
+	}
+
+	ccprintf("%-7s %8u transitions, %8llu us total, %5u us avg, "
+		 "%5u us max\n",
+		 name, stats->transitions, (unsigned long long)stats->total_us,
+		 (uint32_t)(stats->total_us / MAX(stats->transitions, 1)),
+		 stats->max_us);
+}
+#endif
+
 #ifndef TEST_USB_PD_CONSOLE
 static
 #endif
@@ -210,6 +227,53 @@ static
 		pd_srccaps_dump(port);
 	} else if (!strcasecmp(argv[2], "cc")) {
 		ccprintf("Port C%d CC%d\n", port, pd_get_task_cc_state(port));
+	} else if (!strcasecmp(argv[2], "wakeups")) {
+		uint32_t wakeups, timeouts;
+		uint64_t period = pd_task_wakeups_period(port);
+
+		if (argc > 3) {
+			if (strcasecmp(argv[3], "reset"))
+				return EC_ERROR_PARAM3;
+			pd_task_reset_wakeups(port);
+			return EC_SUCCESS;
+		}
+
+		wakeups = pd_task_get_wakeups(port, &timeouts);
+		ccprintf("Port C%d wakeups: %u (%u timeouts) in %llu ms, "
+			 "%u/s\n",
+			 port, wakeups, timeouts,
+			 (unsigned long long)(period / MSEC),
+			 (uint32_t)((uint64_t)wakeups * SECOND /
+				    MAX(period, 1)));
+#ifdef CONFIG_USB_PD_TASK_SHARED
+		{
+			uint32_t avg, max;
+
+			avg = pd_task_get_latency(port, &max);
+			ccprintf("Port C%d latency: avg %u us, max %u us\n",
+				 port, avg, max);
+		}
+#endif
+#ifdef CONFIG_USB_SM_STATS
+	} else if (!strcasecmp(argv[2], "sm")) {
+		struct sm_stats *stats;
+		const char *name;
+		bool reset = false;
+		int i;
+
+		if (argc > 3) {
+			if (strcasecmp(argv[3], "reset"))
+				return EC_ERROR_PARAM3;
+			reset = true;
+		}
+
+		sm_stats_print("TC", tc_get_sm_stats(port), reset);
+		sm_stats_print("PE", pe_get_sm_stats(port), reset);
+		if (IS_ENABLED(CONFIG_USB_PRL_SM))
+			for (i = 0; (stats = prl_get_sm_stats(port, i, &name));
+			     i++)
+				sm_stats_print(name, stats, reset);
+#endif
 #ifdef CONFIG_USB_PD_EPR
 	} else if (!strcasecmp(argv[2], "epr")) {
 		enum pd_dpm_request req;
@@ -254,6 +318,10 @@ DECLARE_CONSOLE_COMMAND(pd, command_pd,
 			"\n\t<port> state"
 			"\n\t<port> srccaps"
 			"\n\t<port> cc"
+			"\n\t<port> wakeups [reset]"
+#ifdef CONFIG_USB_SM_STATS
+			"\n\t<port> sm [reset]"
+#endif
 #ifdef CONFIG_CMD_PD_TIMER
 			"\n\t<port> timer"
 #endif /* CONFIG_CMD_PD_TIMER */
@@ -85,7 +85,12 @@ __overridable const struct svdm_response svdm_rsp = {
 /* Tracker for which task is waiting on sysjump prep to finish */
 static volatile task_id_t sysjump_task_waiting = TASK_ID_INVALID;
 
-#define DPM_SET_FLAG(port, flag) atomic_or(&dpm[(port)].flags, (flag))
+/* Flags set from other tasks wake the PD task of the port to act on them. */
+#define DPM_SET_FLAG(port, flag)                       \
+	do {                                           \
+		atomic_or(&dpm[(port)].flags, (flag)); \
+		pd_task_wake_remote(port);             \
+	} while (0)
 #define DPM_CLR_FLAG(port, flag) atomic_clear_bits(&dpm[(port)].flags, (flag))
 #define DPM_CHK_FLAG(port, flag) (dpm[(port)].flags & (flag))
 
@@ -181,7 +186,7 @@ void pd_prepare_sysjump(void)
 			continue;
 
 		sysjump_task_waiting = task_get_current();
-		task_set_event(PD_PORT_TO_TASK_ID(i), PD_EVENT_SYSJUMP);
+		pd_task_set_event(i, PD_EVENT_SYSJUMP);
 		task_wait_event_mask(TASK_EVENT_SYSJUMP_READY, -1);
 		sysjump_task_waiting = TASK_ID_INVALID;
 	}
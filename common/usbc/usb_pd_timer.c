@@ -45,6 +45,22 @@ test_mockable_static ATOMIC_DEFINE(timer_disabled,
 				   PD_TIMER_COUNT *MAX_PD_PORTS);
 static uint64_t timer_expires[MAX_PD_PORTS][PD_TIMER_COUNT];
 
+/*
+ * The active timers of each port are also kept in a binary min-heap ordered
+ * by expiration time, so that the next timer to expire is always at the root.
+ * Finding the next expiration is O(1), and enabling, disabling or expiring a
+ * timer is O(log n).
+ *
+ * timer_heap[port] holds the active timers in heap order, and
+ * timer_heap_pos[port][timer] is the heap position of a timer plus one (zero
+ * means that the timer is not active). Like the rest of the timer state, the
+ * heap is only updated by the PD task of the port.
+ */
+BUILD_ASSERT(PD_TIMER_COUNT < UINT8_MAX);
+static uint8_t timer_heap[MAX_PD_PORTS][PD_TIMER_COUNT];
+static uint8_t timer_heap_pos[MAX_PD_PORTS][PD_TIMER_COUNT];
+static uint8_t timer_heap_size[MAX_PD_PORTS];
+
 /*
  * CONFIG_CMD_PD_TIMER debug variables
  */
@@ -90,6 +106,94 @@ __maybe_unused static __const_data const char *const pd_timer_names[] = {
 	[TC_TIMER_VBUS_DEBOUNCE] = "TC-VBUS_DEBOUNCE",
 };
 
+/*****************************************************************************
+ * PD_TIMER heap functions
+ */
+
+static inline void pd_timer_heap_set(int port, int pos, int timer)
+{
+	timer_heap[port][pos] = timer;
+	timer_heap_pos[port][timer] = pos + 1;
+}
+
+/* Move the timer at heap position pos towards the root. */
+static void pd_timer_heap_sift_up(int port, int pos)
+{
+	const uint64_t *expires = timer_expires[port];
+	int timer = timer_heap[port][pos];
+
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+
+		if (expires[timer_heap[port][parent]] <= expires[timer])
+			break;
+
+		pd_timer_heap_set(port, pos, timer_heap[port][parent]);
+		pos = parent;
+	}
+	pd_timer_heap_set(port, pos, timer);
+}
+
+/* Move the timer at heap position pos towards the leaves. */
+static void pd_timer_heap_sift_down(int port, int pos)
+{
+	const uint64_t *expires = timer_expires[port];
+	const uint8_t *heap = timer_heap[port];
+	const int size = timer_heap_size[port];
+	int timer = heap[pos];
+
+	while (1) {
+		int child = 2 * pos + 1;
+
+		if (child >= size)
+			break;
+
+		if (child + 1 < size &&
+		    expires[heap[child + 1]] < expires[heap[child]])
+			child++;
+
+		if (expires[timer] <= expires[heap[child]])
+			break;
+
+		pd_timer_heap_set(port, pos, heap[child]);
+		pos = child;
+	}
+	pd_timer_heap_set(port, pos, timer);
+}
+
+/* Insert a timer in the heap, or move it after its expiration changed. */
+static void pd_timer_heap_update(int port, enum pd_task_timer timer)
+{
+	int pos = timer_heap_pos[port][timer] - 1;
+
+	if (pos < 0) {
+		pos = timer_heap_size[port]++;
+		pd_timer_heap_set(port, pos, timer);
+	}
+
+	pd_timer_heap_sift_up(port, pos);
+	pd_timer_heap_sift_down(port, timer_heap_pos[port][timer] - 1);
+}
+
+/* Remove a timer from the heap, if present. */
+static void pd_timer_heap_remove(int port, enum pd_task_timer timer)
+{
+	int pos = timer_heap_pos[port][timer] - 1;
+	int last;
+
+	if (pos < 0)
+		return;
+
+	timer_heap_pos[port][timer] = 0;
+	last = timer_heap[port][--timer_heap_size[port]];
+	if (pos == timer_heap_size[port])
+		return;
+
+	pd_timer_heap_set(port, pos, last);
+	pd_timer_heap_sift_up(port, pos);
+	pd_timer_heap_sift_down(port, timer_heap_pos[port][last] - 1);
+}
+
 /*****************************************************************************
  * PD_TIMER private functions
  *
@@ -105,6 +209,7 @@ static void pd_timer_inactive(int port, enum pd_task_timer timer)
 {
 	if (PD_CHK_ACTIVE(port, timer)) {
 		PD_CLR_ACTIVE(port, timer);
+		pd_timer_heap_remove(port, timer);
 
 		if (IS_ENABLED(CONFIG_CMD_PD_TIMER))
 			count[port]--;
@@ -136,7 +241,9 @@ void pd_timer_init(int port)
 	for (int bit = 0; bit < PD_TIMER_COUNT; bit++) {
 		PD_CLR_ACTIVE(port, bit);
 		PD_SET_DISABLED(port, bit);
+		timer_heap_pos[port][bit] = 0;
 	}
+	timer_heap_size[port] = 0;
 }
 
 void pd_timer_enable(int port, enum pd_task_timer timer, uint32_t expires_us)
@@ -152,12 +259,14 @@ void pd_timer_enable(int port, enum pd_task_timer timer, uint32_t expires_us)
 	}
 	PD_CLR_DISABLED(port, timer);
 	timer_expires[port][timer] = get_time().val + expires_us;
+	pd_timer_heap_update(port, timer);
 }
 
 void pd_timer_disable(int port, enum pd_task_timer timer)
 {
 	if (PD_CHK_ACTIVE(port, timer)) {
 		PD_CLR_ACTIVE(port, timer);
+		pd_timer_heap_remove(port, timer);
 
 		if (IS_ENABLED(CONFIG_CMD_PD_TIMER))
 			count[port]--;
@@ -214,41 +323,36 @@ bool pd_timer_is_expired(int port, enum pd_task_timer timer)
 
 void pd_timer_manage_expired(int port)
 {
-	int timer;
+	uint64_t now = get_time().val;
 
-	for (timer = 0; timer < PD_TIMER_COUNT; ++timer)
-		if (pd_timer_is_active(port, timer) &&
-		    pd_timer_is_expired(port, timer))
-			pd_timer_inactive(port, timer);
+	/* Expired timers are all at the top of the heap. */
+	while (timer_heap_size[port] > 0) {
+		int timer = timer_heap[port][0];
+
+		if (timer_expires[port][timer] > now)
+			break;
+
+		pd_timer_inactive(port, timer);
+	}
 }
 
 int pd_timer_next_expiration(int port)
 {
-	int timer;
-	int ret_value = MAX_EXPIRE;
-	uint64_t now = get_time().val;
+	uint64_t now, t_value;
 
-	for (timer = 0; timer < PD_TIMER_COUNT; ++timer) {
-		/* Only use active timers for the next expired value */
-		if (pd_timer_is_active(port, timer)) {
-			int delta;
-			uint64_t t_value = timer_expires[port][timer];
-
-			if (t_value <= now) {
-				ret_value = EXPIRE_NOW;
-				break;
-			}
-
-			delta = t_value - now;
-			if (ret_value > delta)
-				ret_value = delta;
-		}
-	}
+	/* Only active timers are in the heap */
+	if (timer_heap_size[port] == 0)
+		return NO_TIMEOUT;
+
+	now = get_time().val;
+	t_value = timer_expires[port][timer_heap[port][0]];
 
-	if (ret_value == MAX_EXPIRE)
-		ret_value = NO_TIMEOUT;
+	if (t_value <= now)
+		return EXPIRE_NOW;
+	if (t_value - now >= MAX_EXPIRE)
+		return NO_TIMEOUT;
 
-	return ret_value;
+	return t_value - now;
 }
 
 #ifdef CONFIG_CMD_PD_TIMER
@@ -0,0 +1,125 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* USB Power Delivery message trace */
+
+#include "common.h"
+#include "host_command.h"
+#include "task.h"
+#include "timer.h"
+#include "usb_pd_trace.h"
+#include "usb_pe_sm.h"
+#include "usb_tc_sm.h"
+#include "util.h"
+
+#define TRACE_MASK (CONFIG_USB_PD_TRACE_ENTRIES - 1)
+
+BUILD_ASSERT(POWER_OF_TWO(CONFIG_USB_PD_TRACE_ENTRIES));
+
+static struct ec_pd_trace_entry trace[CONFIG_USB_PD_PORT_MAX_COUNT]
+				     [CONFIG_USB_PD_TRACE_ENTRIES];
+
+/* Sequence number of the next entry, stored at (seq & TRACE_MASK) */
+static uint32_t trace_next_seq[CONFIG_USB_PD_PORT_MAX_COUNT];
+
+/* Sequence number of the first entry kept after a reset */
+static uint32_t trace_first_seq[CONFIG_USB_PD_PORT_MAX_COUNT];
+
+void pd_trace(int port, enum ec_pd_trace_type type, uint8_t sop,
+	      uint16_t data)
+{
+	const uint32_t now = get_time().le.lo;
+	struct ec_pd_trace_entry *entry;
+	uint32_t key;
+
+	if (port < 0 || port >= CONFIG_USB_PD_PORT_MAX_COUNT)
+		return;
+
+	key = irq_lock();
+	entry = &trace[port][trace_next_seq[port]++ & TRACE_MASK];
+	entry->time_us = now;
+	entry->type = type;
+	entry->sop = sop;
+	entry->data = data;
+	irq_unlock(key);
+}
+
+static enum ec_status pd_trace_state_name(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_pd_trace *p = args->params;
+	struct ec_response_pd_trace_state_name *r = args->response;
+	const char *name = NULL;
+
+	/* Only the DRP state machines record their transitions */
+	if (!IS_ENABLED(CONFIG_USB_DRP_ACC_TRYSRC))
+		return EC_RES_INVALID_PARAM;
+
+	if (p->action == EC_PD_TRACE_PE_STATE_NAME)
+		name = pe_get_state_name(p->seq);
+	else
+		name = tc_get_state_name(p->seq);
+	if (name == NULL)
+		return EC_RES_INVALID_PARAM;
+
+	strzcpy(r->name, name, sizeof(r->name));
+	args->response_size = sizeof(*r);
+
+	return EC_RES_SUCCESS;
+}
+
+static enum ec_status pd_trace_host_cmd(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_pd_trace *p = args->params;
+	struct ec_response_pd_trace *r = args->response;
+	uint32_t first, seq;
+	uint32_t key;
+	int max_entries;
+	int i;
+
+	if (p->port >= CONFIG_USB_PD_PORT_MAX_COUNT)
+		return EC_RES_INVALID_PARAM;
+
+	switch (p->action) {
+	case EC_PD_TRACE_GET:
+		break;
+	case EC_PD_TRACE_RESET:
+		key = irq_lock();
+		trace_first_seq[p->port] = trace_next_seq[p->port];
+		irq_unlock(key);
+		return EC_RES_SUCCESS;
+	case EC_PD_TRACE_PE_STATE_NAME:
+	case EC_PD_TRACE_TC_STATE_NAME:
+		return pd_trace_state_name(args);
+	default:
+		return EC_RES_INVALID_PARAM;
+	}
+
+	if (args->response_max < sizeof(*r))
+		return EC_RES_RESPONSE_TOO_BIG;
+
+	max_entries = (args->response_max - sizeof(*r)) / sizeof(r->entries[0]);
+
+	key = irq_lock();
+	r->next_seq = trace_next_seq[p->port];
+
+	/* Start at the oldest entry not overwritten yet, if it is later */
+	first = trace_first_seq[p->port];
+	if (r->next_seq - first > CONFIG_USB_PD_TRACE_ENTRIES)
+		first = r->next_seq - CONFIG_USB_PD_TRACE_ENTRIES;
+	seq = p->seq;
+	if ((int32_t)(seq - first) < 0 || (int32_t)(r->next_seq - seq) < 0)
+		seq = first;
+	r->seq = seq;
+
+	for (i = 0; i < max_entries && seq != r->next_seq; i++, seq++)
+		r->entries[i] = trace[p->port][seq & TRACE_MASK];
+	irq_unlock(key);
+	r->count = i;
+
+	args->response_size = sizeof(*r) + i * sizeof(r->entries[0]);
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_PD_TRACE, pd_trace_host_cmd, EC_VER_MASK(0));
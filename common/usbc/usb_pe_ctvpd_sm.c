@@ -46,10 +46,8 @@ static void set_state_pe(const int port, enum usb_pe_state new_state)
 
 static void pe_init(int port)
 {
-	const struct sm_ctx cleared = {};
-
 	pe[port].flags = 0;
-	pe[port].ctx = cleared;
+	reset_sm_ctx(&pe[port].ctx);
 	set_state_pe(port, PE_REQUEST);
 }
 
@@ -90,7 +88,7 @@ void pe_run(int port, int evt, int en)
 void pe_message_received(int port)
 {
 	pe[port].flags |= PE_FLAGS_MSG_RECEIVED;
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 /**
@@ -130,6 +128,13 @@ void pe_message_sent(int port)
 	/* No implementation needed by this policy engine */
 }
 
+#ifdef CONFIG_USB_SM_STATS
+struct sm_stats *pe_get_sm_stats(int port)
+{
+	return &pe[port].ctx.stats;
+}
+#endif
+
 static void pe_request_run(const int port)
 {
 	uint32_t *payload = (uint32_t *)tx_emsg[port].buf;
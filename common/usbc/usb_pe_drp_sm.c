@@ -38,6 +38,7 @@
 #include "usb_pd_policy.h"
 #include "usb_pd_tcpm.h"
 #include "usb_pd_timer.h"
+#include "usb_pd_trace.h"
 #include "usb_pe_private.h"
 #include "usb_pe_sm.h"
 #include "usb_prl_sm.h"
@@ -920,7 +921,7 @@ void pe_message_received(int port)
 	assert(port == TASK_ID_TO_PD_PORT(task_get_current()));
 
 	PE_SET_FLAG(port, PE_FLAGS_MSG_RECEIVED);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void pe_hard_reset_sent(int port)
@@ -979,7 +980,7 @@ test_mockable void pd_got_frs_signal(int port)
 	else
 		pd_set_error_recovery(port);
 
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 #endif /* CONFIG_USB_PD_REV30 */
 
@@ -1317,7 +1318,7 @@ void pe_report_error(int port, enum pe_error e, enum tcpci_msg_type type)
 	    (pe_in_frs_mode(port) &&
 	     get_state_pe(port) == PE_PRS_SNK_SRC_SEND_SWAP)) {
 		PE_SET_FLAG(port, PE_FLAGS_PROTOCOL_ERROR);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 		return;
 	}
 
@@ -1430,6 +1431,12 @@ void pd_resume_check_pr_swap_needed(int port)
 void pd_dpm_request(int port, enum pd_dpm_request req)
 {
 	PE_SET_DPM_REQUEST(port, req);
+
+	/*
+	 * Requests usually come from other tasks, and a tickless PD task
+	 * wouldn't notice them until its next event.
+	 */
+	pd_task_wake(port);
 }
 
 void pe_vconn_swap_complete(int port)
@@ -1454,7 +1461,7 @@ void pe_message_sent(int port)
 	assert(port == TASK_ID_TO_PD_PORT(task_get_current()));
 
 	PE_SET_FLAG(port, PE_FLAGS_TX_COMPLETE);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void pd_send_vdm(int port, uint32_t vid, int cmd, const uint32_t *data,
@@ -1483,8 +1490,6 @@ void pd_send_vdm(int port, uint32_t vid, int cmd, const uint32_t *data,
 	 */
 	pe[port].tx_type = TCPCI_MSG_SOP;
 	pd_dpm_request(port, DPM_REQUEST_VDM);
-
-	task_wake(PD_PORT_TO_TASK_ID(port));
 }
 
 #ifdef TEST_BUILD
@@ -1568,6 +1573,13 @@ void pe_clear_ado(int port)
 	mutex_unlock(&pe[port].ado_lock);
 }
 
+#ifdef CONFIG_USB_SM_STATS
+struct sm_stats *pe_get_sm_stats(int port)
+{
+	return &pe[port].ctx.stats;
+}
+#endif
+
 struct rmdo pd_get_partner_rmdo(int port)
 {
 	return pe[port].partner_rmdo;
@@ -1623,6 +1635,7 @@ static void pe_set_dpm_curr_request(const int port, const int request)
 test_export_static void set_state_pe(const int port,
 				     const enum usb_pe_state new_state)
 {
+	pd_trace(port, EC_PD_TRACE_PE_STATE, 0, new_state);
 	set_state(port, &pe[port].ctx, &pe_states[new_state]);
 }
 
@@ -8415,6 +8428,14 @@ const char *pe_get_current_state(int port)
 		return "";
 }
 
+const char *pe_get_state_name(int state)
+{
+	if (!IS_ENABLED(USB_PD_DEBUG_LABELS) || state < 0 ||
+	    state >= ARRAY_SIZE(pe_state_names))
+		return NULL;
+	return pe_state_names[state];
+}
+
 uint32_t pe_get_flags(int port)
 {
 	/*
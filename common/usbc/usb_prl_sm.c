@@ -26,6 +26,7 @@
 #include "usb_mux.h"
 #include "usb_pd.h"
 #include "usb_pd_timer.h"
+#include "usb_pd_trace.h"
 #include "usb_pe_sm.h"
 #include "usb_prl_sm.h"
 #include "usb_sm.h"
@@ -543,6 +544,11 @@ void pd_transmit_complete(int port, int status)
 	if (status == TCPC_TX_COMPLETE_SUCCESS)
 		set_tcpc_tx_success_ts(port);
 	prl_tx[port].xmit_status = status;
+
+	/* The trace status follows the same order as the TCPC one */
+	if (status >= TCPC_TX_COMPLETE_SUCCESS)
+		pd_trace(port, EC_PD_TRACE_TX_STATUS, pdmsg[port].xmit_type,
+			 status - TCPC_TX_COMPLETE_SUCCESS);
 }
 
 void pd_execute_hard_reset(int port)
@@ -553,7 +559,7 @@ void pd_execute_hard_reset(int port)
 
 	PRL_HR_SET_FLAG(port, PRL_FLAGS_PORT_PARTNER_HARD_RESET);
 	set_state_prl_hr(port, PRL_HR_RESET_LAYER);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void prl_execute_hard_reset(int port)
@@ -564,7 +570,7 @@ void prl_execute_hard_reset(int port)
 
 	PRL_HR_SET_FLAG(port, PRL_FLAGS_PE_HARD_RESET);
 	set_state_prl_hr(port, PRL_HR_RESET_LAYER);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void prl_set_data_role_check(int port, bool enable)
@@ -575,6 +581,28 @@ void prl_set_data_role_check(int port, bool enable)
 		RCH_SET_FLAG(port, PRL_FLAGS_IGNORE_DATA_ROLE);
 }
 
+#ifdef CONFIG_USB_SM_STATS
+struct sm_stats *prl_get_sm_stats(int port, int sm, const char **name)
+{
+	struct sm_ctx *ctx[] = {
+		&prl_tx[port].ctx,
+		&prl_hr[port].ctx,
+		&rch[port].ctx,
+		&tch[port].ctx,
+	};
+	static const char *const names[] = { "PRL_TX", "PRL_HR", "RCH", "TCH" };
+	/* The chunking state machines only run with extended messages */
+	int count = IS_ENABLED(CONFIG_USB_PD_EXTENDED_MESSAGES) ?
+			    ARRAY_SIZE(ctx) :
+			    2;
+
+	if (sm < 0 || sm >= count)
+		return NULL;
+	*name = names[sm];
+	return &ctx[sm]->stats;
+}
+#endif
+
 int prl_is_running(int port)
 {
 	return local_state[port] == SM_RUN;
@@ -583,7 +611,6 @@ int prl_is_running(int port)
 static void prl_init(int port)
 {
 	int i;
-	const struct sm_ctx cleared = {};
 
 	/*
 	 * flags without PRL_FLAGS_SINK_NG present means we are initially
@@ -610,18 +637,18 @@ static void prl_init(int port)
 	pd_timer_disable_range(port, PR_TIMER_RANGE);
 
 	/* Clear state machines and set initial states */
-	prl_tx[port].ctx = cleared;
+	reset_sm_ctx(&prl_tx[port].ctx);
 	set_state_prl_tx(port, PRL_TX_PHY_LAYER_RESET);
 
 	if (IS_ENABLED(CONFIG_USB_PD_EXTENDED_MESSAGES)) {
-		rch[port].ctx = cleared;
+		reset_sm_ctx(&rch[port].ctx);
 		set_state_rch(port, RCH_WAIT_FOR_MESSAGE_FROM_PROTOCOL_LAYER);
 
-		tch[port].ctx = cleared;
+		reset_sm_ctx(&tch[port].ctx);
 		set_state_tch(port, TCH_WAIT_FOR_MESSAGE_REQUEST_FROM_PE);
 	}
 
-	prl_hr[port].ctx = cleared;
+	reset_sm_ctx(&prl_hr[port].ctx);
 	set_state_prl_hr(port, PRL_HR_WAIT_FOR_REQUEST);
 }
 
@@ -646,7 +673,7 @@ void prl_set_debug_level(enum debug_level debug_level)
 void prl_hard_reset_complete(int port)
 {
 	PRL_HR_SET_FLAG(port, PRL_FLAGS_HARD_RESET_COMPLETE);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void prl_send_ctrl_msg(int port, enum tcpci_msg_type type,
@@ -656,6 +683,7 @@ void prl_send_ctrl_msg(int port, enum tcpci_msg_type type,
 	pdmsg[port].msg_type = msg;
 	pdmsg[port].data_objs = 0;
 	tx_emsg[port].len = 0;
+	pd_trace(port, EC_PD_TRACE_TX_REQUEST, type, msg);
 
 #ifdef CONFIG_USB_PD_EXTENDED_MESSAGES
 	pdmsg[port].ext = 0;
@@ -665,7 +693,7 @@ void prl_send_ctrl_msg(int port, enum tcpci_msg_type type,
 	PRL_TX_SET_FLAG(port, PRL_FLAGS_MSG_XMIT);
 #endif /* CONFIG_USB_PD_EXTENDED_MESSAGES */
 
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void prl_send_data_msg(int port, enum tcpci_msg_type type,
@@ -673,6 +701,8 @@ void prl_send_data_msg(int port, enum tcpci_msg_type type,
 {
 	pdmsg[port].xmit_type = type;
 	pdmsg[port].msg_type = msg;
+	pd_trace(port, EC_PD_TRACE_TX_REQUEST, type,
+		 msg | EC_PD_TRACE_REQ_DATA);
 
 #ifdef CONFIG_USB_PD_EXTENDED_MESSAGES
 	pdmsg[port].ext = 0;
@@ -683,7 +713,7 @@ void prl_send_data_msg(int port, enum tcpci_msg_type type,
 	PRL_TX_SET_FLAG(port, PRL_FLAGS_MSG_XMIT);
 #endif /* CONFIG_USB_PD_EXTENDED_MESSAGES */
 
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 #ifdef CONFIG_USB_PD_EXTENDED_MESSAGES
@@ -693,9 +723,10 @@ void prl_send_ext_data_msg(int port, enum tcpci_msg_type type,
 	pdmsg[port].xmit_type = type;
 	pdmsg[port].msg_type = msg;
 	pdmsg[port].ext = 1;
+	pd_trace(port, EC_PD_TRACE_TX_REQUEST, type, msg | EC_PD_TRACE_REQ_EXT);
 
 	TCH_SET_FLAG(port, PRL_FLAGS_MSG_XMIT);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 #endif /* CONFIG_USB_PD_EXTENDED_MESSAGES */
 
@@ -719,7 +750,7 @@ void prl_reset_soft(int port)
 	local_state[port] = SM_INIT;
 
 	/* Ensure we process the reset quickly */
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void prl_run(int port, int evt, int en)
@@ -1092,6 +1123,23 @@ static uint32_t get_sop_star_header(const int port)
 			 pdmsg[port].rev[pdmsg[port].xmit_type], ext);
 }
 
+/* Trace the VDM header of a Vendor_Defined message */
+static void prl_trace_vdm(const int port, uint32_t header,
+			  const uint32_t *payload)
+{
+	uint8_t cmd;
+
+	if (!IS_ENABLED(CONFIG_USB_PD_TRACE) || !PD_HEADER_CNT(header) ||
+	    PD_HEADER_EXT(header) ||
+	    PD_HEADER_TYPE(header) != PD_DATA_VENDOR_DEF)
+		return;
+
+	cmd = payload[0] & 0xff;
+	if (!PD_VDO_SVDM(payload[0]))
+		cmd |= EC_PD_TRACE_VDM_UNSTRUCTURED;
+	pd_trace(port, EC_PD_TRACE_VDM, cmd, PD_VDO_VID(payload[0]));
+}
+
 static void prl_tx_construct_message(const int port)
 {
 	/* The header is unused for hard reset, etc. */
@@ -1119,6 +1167,8 @@ static void prl_tx_construct_message(const int port)
 	 * should not retry those messages. We do not support that and probably
 	 * never will (since we support chunking).
 	 */
+	pd_trace(port, EC_PD_TRACE_TX_START, pdmsg[port].xmit_type, header);
+	prl_trace_vdm(port, header, pdmsg[port].tx_chk_buf);
 	tcpm_transmit(port, pdmsg[port].xmit_type, header,
 		      pdmsg[port].tx_chk_buf);
 }
@@ -1149,6 +1199,9 @@ static void prl_tx_wait_for_phy_response_run(const int port)
 		/* Increment messageId counter */
 		increment_msgid_counter(port);
 
+		pd_trace(port, EC_PD_TRACE_TX_COMPLETE,
+			 prl_tx[port].last_xmit_type, EC_PD_TRACE_TX_SUCCESS);
+
 		/* Inform Policy Engine Message was sent */
 		if (IS_ENABLED(CONFIG_USB_PD_EXTENDED_MESSAGES))
 			PDMSG_SET_FLAG(port, PRL_FLAGS_TX_COMPLETE);
@@ -1159,7 +1212,7 @@ static void prl_tx_wait_for_phy_response_run(const int port)
 		 * This event reduces the time of informing the policy engine of
 		 * the transmission by one state machine cycle
 		 */
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 		set_state_prl_tx(port, PRL_TX_WAIT_FOR_MESSAGE_REQUEST);
 	} else if (pd_timer_is_expired(port, PR_TIMER_TCPC_TX_TIMEOUT) ||
 		   prl_tx[port].xmit_status == TCPC_TX_COMPLETE_FAILED) {
@@ -1167,6 +1220,8 @@ static void prl_tx_wait_for_phy_response_run(const int port)
 		 * NOTE: PRL_Tx_Transmission_Error State embedded
 		 * here.
 		 */
+		pd_trace(port, EC_PD_TRACE_TX_COMPLETE,
+			 prl_tx[port].last_xmit_type, EC_PD_TRACE_TX_FAILED);
 
 		if (IS_ENABLED(CONFIG_USB_PD_EXTENDED_MESSAGES)) {
 			/*
@@ -1309,6 +1364,7 @@ void prl_hr_send_msg_to_phy(const int port)
 	PDMSG_CLR_FLAG(port, PRL_FLAGS_TX_COMPLETE);
 
 	/* Pass message to PHY Layer */
+	pd_trace(port, EC_PD_TRACE_TX_START, pdmsg[port].xmit_type, header);
 	tcpm_transmit(port, pdmsg[port].xmit_type, header,
 		      pdmsg[port].tx_chk_buf);
 }
@@ -1676,7 +1732,7 @@ static void rch_requesting_chunk_entry(const int port)
 	pdmsg[port].ext = 1;
 	pdmsg[port].xmit_type = prl_rx[port].sop;
 	PRL_TX_SET_FLAG(port, PRL_FLAGS_MSG_XMIT);
-	task_set_event(PD_PORT_TO_TASK_ID(port), PD_EVENT_TX);
+	pd_task_set_event(port, PD_EVENT_TX);
 }
 
 static void rch_requesting_chunk_run(const int port)
@@ -2187,6 +2243,8 @@ static void prl_rx_wait_for_phy_message(const int port, int evt)
 	cnt = PD_HEADER_CNT(header);
 	msid = PD_HEADER_ID(header);
 	prl_rx[port].sop = PD_HEADER_GET_SOP(header);
+	pd_trace(port, EC_PD_TRACE_RX, prl_rx[port].sop, header);
+	prl_trace_vdm(port, header, pdmsg[port].rx_chk_buf);
 
 	/* Make sure an incorrect count doesn't overflow the chunk buffer */
 	if (cnt > CHK_BUF_SIZE)
@@ -2332,7 +2390,7 @@ static void prl_rx_wait_for_phy_message(const int port, int evt)
 		pe_message_received(port);
 	}
 
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 /* All necessary Protocol Transmit States (Section 6.11.2.2) */
@@ -13,6 +13,7 @@
 #include "console.h"
 #include "stdbool.h"
 #include "task.h"
+#include "timer.h"
 #include "usb_pd.h"
 #include "usb_sm.h"
 #include "util.h"
@@ -35,34 +36,42 @@ struct internal_ctx {
 BUILD_ASSERT(sizeof(struct internal_ctx) ==
 	     member_size(struct sm_ctx, internal));
 
+/* Gets the number of states from s to its root state (inclusive) */
+static int state_depth(usb_state_ptr s)
+{
+	int depth = 0;
+
+	while (s != NULL) {
+		depth++;
+		s = s->parent;
+	}
+
+	return depth;
+}
+
 /* Gets the first shared parent state between a and b (inclusive) */
 static usb_state_ptr shared_parent_state(usb_state_ptr a, usb_state_ptr b)
 {
-	const usb_state_ptr orig_b = b;
-
-	/* There are no common ancestors */
-	if (b == NULL)
-		return NULL;
-
-	/* This assumes that both A and B are NULL terminated without cycles */
-	while (a != NULL) {
-		/* We found a match return */
-		if (a == b)
-			return a;
-
-		/*
-		 * Otherwise, increment b down the list for comparison until we
-		 * run out, then increment a and start over on b for comparison
-		 */
-		if (b->parent == NULL) {
-			a = a->parent;
-			b = orig_b;
-		} else {
-			b = b->parent;
-		}
+	int depth_a = state_depth(a);
+	int depth_b = state_depth(b);
+
+	/*
+	 * This assumes that both A and B are NULL terminated without cycles.
+	 * Bring the deeper state up to the depth of the other one, then walk
+	 * up both chains together until they meet, or run out when there are
+	 * no common ancestors.
+	 */
+	for (; depth_a > depth_b; depth_a--)
+		a = a->parent;
+	for (; depth_b > depth_a; depth_b--)
+		b = b->parent;
+
+	while (a != b) {
+		a = a->parent;
+		b = b->parent;
 	}
 
-	return NULL;
+	return a;
 }
 
 /*
@@ -115,6 +124,10 @@ void set_state(const int port, struct sm_ctx *const ctx,
 	struct internal_ctx *const internal = (void *)ctx->internal;
 	usb_state_ptr last_state;
 	usb_state_ptr shared_parent;
+#ifdef CONFIG_USB_SM_STATS
+	const timestamp_t start = get_time();
+	uint32_t elapsed;
+#endif
 
 	/*
 	 * It does not make sense to call set_state in an exit phase of a state
@@ -167,13 +180,22 @@ void set_state(const int port, struct sm_ctx *const ctx,
 	 */
 	internal->running = false;
 
+#ifdef CONFIG_USB_SM_STATS
+	/* Nested transitions are also included in the outer one's time */
+	elapsed = time_since32(start);
+	ctx->stats.transitions++;
+	ctx->stats.total_us += elapsed;
+	if (elapsed > ctx->stats.max_us)
+		ctx->stats.max_us = elapsed;
+#endif
+
 	/*
 	 * Since we are changing states, we want to ensure that we process the
 	 * next state's run method as soon as we can to ensure that we don't
 	 * delay important processing until the next task interval.
 	 */
 	if (IS_ENABLED(HAS_TASK_PD_C0))
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 }
 
 /*
@@ -206,3 +228,10 @@ void run_state(const int port, struct sm_ctx *const ctx)
 	call_run_functions(port, internal, ctx->current);
 	internal->running = false;
 }
+
+void reset_sm_ctx(struct sm_ctx *const ctx)
+{
+	ctx->current = NULL;
+	ctx->previous = NULL;
+	memset(ctx->internal, 0, sizeof(ctx->internal));
+}
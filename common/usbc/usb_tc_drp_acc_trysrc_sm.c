@@ -20,6 +20,7 @@
 #include "usb_pd_dpm_sm.h"
 #include "usb_pd_tcpm.h"
 #include "usb_pd_timer.h"
+#include "usb_pd_trace.h"
 #include "usb_pe_sm.h"
 #include "usb_prl_sm.h"
 #include "usb_sm.h"
@@ -64,12 +65,14 @@
  */
 #undef DEBUG_PRINT_FLAG_AND_EVENT_NAMES
 
+/* Flags set from other tasks wake the PD task of the port to act on them. */
 #ifdef DEBUG_PRINT_FLAG_AND_EVENT_NAMES
 void print_flag(int port, int set_or_clear, int flag);
 #define TC_SET_FLAG(port, flag)                     \
 	do {                                        \
 		print_flag(port, 1, flag);          \
 		atomic_or(&tc[port].flags, (flag)); \
+		pd_task_wake_remote(port);          \
 	} while (0)
 #define TC_CLR_FLAG(port, flag)                             \
 	do {                                                \
@@ -77,7 +80,11 @@ void print_flag(int port, int set_or_clear, int flag);
 		atomic_clear_bits(&tc[port].flags, (flag)); \
 	} while (0)
 #else
-#define TC_SET_FLAG(port, flag) atomic_or(&tc[port].flags, (flag))
+#define TC_SET_FLAG(port, flag)                     \
+	do {                                        \
+		atomic_or(&tc[port].flags, (flag)); \
+		pd_task_wake_remote(port);          \
+	} while (0)
 #define TC_CLR_FLAG(port, flag) atomic_clear_bits(&tc[port].flags, (flag))
 #endif
 #define TC_CHK_FLAG(port, flag) (tc[port].flags & (flag))
@@ -580,7 +587,7 @@ void pd_request_source_voltage(int port, int mv)
 		else
 			pd_dpm_request(port, DPM_REQUEST_PR_SWAP);
 
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -593,7 +600,7 @@ void pd_set_external_voltage_limit(int port, int mv)
 		if (get_state_tc(port) == TC_ATTACHED_SNK)
 			pd_dpm_request(port, DPM_REQUEST_NEW_POWER_LEVEL);
 
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -756,7 +763,7 @@ static inline void pd_set_dual_role_and_event(int port,
 		pd_update_try_source();
 
 	if (event != 0)
-		task_set_event(PD_PORT_TO_TASK_ID(port), event);
+		pd_task_set_event(port, event);
 }
 
 void pd_set_dual_role(int port, enum pd_dual_role_states state)
@@ -778,7 +785,7 @@ void pd_request_data_swap(int port)
 	 */
 	if (IS_ATTACHED_SRC(port) || IS_ATTACHED_SNK(port)) {
 		TC_SET_FLAG(port, TC_FLAGS_REQUEST_DR_SWAP);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -801,6 +808,13 @@ const char *tc_get_current_state(int port)
 		return "";
 }
 
+const char *tc_get_state_name(int state)
+{
+	if (state < 0 || state >= ARRAY_SIZE(tc_state_names))
+		return NULL;
+	return tc_state_names[state];
+}
+
 uint32_t tc_get_flags(int port)
 {
 	return tc[port].flags;
@@ -924,7 +938,7 @@ void tc_prs_src_snk_assert_rd(int port)
 		 * DebugAccessory.SNK assert Rd
 		 */
 		TC_SET_FLAG(port, TC_FLAGS_REQUEST_PR_SWAP);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -940,7 +954,7 @@ void tc_prs_snk_src_assert_rp(int port)
 		 * UnorientedDebugAccessory.SRC to assert Rp
 		 */
 		TC_SET_FLAG(port, TC_FLAGS_REQUEST_PR_SWAP);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -961,7 +975,7 @@ void tc_prs_snk_src_assert_rp(int port)
 void tc_hard_reset_request(int port)
 {
 	TC_SET_FLAG(port, TC_FLAGS_HARD_RESET_REQUESTED);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void tc_try_src_override(enum try_src_override_t ov)
@@ -1076,7 +1090,7 @@ void pd_set_suspend(int port, int suspend)
 		if (PD_PORT_TO_TASK_ID(port) == task_get_current())
 			return;
 
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 
 		/* Sleep this task if we are not suspended */
 		while (pd_is_port_enabled(port)) {
@@ -1089,7 +1103,7 @@ void pd_set_suspend(int port, int suspend)
 		}
 	} else {
 		TC_CLR_FLAG(port, TC_FLAGS_REQUEST_SUSPEND);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -1655,6 +1669,13 @@ uint8_t tc_get_pd_enabled(int port)
 	return !tc[port].pd_disabled_mask;
 }
 
+#ifdef CONFIG_USB_SM_STATS
+struct sm_stats *tc_get_sm_stats(int port)
+{
+	return &tc[port].ctx.stats;
+}
+#endif
+
 bool pd_alt_mode_capable(int port)
 {
 	return IS_ENABLED(CONFIG_USB_PE_SM) && tc_get_pd_enabled(port);
@@ -1685,6 +1706,7 @@ static void set_state_tc(const int port, const enum usb_tc_state new_state)
 {
 	assert(port == TASK_ID_TO_PD_PORT(task_get_current()));
 
+	pd_trace(port, EC_PD_TRACE_TC_STATE, 0, new_state);
 	set_state(port, &tc[port].ctx, &tc_states[new_state]);
 }
 
@@ -1924,7 +1946,7 @@ void pd_request_vconn_swap_off(int port)
 	if (get_state_tc(port) == TC_ATTACHED_SRC ||
 	    get_state_tc(port) == TC_ATTACHED_SNK) {
 		TC_SET_FLAG(port, TC_FLAGS_REQUEST_VC_SWAP_OFF);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 
@@ -1933,7 +1955,7 @@ void pd_request_vconn_swap_on(int port)
 	if (get_state_tc(port) == TC_ATTACHED_SRC ||
 	    get_state_tc(port) == TC_ATTACHED_SNK) {
 		TC_SET_FLAG(port, TC_FLAGS_REQUEST_VC_SWAP_ON);
-		task_wake(PD_PORT_TO_TASK_ID(port));
+		pd_task_wake(port);
 	}
 }
 #endif
@@ -1952,7 +1974,7 @@ static __maybe_unused int reset_device_and_notify(int port)
 	int task, waiting_tasks;
 
 	/* This should only be called from the PD task */
-	assert(port == TASK_ID_TO_PD_PORT(task_get_current()));
+	assert(task_get_current() == PD_PORT_TO_TASK_ID(port));
 
 	TC_SET_FLAG(port, TC_FLAGS_LPM_TRANSITION);
 	rv = tcpm_init(port);
@@ -1973,8 +1995,7 @@ static __maybe_unused int reset_device_and_notify(int port)
 	 * waking the TCPC, but it has also set PD_EVENT_TCPC_RESET again, which
 	 * would result in a second, unnecessary init.
 	 */
-	atomic_clear_bits(task_get_event_bitmap(task_get_current()),
-			  PD_EVENT_TCPC_RESET);
+	pd_task_clear_event(port, PD_EVENT_TCPC_RESET);
 
 	waiting_tasks = atomic_clear(&tc[port].tasks_waiting_on_reset);
 
@@ -1994,7 +2015,7 @@ void pd_wait_exit_low_power(int port)
 	if (!TC_CHK_FLAG(port, TC_FLAGS_LPM_ENGAGED))
 		return;
 
-	if (port == TASK_ID_TO_PD_PORT(task_get_current())) {
+	if (task_get_current() == PD_PORT_TO_TASK_ID(port)) {
 		if (!TC_CHK_FLAG(port, TC_FLAGS_LPM_TRANSITION))
 			reset_device_and_notify(port);
 	} else {
@@ -2009,7 +2030,7 @@ void pd_wait_exit_low_power(int port)
 		 * happen much, but it if starts occurring, we can add a guard
 		 * to prevent/reduce it.
 		 */
-		task_set_event(PD_PORT_TO_TASK_ID(port), PD_EVENT_TCPC_RESET);
+		pd_task_set_event(port, PD_EVENT_TCPC_RESET);
 		task_wait_event_mask(TASK_EVENT_PD_AWAKE, -1);
 	}
 }
@@ -2023,8 +2044,7 @@ void pd_device_accessed(int port)
 	if (port == TASK_ID_TO_PD_PORT(task_get_current()))
 		handle_device_access(port);
 	else
-		task_set_event(PD_PORT_TO_TASK_ID(port),
-			       PD_EVENT_DEVICE_ACCESSED);
+		pd_task_set_event(port, PD_EVENT_DEVICE_ACCESSED);
 }
 
 /*
@@ -3923,13 +3943,13 @@ void tc_set_debug_level(enum debug_level debug_level)
 void tc_usb_firmware_fw_update_limited_run(int port)
 {
 	TC_SET_FLAG(port, TC_FLAGS_USB_RETIMER_FW_UPDATE_LTD_RUN);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void tc_usb_firmware_fw_update_run(int port)
 {
 	TC_SET_FLAG(port, TC_FLAGS_USB_RETIMER_FW_UPDATE_RUN);
-	task_wake(PD_PORT_TO_TASK_ID(port));
+	pd_task_wake(port);
 }
 
 void tc_run(const int port)
@@ -4094,8 +4114,7 @@ static void pd_set_power_change(void)
 	int i;
 
 	for (i = 0; i < CONFIG_USB_PD_PORT_MAX_COUNT; i++) {
-		task_set_event(PD_PORT_TO_TASK_ID(i),
-			       PD_EVENT_POWER_STATE_CHANGE);
+		pd_task_set_event(i, PD_EVENT_POWER_STATE_CHANGE);
 	}
 }
 DECLARE_DEFERRED(pd_set_power_change);
@@ -146,6 +146,13 @@ uint8_t tc_get_pd_enabled(int port)
 	return tc[port].pd_enable;
 }
 
+#ifdef CONFIG_USB_SM_STATS
+struct sm_stats *tc_get_sm_stats(int port)
+{
+	return &tc[port].ctx.stats;
+}
+#endif
+
 void tc_event_check(int port, int evt)
 {
 	/* Do Nothing */
@@ -36,6 +36,14 @@
 #define USBC_EVENT_TIMEOUT (5 * MSEC)
 #define USBC_MIN_EVENT_TIMEOUT (1 * MSEC)
 
+/*
+ * With CONFIG_USB_PD_TASK_TICKLESS, keep polling for this long after the last
+ * event or PD timer expiration: the state machines signal each other with
+ * flags while handling them, and the receiving one may only notice on its
+ * next run.
+ */
+#define USBC_TICKLESS_SETTLE_TIME (100 * MSEC)
+
 #define CPRINTF(format, args...) cprintf(CC_USBPD, format, ##args)
 #define CPRINTS(format, args...) cprints(CC_USBPD, format, ##args)
 
@@ -51,6 +59,38 @@ extern int _GPIO_CCD_MODE_ODL;
 
 static uint8_t paused[CONFIG_USB_PD_PORT_MAX_COUNT];
 
+/* Number of times the event loop ran, to measure idle power */
+static struct {
+	uint32_t wakeups;
+	/* Wakeups without any event, i.e. caused by the timeout */
+	uint32_t timeouts;
+	timestamp_t since;
+	/* Time of the last event or PD timer expiration */
+	timestamp_t last_activity;
+#ifdef CONFIG_USB_PD_TASK_SHARED
+	/* Time from the first pending event to running the state machines */
+	uint32_t latency_avg;
+	uint32_t latency_max;
+#endif
+} task_stats[CONFIG_USB_PD_PORT_MAX_COUNT];
+
+#ifdef CONFIG_USB_PD_TASK_SHARED
+/* Events sent to each port, waiting for the shared PD task to handle them */
+static atomic_t port_events[CONFIG_USB_PD_PORT_MAX_COUNT];
+/* Time the first of the pending events was sent to each port */
+static timestamp_t port_events_time[CONFIG_USB_PD_PORT_MAX_COUNT];
+/* Time each port must run again, even without events */
+static uint64_t port_next_run[CONFIG_USB_PD_PORT_MAX_COUNT];
+/* Port whose state machines are running */
+static int current_port;
+
+/* A PD task of another port would run the shared loop a second time */
+#if defined(HAS_TASK_PD_C1) || defined(HAS_TASK_PD_C2) || \
+	defined(HAS_TASK_PD_C3)
+#error "CONFIG_USB_PD_TASK_SHARED only runs the PD_C0 task"
+#endif
+#endif
+
 void tc_pause_event_loop(int port)
 {
 	paused[port] = 1;
@@ -69,7 +109,7 @@ void tc_start_event_loop(int port)
 	 */
 	if (paused[port]) {
 		paused[port] = 0;
-		task_set_event(PD_PORT_TO_TASK_ID(port), TASK_EVENT_WAKE);
+		pd_task_wake(port);
 	}
 }
 
@@ -78,6 +118,7 @@ static void pd_task_init(int port)
 	if (IS_ENABLED(CONFIG_USB_TYPEC_SM))
 		tc_state_init(port);
 	paused[port] = 0;
+	task_stats[port].last_activity = get_time();
 
 	/*
 	 * Since most boards configure the TCPC interrupt as edge
@@ -98,26 +139,90 @@ static void pd_task_init(int port)
 		       GPIO_ODR_HIGH);
 }
 
+uint32_t pd_task_get_wakeups(int port, uint32_t *timeouts)
+{
+	if (timeouts)
+		*timeouts = task_stats[port].timeouts;
+	return task_stats[port].wakeups;
+}
+
+uint64_t pd_task_wakeups_period(int port)
+{
+	return get_time().val - task_stats[port].since.val;
+}
+
+void pd_task_reset_wakeups(int port)
+{
+	task_stats[port].wakeups = 0;
+	task_stats[port].timeouts = 0;
+	task_stats[port].since = get_time();
+#ifdef CONFIG_USB_PD_TASK_SHARED
+	task_stats[port].latency_avg = 0;
+	task_stats[port].latency_max = 0;
+#endif
+}
+
+#ifdef CONFIG_USB_PD_TASK_SHARED
+uint32_t pd_task_get_latency(int port, uint32_t *max_us)
+{
+	if (max_us)
+		*max_us = task_stats[port].latency_max;
+	return task_stats[port].latency_avg;
+}
+
+int pd_task_current_port(void)
+{
+	return current_port;
+}
+
+void pd_task_set_event(int port, uint32_t event)
+{
+	if (!atomic_or(&port_events[port], event))
+		port_events_time[port] = get_time();
+	task_wake(TASK_ID_PD_C0);
+}
+
+void pd_task_clear_event(int port, uint32_t event)
+{
+	atomic_clear_bits(&port_events[port], event);
+}
+#endif /* CONFIG_USB_PD_TASK_SHARED */
+
 static int pd_task_timeout(int port)
 {
 	int timeout;
 
 	if (paused[port])
-		timeout = -1;
-	else {
-		timeout = pd_timer_next_expiration(port);
-		if (timeout < 0 || timeout > USBC_EVENT_TIMEOUT)
-			timeout = USBC_EVENT_TIMEOUT;
-		else if (timeout < USBC_MIN_EVENT_TIMEOUT)
-			timeout = USBC_MIN_EVENT_TIMEOUT;
-	}
+		return -1;
+
+	timeout = pd_timer_next_expiration(port);
+	if (timeout >= 0 && timeout < USBC_MIN_EVENT_TIMEOUT)
+		return USBC_MIN_EVENT_TIMEOUT;
+
+	/*
+	 * Once settled, the state machines arm a PD timer or set an event
+	 * whenever they need to run again, so a tickless task sleeps until
+	 * then (forever when no timer is armed).
+	 */
+	if (IS_ENABLED(CONFIG_USB_PD_TASK_TICKLESS) &&
+	    time_since32(task_stats[port].last_activity) >
+		    USBC_TICKLESS_SETTLE_TIME)
+		return timeout;
+
+	if (timeout < 0 || timeout > USBC_EVENT_TIMEOUT)
+		timeout = USBC_EVENT_TIMEOUT;
 	return timeout;
 }
 
-static bool pd_task_loop(int port)
+/* Run the state machines of a port. Return false to re-init the port. */
+static bool pd_task_run(int port, uint32_t evt)
 {
-	/* wait for next event/packet or timeout expiration */
-	const uint32_t evt = task_wait_event(pd_task_timeout(port));
+	task_stats[port].wakeups++;
+	if (evt == TASK_EVENT_TIMER)
+		task_stats[port].timeouts++;
+	if (IS_ENABLED(CONFIG_USB_PD_TASK_TICKLESS) &&
+	    (evt != TASK_EVENT_TIMER || pd_timer_next_expiration(port) == 0))
+		task_stats[port].last_activity = get_time();
 
 	/* Manage expired PD Timers on timeouts */
 	if (evt & TASK_EVENT_TIMER)
@@ -160,6 +265,114 @@ static bool pd_task_loop(int port)
 	return true;
 }
 
+#ifdef CONFIG_USB_PD_TASK_SHARED
+static void pd_task_port_init(int port)
+{
+	current_port = port;
+	pd_timer_init(port);
+	pd_task_init(port);
+	port_next_run[port] = get_time().val;
+}
+
+static void pd_task_record_latency(int port)
+{
+	uint32_t latency = time_since32(port_events_time[port]);
+
+	/* The first sample since the reset seeds the average */
+	if (task_stats[port].latency_max == 0)
+		task_stats[port].latency_avg = latency;
+	else
+		task_stats[port].latency_avg =
+			(task_stats[port].latency_avg * 7 + latency) >> 3;
+
+	if (latency > task_stats[port].latency_max)
+		task_stats[port].latency_max = latency;
+}
+
+static void pd_task_shared_loop(int port_count)
+{
+	uint64_t now = get_time().val;
+	uint64_t next = UINT64_MAX;
+	uint32_t task_evt;
+	int port;
+
+	for (port = 0; port < port_count; port++) {
+		/*
+		 * Events may have been sent while the task was busy, and the
+		 * wake event consumed by a wait in the state machines.
+		 */
+		if (port_events[port])
+			next = now;
+		next = MIN(next, port_next_run[port]);
+	}
+
+	/* wait for next event/packet or timeout expiration */
+	if (next <= now)
+		task_evt = atomic_clear(task_get_event_bitmap(TASK_ID_PD_C0));
+	else if (next == UINT64_MAX)
+		task_evt = task_wait_event(-1);
+	else
+		task_evt = task_wait_event(next - now);
+
+	/*
+	 * Events sent to the task itself rather than to a port can't be
+	 * attributed, so they go to all the ports.
+	 */
+	task_evt &= ~(TASK_EVENT_WAKE | TASK_EVENT_TIMER);
+
+	now = get_time().val;
+	for (port = 0; port < port_count; port++) {
+		uint32_t evt = atomic_clear(&port_events[port]);
+		int timeout;
+
+		if (evt)
+			pd_task_record_latency(port);
+		evt |= task_evt;
+		if (now >= port_next_run[port])
+			evt |= TASK_EVENT_TIMER;
+
+		/* Only run the ports with events or expired timers */
+		if (!evt)
+			continue;
+
+		current_port = port;
+		if (!pd_task_run(port, evt)) {
+			pd_task_port_init(port);
+			continue;
+		}
+
+		timeout = pd_task_timeout(port);
+		if (timeout < 0)
+			port_next_run[port] = UINT64_MAX;
+		else
+			port_next_run[port] = get_time().val + timeout;
+	}
+}
+
+void pd_task(void *u)
+{
+	const int port_count = board_get_usb_pd_port_count();
+	int port;
+
+#if CONFIG_USB_PD_STARTUP_DELAY_MS > 0
+	msleep(CONFIG_USB_PD_STARTUP_DELAY_MS);
+#endif
+
+	for (port = 0; port < port_count; port++) {
+		pd_task_reset_wakeups(port);
+		pd_task_port_init(port);
+	}
+
+	while (1)
+		pd_task_shared_loop(port_count);
+}
+#else
+static bool pd_task_loop(int port)
+{
+	/* wait for next event/packet or timeout expiration */
+	return pd_task_run(port, task_wait_event(pd_task_timeout(port)));
+}
+
 void pd_task(void *u)
 {
 	int port = TASK_ID_TO_PD_PORT(task_get_current());
@@ -174,6 +387,8 @@ void pd_task(void *u)
 	msleep(CONFIG_USB_PD_STARTUP_DELAY_MS);
 #endif
 
+	pd_task_reset_wakeups(port);
+
 	while (1) {
 		pd_timer_init(port);
 		pd_task_init(port);
@@ -188,3 +403,4 @@ void pd_task(void *u)
 			continue;
 	}
 }
+#endif /* CONFIG_USB_PD_TASK_SHARED */
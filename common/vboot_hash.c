@@ -33,9 +33,20 @@ struct vboot_hash_tag {
 	uint32_t size;
 };
 
+#ifdef CONFIG_SHA256_HW_ACCELERATE
+/* The hash engine keeps up with bigger chunks in the same time slice */
+#define CHUNK_SIZE 4096 /* Bytes to hash per deferred call */
+#else
 #define CHUNK_SIZE 1024 /* Bytes to hash per deferred call */
+#endif
 #define WORK_INTERVAL_US 100 /* Delay between deferred calls */
 
+/*
+ * Largest flash read done at once when hashing with a blocking call, to save
+ * per-read overhead on slow (e.g. SPI) flash.
+ */
+#define BLOCKING_READ_SIZE (4 * CHUNK_SIZE)
+
 /* Check that CHUNK_SIZE fits in shared memory. */
 SHARED_MEM_CHECK_SIZE(CHUNK_SIZE);
 
@@ -83,6 +94,19 @@ DECLARE_DEFERRED(vboot_hash_next_chunk);
 
 #ifndef CONFIG_MAPPED_STORAGE
 
+static int read_and_hash(char *buf, int offset, int size)
+{
+	int rv;
+
+	rv = crec_flash_read(offset, size, buf);
+	if (rv == EC_SUCCESS)
+		SHA256_update(&ctx, (const uint8_t *)buf, size);
+	else
+		vboot_hash_abort();
+
+	return rv;
+}
+
 static int read_and_hash_chunk(int offset, int size)
 {
 	char *buf;
@@ -102,11 +126,7 @@ static int read_and_hash_chunk(int offset, int size)
 		return rv;
 	}
 
-	rv = crec_flash_read(offset, size, buf);
-	if (rv == EC_SUCCESS)
-		SHA256_update(&ctx, (const uint8_t *)buf, size);
-	else
-		vboot_hash_abort();
+	rv = read_and_hash(buf, offset, size);
 
 	shared_mem_release(buf);
 	return rv;
@@ -135,24 +155,52 @@ static void hash_next_chunk(size_t size)
 #endif
 }
 
-static void vboot_hash_all_chunks(void)
+static int vboot_hash_all_chunks(void)
 {
 	char str_buf[hex_str_buf_size(SHA256_PRINT_SIZE)];
+	int rv = EC_SUCCESS;
 
-	do {
-		size_t size = MIN(CHUNK_SIZE, data_size - curr_pos);
-		hash_next_chunk(size);
-		curr_pos += size;
-	} while (curr_pos < data_size);
+#ifdef CONFIG_MAPPED_STORAGE
+	/*
+	 * Nothing else runs until we are done, so there is no point in
+	 * splitting the region: hand it to the hash engine in one go.
+	 */
+	hash_next_chunk(data_size - curr_pos);
+	curr_pos = data_size;
+#else
+	char *buf;
+	size_t buf_size = MIN(shared_mem_size(), BLOCKING_READ_SIZE);
+
+	/* Use one buffer for the whole region, as large as available. */
+	rv = shared_mem_acquire(buf_size, &buf);
+	if (rv == EC_SUCCESS) {
+		while (curr_pos < data_size) {
+			size_t size = MIN(buf_size, data_size - curr_pos);
+
+			rv = read_and_hash(buf, data_offset + curr_pos, size);
+			if (rv != EC_SUCCESS)
+				break;
+			curr_pos += size;
+		}
+		shared_mem_release(buf);
+	}
+#endif
+
+	in_progress = 0;
+	clock_enable_module(MODULE_FAST_CPU, 0);
+
+	if (rv != EC_SUCCESS) {
+		CPRINTS("hash failed %d", rv);
+		vboot_hash_abort();
+		return rv;
+	}
 
 	hash = SHA256_final(&ctx);
 	snprintf_hex_buffer(str_buf, sizeof(str_buf),
 			    HEX_BUF(hash, SHA256_PRINT_SIZE));
 	CPRINTS("hash done %s", str_buf);
-	in_progress = 0;
-	clock_enable_module(MODULE_FAST_CPU, 0);
 
-	return;
+	return EC_SUCCESS;
 }
 
 /**
@@ -216,8 +264,9 @@ static void vboot_hash_next_chunk(void)
  * 			False to hash with a blocking single call.
  * @return		ec_error_list.
  */
-static int vboot_hash_start(uint32_t offset, uint32_t size,
-			    const uint8_t *nonce, int nonce_size, bool deferred)
+test_export_static int vboot_hash_start(uint32_t offset, uint32_t size,
+					const uint8_t *nonce, int nonce_size,
+					bool deferred)
 {
 	/* Fail if hash computation is already in progress */
 	if (in_progress)
@@ -248,10 +297,10 @@ static int vboot_hash_start(uint32_t offset, uint32_t size,
 	if (nonce_size)
 		SHA256_update(&ctx, nonce, nonce_size);
 
-	if (deferred)
-		hook_call_deferred(&vboot_hash_next_chunk_data, 0);
-	else
-		vboot_hash_all_chunks();
+	if (!deferred)
+		return vboot_hash_all_chunks();
+
+	hook_call_deferred(&vboot_hash_next_chunk_data, 0);
 
 	return EC_SUCCESS;
 }
@@ -269,6 +269,11 @@ int task_start_called(void)
 	return start_called;
 }
 
+const char *task_get_name(task_id_t tskid)
+{
+	return task_names[tskid];
+}
+
 /**
  * Scheduling system call
  */
@@ -348,6 +353,9 @@ void svc_handler(int desched, task_id_t resched)
 		/* Switch to new task */
 #ifdef CONFIG_TASK_PROFILING
 	task_switches++;
+#endif
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_wake_latency_end(next - tasks);
 #endif
 	current_task = next;
 	__switchto(current, next);
@@ -448,6 +456,10 @@ void task_set_event(task_id_t tskid, uint32_t event)
 	task_ *receiver = __task_id_to_ptr(tskid);
 	ASSERT(receiver);
 
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_wake_latency_start(tskid);
+#endif
+
 	/* Set the event bit in the receiver message bitmap */
 	atomic_or(&receiver->events, event);
 
@@ -999,6 +1011,9 @@ static int command_task_info(int argc, const char **argv)
 		 get_time().val - task_start_time);
 	ccprintf("Time in exceptions:     %11.6lld s\n", exc_total_time);
 #endif
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_print_wake_latency();
+#endif
 
 	return EC_SUCCESS;
 }
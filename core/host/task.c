@@ -206,6 +206,9 @@ pthread_t task_get_thread(task_id_t tskid)
 
 void task_set_event(task_id_t tskid, uint32_t event)
 {
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_wake_latency_start(tskid);
+#endif
 	atomic_or(&tasks[tskid].event, event);
 }
 
@@ -227,6 +230,9 @@ uint32_t task_wait_event(int timeout_us)
 	pthread_cond_wait(&tasks[tid].resume, &run_lock);
 
 	/* Resume */
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_wake_latency_end(tid);
+#endif
 	ret = atomic_clear(&tasks[tid].event);
 	pthread_mutex_unlock(&interrupt_lock);
 	return ret;
@@ -319,6 +325,9 @@ void task_print_list(void)
 static int command_task_info(int argc, const char **argv)
 {
 	task_print_list();
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_print_wake_latency();
+#endif
 
 	return EC_SUCCESS;
 }
@@ -11,6 +11,7 @@
 #include "console.h"
 #include "host_command.h"
 #include "i2c.h"
+#include "task.h"
 #include "timer.h"
 #include "util.h"
 
@@ -76,6 +77,103 @@ static bool sb_cutoff_or_in_progress(void)
 	return false;
 }
 
+#ifdef CONFIG_BATTERY_SMART_CACHE
+/*
+ * Maximum age of the cached registers. Fast changing registers must stay
+ * younger than the shortest charge_state poll period, so that every charge
+ * loop still sees a new reading.
+ */
+enum sb_cache_policy {
+	SB_CACHE_FAST,
+	SB_CACHE_SLOW,
+	SB_CACHE_STATIC,
+};
+
+static const uint32_t sb_cache_max_age[] = {
+	[SB_CACHE_FAST] = 50 * MSEC,
+	[SB_CACHE_SLOW] = 1 * SECOND,
+	[SB_CACHE_STATIC] = 60 * SECOND,
+};
+
+struct sb_cache_entry {
+	uint8_t cmd;
+	uint8_t policy;
+	uint16_t value;
+	/* Time after which the value must be read again, 0 if invalid */
+	uint64_t expires;
+};
+
+#define SB_CACHE_ENTRY(c, p)                \
+	{                                   \
+		.cmd = (c), .policy = (p), \
+	}
+
+/* Sorted by register, so that neighbours can be read in a single burst */
+static struct sb_cache_entry sb_cache[] = {
+	SB_CACHE_ENTRY(SB_BATTERY_MODE, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_TEMPERATURE, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_VOLTAGE, SB_CACHE_FAST),
+	SB_CACHE_ENTRY(SB_CURRENT, SB_CACHE_FAST),
+	SB_CACHE_ENTRY(SB_AVERAGE_CURRENT, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_MAX_ERROR, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_RELATIVE_STATE_OF_CHARGE, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_ABSOLUTE_STATE_OF_CHARGE, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_REMAINING_CAPACITY, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_FULL_CHARGE_CAPACITY, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_RUN_TIME_TO_EMPTY, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_AVERAGE_TIME_TO_EMPTY, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_AVERAGE_TIME_TO_FULL, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_CHARGING_CURRENT, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_CHARGING_VOLTAGE, SB_CACHE_SLOW),
+	SB_CACHE_ENTRY(SB_BATTERY_STATUS, SB_CACHE_FAST),
+	SB_CACHE_ENTRY(SB_CYCLE_COUNT, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_DESIGN_CAPACITY, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_DESIGN_VOLTAGE, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_MANUFACTURE_DATE, SB_CACHE_STATIC),
+	SB_CACHE_ENTRY(SB_SERIAL_NUMBER, SB_CACHE_STATIC),
+};
+
+K_MUTEX_DEFINE(sb_cache_lock);
+
+static struct sb_cache_entry *sb_cache_find(int cmd)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sb_cache); i++) {
+		if (sb_cache[i].cmd == cmd)
+			return &sb_cache[i];
+	}
+	return NULL;
+}
+
+static void sb_cache_store(struct sb_cache_entry *entry, int value,
+			   uint64_t now)
+{
+	entry->value = value;
+	entry->expires = now + sb_cache_max_age[entry->policy];
+}
+
+static bool sb_cache_is_fresh(const struct sb_cache_entry *entry,
+			      uint64_t now)
+{
+	return now < entry->expires;
+}
+
+void sb_cache_invalidate(void)
+{
+	int i;
+
+	mutex_lock(&sb_cache_lock);
+	for (i = 0; i < ARRAY_SIZE(sb_cache); i++)
+		sb_cache[i].expires = 0;
+	mutex_unlock(&sb_cache_lock);
+}
+#else
+void sb_cache_invalidate(void)
+{
+}
+#endif /* CONFIG_BATTERY_SMART_CACHE */
+
 test_mockable int sb_read(int cmd, int *param)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
@@ -90,6 +188,7 @@ test_mockable int sb_read(int cmd, int *param)
 test_mockable int sb_write(int cmd, int param)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 	if (IS_ENABLED(CONFIG_BATTERY_CUT_OFF)) {
 		/*
@@ -101,7 +200,122 @@ test_mockable int sb_write(int cmd, int param)
 
 	ADDR_FLAGS_FOR_PEC(&addr_flags);
 
-	return i2c_write16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+	rv = i2c_write16(I2C_PORT_BATTERY, addr_flags, cmd, param);
+
+	/* Writes may change how the battery reports the cached registers. */
+	sb_cache_invalidate();
+
+	return rv;
+}
+
+/**
+ * Read a battery register, from the register cache if it is fresh enough.
+ *
+ * @param cmd		Battery register to read from
+ * @param param		Destination of the register value
+ * @return		non-zero if error
+ */
+static int sb_read_cached(int cmd, int *param)
+{
+#ifdef CONFIG_BATTERY_SMART_CACHE
+	struct sb_cache_entry *entry = sb_cache_find(cmd);
+	uint64_t now;
+	int rv;
+
+	if (!entry)
+		return sb_read(cmd, param);
+
+	if (sb_cutoff_or_in_progress())
+		return EC_ERROR_ACCESS_DENIED;
+
+	mutex_lock(&sb_cache_lock);
+	now = get_time().val;
+	if (sb_cache_is_fresh(entry, now)) {
+		*param = entry->value;
+		mutex_unlock(&sb_cache_lock);
+		return EC_SUCCESS;
+	}
+
+	rv = sb_read(cmd, param);
+	if (rv == EC_SUCCESS)
+		sb_cache_store(entry, *param, now);
+	mutex_unlock(&sb_cache_lock);
+
+	/*
+	 * The battery may have been swapped while it was not responding, do
+	 * not serve anything read before.
+	 */
+	if (rv)
+		sb_cache_invalidate();
+
+	return rv;
+#else
+	return sb_read(cmd, param);
+#endif
+}
+
+/**
+ * Refresh the stale cached registers between first and last included. When
+ * the gauge supports it, they are read in a single I2C transaction instead of
+ * one transaction per register.
+ *
+ * @param first		First battery register to refresh
+ * @param last		Last battery register to refresh
+ */
+static void sb_cache_prefetch(int first, int last)
+{
+#ifdef CONFIG_BATTERY_SMART_BURST_READ
+	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	uint8_t buf[2 * ARRAY_SIZE(sb_cache)];
+	int lo = -1, hi = -1;
+	uint64_t now;
+	int i, rv;
+
+	if (sb_cutoff_or_in_progress())
+		return;
+
+	/* PEC only covers single word transactions. */
+	ADDR_FLAGS_FOR_PEC(&addr_flags);
+	if (I2C_USE_PEC(addr_flags))
+		return;
+
+	mutex_lock(&sb_cache_lock);
+	now = get_time().val;
+	for (i = 0; i < ARRAY_SIZE(sb_cache); i++) {
+		if (sb_cache[i].cmd < first || sb_cache[i].cmd > last ||
+		    sb_cache_is_fresh(&sb_cache[i], now))
+			continue;
+		if (lo < 0)
+			lo = i;
+		hi = i;
+	}
+
+	/*
+	 * A single stale register is read on demand, and the burst must not
+	 * cross a register the cache does not hold.
+	 */
+	if (lo < 0 || lo == hi ||
+	    sb_cache[hi].cmd - sb_cache[lo].cmd != hi - lo) {
+		mutex_unlock(&sb_cache_lock);
+		return;
+	}
+
+	rv = i2c_read_block(I2C_PORT_BATTERY, addr_flags, sb_cache[lo].cmd,
+			    buf, 2 * (hi - lo + 1));
+	if (rv == EC_SUCCESS) {
+		for (i = lo; i <= hi; i++) {
+			const uint8_t *word = &buf[2 * (i - lo)];
+
+			if (I2C_IS_BIG_ENDIAN(addr_flags))
+				sb_cache_store(&sb_cache[i],
+					       (word[0] << 8) | word[1], now);
+			else
+				sb_cache_store(&sb_cache[i],
+					       (word[1] << 8) | word[0], now);
+		}
+	}
+	mutex_unlock(&sb_cache_lock);
+#endif
 }
 
 int sb_read_string(int offset, uint8_t *data, int len)
@@ -199,6 +413,7 @@ int sb_read_mfgacc_block(int cmd, int block, uint8_t *data, int len)
 int sb_write_block(int reg, const uint8_t *val, int len)
 {
 	uint16_t addr_flags = BATTERY_ADDR_FLAGS;
+	int rv;
 
 #ifdef CONFIG_BATTERY_CUT_OFF
 	/*
@@ -211,12 +426,16 @@ int sb_write_block(int reg, const uint8_t *val, int len)
 	ADDR_FLAGS_FOR_PEC(&addr_flags);
 
 	/* TODO: implement smbus_write_block. */
-	return i2c_write_block(I2C_PORT_BATTERY, addr_flags, reg, val, len);
+	rv = i2c_write_block(I2C_PORT_BATTERY, addr_flags, reg, val, len);
+
+	sb_cache_invalidate();
+
+	return rv;
 }
 
 int battery_get_mode(int *mode)
 {
-	return sb_read(SB_BATTERY_MODE, mode);
+	return sb_read_cached(SB_BATTERY_MODE, mode);
 }
 
 /**
@@ -240,7 +459,7 @@ static int battery_force_mah_mode(void)
 
 int battery_state_of_charge_abs(int *percent)
 {
-	return sb_read(SB_ABSOLUTE_STATE_OF_CHARGE, percent);
+	return sb_read_cached(SB_ABSOLUTE_STATE_OF_CHARGE, percent);
 }
 
 int battery_remaining_capacity(int *capacity)
@@ -249,7 +468,7 @@ int battery_remaining_capacity(int *capacity)
 	if (rv)
 		return rv;
 
-	return sb_read(SB_REMAINING_CAPACITY, capacity);
+	return sb_read_cached(SB_REMAINING_CAPACITY, capacity);
 }
 
 int battery_full_charge_capacity(int *capacity)
@@ -258,34 +477,34 @@ int battery_full_charge_capacity(int *capacity)
 	if (rv)
 		return rv;
 
-	return sb_read(SB_FULL_CHARGE_CAPACITY, capacity);
+	return sb_read_cached(SB_FULL_CHARGE_CAPACITY, capacity);
 }
 
 int battery_time_to_empty(int *minutes)
 {
-	return sb_read(SB_AVERAGE_TIME_TO_EMPTY, minutes);
+	return sb_read_cached(SB_AVERAGE_TIME_TO_EMPTY, minutes);
 }
 
 int battery_run_time_to_empty(int *minutes)
 {
-	return sb_read(SB_RUN_TIME_TO_EMPTY, minutes);
+	return sb_read_cached(SB_RUN_TIME_TO_EMPTY, minutes);
 }
 
 int battery_time_to_full(int *minutes)
 {
-	return sb_read(SB_AVERAGE_TIME_TO_FULL, minutes);
+	return sb_read_cached(SB_AVERAGE_TIME_TO_FULL, minutes);
 }
 
 /* Read battery status */
 int battery_status(int *status)
 {
-	return sb_read(SB_BATTERY_STATUS, status);
+	return sb_read_cached(SB_BATTERY_STATUS, status);
 }
 
 /* Battery charge cycle count */
 int battery_cycle_count(int *count)
 {
-	return sb_read(SB_CYCLE_COUNT, count);
+	return sb_read_cached(SB_CYCLE_COUNT, count);
 }
 
 int battery_design_capacity(int *capacity)
@@ -294,7 +513,7 @@ int battery_design_capacity(int *capacity)
 	if (rv)
 		return rv;
 
-	return sb_read(SB_DESIGN_CAPACITY, capacity);
+	return sb_read_cached(SB_DESIGN_CAPACITY, capacity);
 }
 
 /* Designed battery output voltage
@@ -302,13 +521,13 @@ int battery_design_capacity(int *capacity)
  */
 int battery_design_voltage(int *voltage)
 {
-	return sb_read(SB_DESIGN_VOLTAGE, voltage);
+	return sb_read_cached(SB_DESIGN_VOLTAGE, voltage);
 }
 
 /* Read serial number */
 int battery_serial_number(int *serial)
 {
-	return sb_read(SB_SERIAL_NUMBER, serial);
+	return sb_read_cached(SB_SERIAL_NUMBER, serial);
 }
 
 test_mockable int battery_time_at_rate(int rate, int *minutes)
@@ -357,7 +576,7 @@ test_mockable int battery_manufacture_date(int *year, int *month, int *day)
 	int rv;
 	int ymd;
 
-	rv = sb_read(SB_MANUFACTURE_DATE, &ymd);
+	rv = sb_read_cached(SB_MANUFACTURE_DATE, &ymd);
 	if (rv)
 		return rv;
 
@@ -406,7 +625,7 @@ int battery_get_avg_current(void)
 	int current;
 
 	/* This is a signed 16-bit value. */
-	sb_read(SB_AVERAGE_CURRENT, &current);
+	sb_read_cached(SB_AVERAGE_CURRENT, &current);
 	return (int16_t)current;
 }
 
@@ -420,7 +639,7 @@ int battery_get_avg_voltage(void)
 {
 	int voltage = -EC_ERROR_UNKNOWN;
 
-	sb_read(SB_VOLTAGE, &voltage);
+	sb_read_cached(SB_VOLTAGE, &voltage);
 	return voltage;
 }
 #endif /* CONFIG_CMD_PWR_AVG */
@@ -487,7 +706,11 @@ void battery_get_params(struct batt_params *batt)
 	memcpy(&batt_new, batt, sizeof(*batt));
 	batt_new.flags &= ~BATT_FLAG_VOLATILE;
 
-	if (sb_read(SB_TEMPERATURE, &batt_new.temperature) &&
+	/* Coalesce the reads of the registers below, if possible. */
+	sb_cache_prefetch(SB_TEMPERATURE, SB_FULL_CHARGE_CAPACITY);
+	sb_cache_prefetch(SB_CHARGING_CURRENT, SB_BATTERY_STATUS);
+
+	if (sb_read_cached(SB_TEMPERATURE, &batt_new.temperature) &&
 	    fake_temperature < 0)
 		batt_new.flags |= BATT_FLAG_BAD_TEMPERATURE;
 
@@ -495,26 +718,27 @@ void battery_get_params(struct batt_params *batt)
 	if (fake_temperature >= 0)
 		batt_new.temperature = fake_temperature;
 
-	if (sb_read(SB_RELATIVE_STATE_OF_CHARGE, &batt_new.state_of_charge) &&
+	if (sb_read_cached(SB_RELATIVE_STATE_OF_CHARGE,
+			   &batt_new.state_of_charge) &&
 	    fake_state_of_charge < 0)
 		batt_new.flags |= BATT_FLAG_BAD_STATE_OF_CHARGE;
 
-	if (sb_read(SB_VOLTAGE, &batt_new.voltage))
+	if (sb_read_cached(SB_VOLTAGE, &batt_new.voltage))
 		batt_new.flags |= BATT_FLAG_BAD_VOLTAGE;
 
 	/* This is a signed 16-bit value. */
-	if (sb_read(SB_CURRENT, &v))
+	if (sb_read_cached(SB_CURRENT, &v))
 		batt_new.flags |= BATT_FLAG_BAD_CURRENT;
 	else
 		batt_new.current = (int16_t)v;
 
-	if (sb_read(SB_AVERAGE_CURRENT, &v))
+	if (sb_read_cached(SB_AVERAGE_CURRENT, &v))
 		batt_new.flags |= BATT_FLAG_BAD_AVERAGE_CURRENT;
 
-	if (sb_read(SB_CHARGING_VOLTAGE, &batt_new.desired_voltage))
+	if (sb_read_cached(SB_CHARGING_VOLTAGE, &batt_new.desired_voltage))
 		batt_new.flags |= BATT_FLAG_BAD_DESIRED_VOLTAGE;
 
-	if (sb_read(SB_CHARGING_CURRENT, &batt_new.desired_current))
+	if (sb_read_cached(SB_CHARGING_CURRENT, &batt_new.desired_current))
 		batt_new.flags |= BATT_FLAG_BAD_DESIRED_CURRENT;
 
 	if (battery_remaining_capacity(&batt_new.remaining_capacity))
@@ -90,9 +90,15 @@ static int rt1718s_vbus_sink_enable(int port, int enable)
 
 static int rt1718s_discharge_vbus(int port, int enable)
 {
-	return update_bits(port, TCPC_REG_POWER_CTRL,
-			   TCPC_REG_POWER_CTRL_FORCE_DISCHARGE,
-			   enable ? 0xFF : 0x00);
+	int rv;
+
+	rv = update_bits(port, TCPC_REG_POWER_CTRL,
+			 TCPC_REG_POWER_CTRL_FORCE_DISCHARGE,
+			 enable ? 0xFF : 0x00);
+
+	/* POWER_CTRL is written without the TCPC accessors. */
+	tcpci_reg_cache_invalidate(port);
+	return rv;
 }
 
 #ifdef CONFIG_CMD_PPC_DUMP
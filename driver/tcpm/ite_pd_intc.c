@@ -10,6 +10,13 @@
 #include "tcpm/tcpm.h"
 #include "usb_pd.h"
 
+/*
+ * The transmit path waits for TASK_EVENT_PHY_TX_DONE in the PD task, which the
+ * shared PD task can't attribute to a port.
+ */
+BUILD_ASSERT(!IS_ENABLED(CONFIG_USB_PD_TASK_SHARED),
+	     "ITE PD PHY doesn't support CONFIG_USB_PD_TASK_SHARED");
+
 void chip_pd_irq(enum usbpd_port port)
 {
 	task_clear_pending_irq(usbpd_ctrl_regs[port].irq);
@@ -36,8 +43,7 @@ void chip_pd_irq(enum usbpd_port port)
 		/* clear interrupt */
 		IT83XX_USBPD_ISR(port) = USBPD_REG_MASK_HARD_RESET_DETECT;
 		USBPD_SW_RESET(port);
-		task_set_event(PD_PORT_TO_TASK_ID(port),
-			       PD_EVENT_RX_HARD_RESET);
+		pd_task_set_event(port, PD_EVENT_RX_HARD_RESET);
 	}
 
 	if (USBPD_IS_RX_DONE(port)) {
@@ -81,7 +87,7 @@ void chip_pd_irq(enum usbpd_port port)
 			/* clear type-c device plug in/out detect interrupt */
 			IT83XX_USBPD_TCDCR(port) |=
 				USBPD_REG_PLUG_IN_OUT_DETECT_STAT;
-			task_set_event(PD_PORT_TO_TASK_ID(port), PD_EVENT_CC);
+			pd_task_set_event(port, PD_EVENT_CC);
 		}
 	}
 }
@@ -138,7 +138,7 @@ static int stm32gx_tcpm_reset_bist_type_2(int port)
 	 */
 	stm32gx_ucpd_init(port);
 	pd_execute_hard_reset(port);
-	task_set_event(PD_PORT_TO_TASK_ID(port), TASK_EVENT_WAKE);
+	pd_task_set_event(port, TASK_EVENT_WAKE);
 
 	return EC_SUCCESS;
 }
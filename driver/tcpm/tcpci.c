@@ -268,6 +268,9 @@ int tcpc_update8(int port, int reg, uint8_t mask,
 	rv = i2c_update8(tcpc_config[port].i2c_info.port, i2c_addr, reg, mask,
 			 action);
 
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+
 	pd_device_accessed(port);
 	return rv;
 }
@@ -290,6 +293,9 @@ int tcpc_update16(int port, int reg, uint16_t mask,
 	rv = i2c_update16(tcpc_config[port].i2c_info.port, i2c_addr, reg, mask,
 			  action);
 
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+
 	pd_device_accessed(port);
 	return rv;
 }
@@ -313,6 +319,183 @@ int tcpci_get_cached_rp(int port)
 	return cached_rp[port];
 }
 
+#ifdef CONFIG_USB_PD_TCPCI_REG_CACHE
+/*
+ * Registers shadowed per port. The control registers are only changed by the
+ * TCPM, so their shadow stays valid until the TCPC is reset. CC_STATUS is
+ * shadowed only while its alert is unmasked, and dropped on every alert.
+ */
+static const uint8_t shadow_regs[] = {
+	TCPC_REG_ROLE_CTRL,
+	TCPC_REG_POWER_CTRL,
+	TCPC_REG_TCPC_CTRL,
+	TCPC_REG_ALERT_MASK,
+	TCPC_REG_CC_STATUS,
+};
+#define SHADOW_ALERT_MASK 3
+#define SHADOW_CC_STATUS 4
+
+static struct {
+	uint16_t val[ARRAY_SIZE(shadow_regs)];
+	/* Bitmask of the valid entries of val */
+	uint8_t valid;
+	/* Incremented each time an entry is dropped or replaced */
+	uint8_t gen;
+} reg_shadow[CONFIG_USB_PD_PORT_MAX_COUNT];
+
+static int shadow_index(int reg)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(shadow_regs); i++)
+		if (shadow_regs[i] == reg)
+			return i;
+	return -1;
+}
+
+static bool shadow_is_16bit(int idx)
+{
+	return shadow_regs[idx] == TCPC_REG_ALERT_MASK;
+}
+
+static void shadow_store(int port, int idx, int val)
+{
+	uint32_t key = irq_lock();
+
+	reg_shadow[port].val[idx] = val;
+	reg_shadow[port].valid |= BIT(idx);
+	reg_shadow[port].gen++;
+	irq_unlock(key);
+}
+
+static void shadow_drop(int port, uint8_t mask)
+{
+	uint32_t key = irq_lock();
+
+	reg_shadow[port].valid &= ~mask;
+	reg_shadow[port].gen++;
+	irq_unlock(key);
+}
+
+void tcpci_reg_cache_clobber(int port, int reg)
+{
+	int idx;
+
+	/* A new role or a command restart the CC detection. */
+	if (reg == TCPC_REG_ROLE_CTRL || reg == TCPC_REG_COMMAND)
+		shadow_drop(port, BIT(SHADOW_CC_STATUS));
+
+	idx = shadow_index(reg);
+	if (idx >= 0)
+		shadow_drop(port, BIT(idx));
+}
+
+void tcpci_reg_cache_invalidate(int port)
+{
+	shadow_drop(port, 0xff);
+}
+
+static bool shadow_cc_status_allowed(int port)
+{
+	return (reg_shadow[port].valid & BIT(SHADOW_ALERT_MASK)) &&
+	       (reg_shadow[port].val[SHADOW_ALERT_MASK] &
+		TCPC_REG_ALERT_CC_STATUS);
+}
+
+static int tcpci_reg_read(int port, int reg, int *val)
+{
+	int idx = shadow_index(reg);
+	uint32_t key;
+	uint8_t gen;
+	int rv;
+
+	if (idx < 0)
+		return tcpc_read(port, reg, val);
+
+	key = irq_lock();
+	if (reg_shadow[port].valid & BIT(idx)) {
+		*val = reg_shadow[port].val[idx];
+		irq_unlock(key);
+		return EC_SUCCESS;
+	}
+	gen = reg_shadow[port].gen;
+	irq_unlock(key);
+
+	if (shadow_is_16bit(idx))
+		rv = tcpc_read16(port, reg, val);
+	else
+		rv = tcpc_read(port, reg, val);
+	if (rv)
+		return rv;
+
+	if (idx == SHADOW_CC_STATUS && !shadow_cc_status_allowed(port))
+		return rv;
+
+	/* Don't overwrite a value stored while the register was read. */
+	key = irq_lock();
+	if (reg_shadow[port].gen == gen) {
+		reg_shadow[port].val[idx] = *val;
+		reg_shadow[port].valid |= BIT(idx);
+	}
+	irq_unlock(key);
+
+	return rv;
+}
+
+static int tcpci_reg_write(int port, int reg, int val)
+{
+	int idx = shadow_index(reg);
+	int rv;
+
+	if (idx >= 0 && shadow_is_16bit(idx))
+		rv = tcpc_write16(port, reg, val);
+	else
+		rv = tcpc_write(port, reg, val);
+
+	if (idx >= 0 && rv == EC_SUCCESS)
+		shadow_store(port, idx, val);
+	return rv;
+}
+
+static int tcpci_reg_update(int port, int reg, int mask,
+			    enum mask_update_action action)
+{
+	int rv, val, new_val;
+
+	rv = tcpci_reg_read(port, reg, &val);
+	if (rv)
+		return rv;
+
+	new_val = (action == MASK_SET) ? (val | mask) : (val & ~mask);
+	if (IS_ENABLED(CONFIG_I2C_UPDATE_IF_CHANGED) && new_val == val)
+		return EC_SUCCESS;
+
+	return tcpci_reg_write(port, reg, new_val);
+}
+#else
+static inline int tcpci_reg_read(int port, int reg, int *val)
+{
+	if (reg == TCPC_REG_ALERT_MASK)
+		return tcpc_read16(port, reg, val);
+	return tcpc_read(port, reg, val);
+}
+
+static inline int tcpci_reg_write(int port, int reg, int val)
+{
+	if (reg == TCPC_REG_ALERT_MASK)
+		return tcpc_write16(port, reg, val);
+	return tcpc_write(port, reg, val);
+}
+
+static inline int tcpci_reg_update(int port, int reg, int mask,
+				   enum mask_update_action action)
+{
+	if (reg == TCPC_REG_ALERT_MASK)
+		return tcpc_update16(port, reg, mask, action);
+	return tcpc_update8(port, reg, mask, action);
+}
+#endif /* CONFIG_USB_PD_TCPCI_REG_CACHE */
+
 static int init_alert_mask(int port)
 {
 	int rv;
@@ -342,7 +525,7 @@ static int init_alert_mask(int port)
 		mask |= TCPC_REG_ALERT_ALERT_EXT;
 
 	/* Set the alert mask in TCPC */
-	rv = tcpc_write16(port, TCPC_REG_ALERT_MASK, mask);
+	rv = tcpci_reg_write(port, TCPC_REG_ALERT_MASK, mask);
 
 	if (tcpm_tcpc_has_frs_control(port)) {
 		if (rv)
@@ -357,7 +540,7 @@ static int init_alert_mask(int port)
 
 static int clear_alert_mask(int port)
 {
-	return tcpc_write16(port, TCPC_REG_ALERT_MASK, 0);
+	return tcpci_reg_write(port, TCPC_REG_ALERT_MASK, 0);
 }
 
 static int init_power_status_mask(int port)
@@ -399,9 +582,9 @@ void tcpci_tcpc_discharge_vbus(int port, int enable)
 		CPRINTS("C%d: ForceDischarge %sABLED", port,
 			enable ? "EN" : "DIS");
 
-	tcpc_update8(port, TCPC_REG_POWER_CTRL,
-		     TCPC_REG_POWER_CTRL_FORCE_DISCHARGE,
-		     (enable) ? MASK_SET : MASK_CLR);
+	tcpci_reg_update(port, TCPC_REG_POWER_CTRL,
+			 TCPC_REG_POWER_CTRL_FORCE_DISCHARGE,
+			 (enable) ? MASK_SET : MASK_CLR);
 }
 
 /*
@@ -415,9 +598,9 @@ void tcpci_tcpc_enable_auto_discharge_disconnect(int port, int enable)
 		CPRINTS("C%d: AutoDischargeDisconnect %sABLED", port,
 			enable ? "EN" : "DIS");
 
-	tcpc_update8(port, TCPC_REG_POWER_CTRL,
-		     TCPC_REG_POWER_CTRL_AUTO_DISCHARGE_DISCONNECT,
-		     (enable) ? MASK_SET : MASK_CLR);
+	tcpci_reg_update(port, TCPC_REG_POWER_CTRL,
+			 TCPC_REG_POWER_CTRL_AUTO_DISCHARGE_DISCONNECT,
+			 (enable) ? MASK_SET : MASK_CLR);
 }
 
 int tcpci_tcpc_debug_accessory(int port, bool enable)
@@ -440,11 +623,11 @@ int tcpci_tcpm_get_cc(int port, enum tcpc_cc_voltage_status *cc1,
 	*cc2 = TYPEC_CC_VOLT_OPEN;
 
 	/* Get the ROLE CONTROL and CC STATUS values */
-	rv = tcpc_read(port, TCPC_REG_ROLE_CTRL, &role);
+	rv = tcpci_reg_read(port, TCPC_REG_ROLE_CTRL, &role);
 	if (rv)
 		return rv;
 
-	rv = tcpc_read(port, TCPC_REG_CC_STATUS, &status);
+	rv = tcpci_reg_read(port, TCPC_REG_CC_STATUS, &status);
 	if (rv)
 		return rv;
 
@@ -510,7 +693,7 @@ int tcpci_tcpm_set_cc(int port, int pull)
 	if (IS_ENABLED(DEBUG_ROLE_CTRL_UPDATES))
 		CPRINTS("C%d: SET_CC pull=%d role=0x%X", port, pull, role);
 
-	return tcpc_write(port, TCPC_REG_ROLE_CTRL, role);
+	return tcpci_reg_write(port, TCPC_REG_ROLE_CTRL, role);
 }
 
 #ifdef CONFIG_USB_PD_DUAL_ROLE_AUTO_TOGGLE
@@ -523,7 +706,7 @@ int tcpci_set_role_ctrl(int port, enum tcpc_drp drp, enum tcpc_rp_value rp,
 		CPRINTS("C%d: SET_ROLE_CTRL drp=%d rp=%d pull=%d role=0x%X",
 			port, drp, rp, pull, role);
 
-	return tcpc_write(port, TCPC_REG_ROLE_CTRL, role);
+	return tcpci_reg_write(port, TCPC_REG_ROLE_CTRL, role);
 }
 
 int tcpci_tcpc_drp_toggle(int port)
@@ -553,9 +736,9 @@ int tcpci_tcpc_drp_toggle(int port)
 		return rv;
 
 	/* Set up to catch LOOK4CONNECTION alerts */
-	rv = tcpc_update8(port, TCPC_REG_TCPC_CTRL,
-			  TCPC_REG_TCPC_CTRL_EN_LOOK4CONNECTION_ALERT,
-			  MASK_SET);
+	rv = tcpci_reg_update(port, TCPC_REG_TCPC_CTRL,
+			      TCPC_REG_TCPC_CTRL_EN_LOOK4CONNECTION_ALERT,
+			      MASK_SET);
 	if (rv)
 		return rv;
 
@@ -570,11 +753,14 @@ int tcpci_tcpc_drp_toggle(int port)
 #ifdef CONFIG_USB_PD_TCPC_LOW_POWER
 int tcpci_enter_low_power_mode(int port)
 {
+	tcpci_reg_cache_invalidate(port);
 	return tcpc_write(port, TCPC_REG_COMMAND, TCPC_REG_COMMAND_I2CIDLE);
 }
 
 void tcpci_wake_low_power_mode(int port)
 {
+	tcpci_reg_cache_invalidate(port);
+
 	/*
 	 * TCPCI 4.8.1 I2C Interface - wake the TCPC with a throw-away command
 	 *
@@ -589,8 +775,9 @@ void tcpci_wake_low_power_mode(int port)
 
 int tcpci_tcpm_set_polarity(int port, enum tcpc_cc_polarity polarity)
 {
-	return tcpc_update8(port, TCPC_REG_TCPC_CTRL, TCPC_REG_TCPC_CTRL_SET(1),
-			    polarity_rm_dts(polarity) ? MASK_SET : MASK_CLR);
+	return tcpci_reg_update(
+		port, TCPC_REG_TCPC_CTRL, TCPC_REG_TCPC_CTRL_SET(1),
+		polarity_rm_dts(polarity) ? MASK_SET : MASK_CLR);
 }
 
 bool tcpci_tcpm_get_snk_ctrl(int port)
@@ -653,14 +840,14 @@ int tcpci_tcpm_set_vconn(int port, int enable)
 {
 	int reg, rv;
 
-	rv = tcpc_read(port, TCPC_REG_POWER_CTRL, &reg);
+	rv = tcpci_reg_read(port, TCPC_REG_POWER_CTRL, &reg);
 	if (rv)
 		return rv;
 
 	reg &= ~TCPC_REG_POWER_CTRL_VCONN(1);
 	reg |= TCPC_REG_POWER_CTRL_VCONN(enable);
 
-	return tcpc_write(port, TCPC_REG_POWER_CTRL, reg);
+	return tcpci_reg_write(port, TCPC_REG_POWER_CTRL, reg);
 }
 
 int tcpci_tcpm_set_msg_header(int port, int power_role, int data_role)
@@ -717,9 +904,9 @@ int tcpci_tcpm_set_rx_enable(int port, int enable)
 #ifdef CONFIG_USB_PD_FRS
 int tcpci_tcpc_fast_role_swap_enable(int port, int enable)
 {
-	return tcpc_update8(port, TCPC_REG_POWER_CTRL,
-			    TCPC_REG_POWER_CTRL_FRS_ENABLE,
-			    (enable) ? MASK_SET : MASK_CLR);
+	return tcpci_reg_update(port, TCPC_REG_POWER_CTRL,
+				TCPC_REG_POWER_CTRL_FRS_ENABLE,
+				(enable) ? MASK_SET : MASK_CLR);
 }
 #endif
 
@@ -898,7 +1085,7 @@ int tcpm_enqueue_message(const int port)
 	atomic_add(&q->head, 1);
 
 	/* Wake PD task up so it can process incoming RX messages */
-	task_set_event(PD_PORT_TO_TASK_ID(port), TASK_EVENT_WAKE);
+	pd_task_set_event(port, TASK_EVENT_WAKE);
 
 	return EC_SUCCESS;
 }
@@ -1090,6 +1277,8 @@ int tcpci_hard_reset_reinit(int port)
 {
 	int rv;
 
+	tcpci_reg_cache_invalidate(port);
+
 	/* Initialize power_status_mask */
 	rv = init_power_status_mask(port);
 	/* Initialize alert_mask */
@@ -1105,11 +1294,12 @@ enum ec_error_list tcpci_set_bist_test_mode(const int port, const bool enable)
 {
 	int rv;
 
-	rv = tcpc_update8(port, TCPC_REG_TCPC_CTRL,
-			  TCPC_REG_TCPC_CTRL_BIST_TEST_MODE,
-			  enable ? MASK_SET : MASK_CLR);
-	rv |= tcpc_update16(port, TCPC_REG_ALERT_MASK, TCPC_REG_ALERT_RX_STATUS,
-			    enable ? MASK_CLR : MASK_SET);
+	rv = tcpci_reg_update(port, TCPC_REG_TCPC_CTRL,
+			      TCPC_REG_TCPC_CTRL_BIST_TEST_MODE,
+			      enable ? MASK_SET : MASK_CLR);
+	rv |= tcpci_reg_update(port, TCPC_REG_ALERT_MASK,
+			       TCPC_REG_ALERT_RX_STATUS,
+			       enable ? MASK_CLR : MASK_SET);
 	return rv;
 }
 
@@ -1118,7 +1308,7 @@ enum ec_error_list tcpci_get_bist_test_mode(const int port, bool *enable)
 	int rv;
 	int val;
 
-	rv = tcpc_read(port, TCPC_REG_TCPC_CTRL, &val);
+	rv = tcpci_reg_read(port, TCPC_REG_TCPC_CTRL, &val);
 	*enable = !!(val & TCPC_REG_TCPC_CTRL_BIST_TEST_MODE);
 
 	return rv;
@@ -1202,6 +1392,10 @@ void tcpci_tcpc_alert(int port)
 	int retval = 0;
 	bool bist_mode;
 
+	/* The CC status may be the cause of the alert. */
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, TCPC_REG_CC_STATUS);
+
 	/* Read the Alert register from the TCPC */
 	if (tcpm_alert_status(port, &alert)) {
 		CPRINTS("C%d: Failed to read alert register", port);
@@ -1352,8 +1546,10 @@ void tcpci_tcpc_alert(int port)
 	 * As TCPC not reset at this moment, no need to check pd reset status to
 	 * reduce I2C access time.(see b/229812911)
 	 */
-	if (!bist_mode && register_mask_reset(port))
+	if (!bist_mode && register_mask_reset(port)) {
+		tcpci_reg_cache_invalidate(port);
 		pd_event |= PD_EVENT_TCPC_RESET;
+	}
 
 	/*
 	 * Wait until all possible TCPC accesses in this function are complete
@@ -1363,7 +1559,7 @@ void tcpci_tcpc_alert(int port)
 	 * the next I2C transaction to the TCPC will cause it to wake again.
 	 */
 	if (pd_event)
-		task_set_event(PD_PORT_TO_TASK_ID(port), pd_event);
+		pd_task_set_event(port, pd_event);
 }
 
 test_mockable int tcpci_get_vbus_voltage_no_check(int port, int *vbus)
@@ -1499,6 +1695,9 @@ int tcpci_tcpm_init(int port)
 	if (port >= board_get_usb_pd_port_count())
 		return EC_ERROR_INVAL;
 
+	/* The TCPC may have been reset, or changed while in low power mode. */
+	tcpci_reg_cache_invalidate(port);
+
 	while (1) {
 		error = tcpci_tcpm_get_power_status(port, &power_status);
 		/*
@@ -1519,7 +1718,7 @@ int tcpci_tcpm_init(int port)
 	 * Alert assertion when CC_STATUS.Looking4Connection changes state.
 	 */
 	if (tcpc_config[port].flags & TCPC_FLAGS_TCPCI_REV2_0) {
-		error = tcpc_update8(
+		error = tcpci_reg_update(
 			port, TCPC_REG_TCPC_CTRL,
 			TCPC_REG_TCPC_CTRL_EN_LOOK4CONNECTION_ALERT, MASK_SET);
 		if (error)
@@ -1555,11 +1754,12 @@ int tcpci_tcpm_init(int port)
 	}
 
 	/* Enable/disable VBUS monitor by the flag */
-	error = tcpc_update8(port, TCPC_REG_POWER_CTRL,
-			     TCPC_REG_POWER_CTRL_VBUS_VOL_MONITOR_DIS,
-			     tcpc_config[port].flags & TCPC_FLAGS_VBUS_MONITOR ?
-				     MASK_CLR :
-				     MASK_SET);
+	error = tcpci_reg_update(port, TCPC_REG_POWER_CTRL,
+				 TCPC_REG_POWER_CTRL_VBUS_VOL_MONITOR_DIS,
+				 tcpc_config[port].flags &
+						 TCPC_FLAGS_VBUS_MONITOR ?
+					 MASK_CLR :
+					 MASK_SET);
 	if (error)
 		return error;
 
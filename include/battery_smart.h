@@ -183,6 +183,12 @@ int sb_read_sized_block(int offset, uint8_t *data, int len);
 /* Write to battery */
 int sb_write(int cmd, int param);
 
+/**
+ * Drop every register held in the smart battery register cache, so that the
+ * next accesses read them from the battery again.
+ */
+void sb_cache_invalidate(void);
+
 /**
  * Write block to do battery cutoff
  *
@@ -548,6 +548,19 @@
  */
 #undef CONFIG_BATTERY_SMART
 
+/*
+ * Cache the smart battery registers read by the charger and the host, and
+ * serve them until they are older than a per-register maximum age.
+ */
+#undef CONFIG_BATTERY_SMART_CACHE
+
+/*
+ * The smart battery can read consecutive registers in a single transaction.
+ * Stale registers of the cache are then refreshed together. Requires
+ * CONFIG_BATTERY_SMART_CACHE.
+ */
+#undef CONFIG_BATTERY_SMART_BURST_READ
+
 /* Chemistry of the battery device */
 #undef CONFIG_BATTERY_DEVICE_CHEMISTRY
 
@@ -718,6 +731,17 @@
  */
 #undef CONFIG_CHARGE_STATE_DEBUG
 
+/*
+ * Let the charge_state loop be driven by events: while nothing it acts on
+ * changes, the default poll period is doubled on each loop, up to
+ * 2^CONFIG_CHARGE_STATE_MAX_POLL_SHIFT times, so the charger and the battery
+ * are only polled for drift. charge_wakeup() calls, e.g. from charger or
+ * fuel gauge interrupts and charge_manager updates, restore the default
+ * period.
+ */
+#undef CONFIG_CHARGE_STATE_EVENT_DRIVEN
+#define CONFIG_CHARGE_STATE_MAX_POLL_SHIFT 4
+
 /* Include support for Bluetooth LE */
 #undef CONFIG_BLUETOOTH_LE
 
@@ -1900,6 +1924,17 @@
 /* The default .flags field value is zero, unless overridden with this. */
 #undef CONFIG_CONSOLE_COMMAND_FLAGS_DEFAULT
 
+/*
+ * The console commands are sorted by name in the .rodata.cmds section so use
+ * the binary search algorithm to match a command name (or unique prefix) to
+ * its handler. All command names must be lower case for this to work.
+ *
+ * Like CONFIG_HOSTCMD_SECTION_SORTED, this only applies to the EC console
+ * command table: Zephyr builds register console commands with the shell, so
+ * there is no Kconfig option for it.
+ */
+#undef CONFIG_CONSOLE_CMD_SECTION_SORTED
+
 /*
  * Enable EC_CMD_CONSOLE_READ V1. One could disable this config to prevent
  * kernel from creating the `console_log` debugfs entry.
@@ -2554,6 +2589,27 @@
  */
 #undef CONFIG_HOSTCMD_SECTION_SORTED
 
+/*
+ * Build a two-level index of the host commands when the host command task
+ * starts, so matching a command to its handler takes a couple of loads. Each
+ * index page covers 64 command codes and costs 64 bytes of RAM, on top of a
+ * 256 byte directory. Commands which don't fit in CONFIG_HOSTCMD_INDEX_PAGES
+ * pages fall back to the normal (or CONFIG_HOSTCMD_SECTION_SORTED) search.
+ *
+ * This only applies to the EC host command table: Zephyr builds look up host
+ * commands in their own iterable section, so there is no Kconfig option for it.
+ */
+#undef CONFIG_HOSTCMD_SECTION_INDEXED
+#define CONFIG_HOSTCMD_INDEX_PAGES 12
+
+/*
+ * Collect per-command host command handler timing statistics, reported by
+ * EC_CMD_HOST_COMMAND_STATS. Statistics are kept for up to
+ * CONFIG_HOST_COMMAND_STATS_SLOTS distinct commands.
+ */
+#undef CONFIG_HOST_COMMAND_STATS
+#define CONFIG_HOST_COMMAND_STATS_SLOTS 32
+
 /*
  * Host command parameters and response are 32-bit aligned.  This generates
  * much more efficient code on ARM.
@@ -2687,12 +2743,23 @@
 /*****************************************************************************/
 /* CRC configuration */
 
-/* Enable the hardware accelerator for CRC computation */
+/*
+ * Enable the hardware accelerator for CRC computation. Only the STM32 CRC
+ * unit is supported, and it must accept byte writes to its data register
+ * (STM32_CRC_DR8, defined for every STM32 family in chip/stm32/registers.h).
+ */
 #undef CONFIG_HW_CRC
 
 /* Enable the software routine for CRC computation */
 #undef CONFIG_SW_CRC
 
+/*
+ * Number of bytes the software CRC-32 routine folds in per step: 1 uses a
+ * 1 KiB lookup table, 4 and 8 (slicing-by-4/8) use 4 KiB and 8 KiB of tables
+ * in flash to run several times faster.
+ */
+#define CONFIG_SW_CRC32_SLICES 1
+
 /*****************************************************************************/
 
 /* Enable system hibernate */
@@ -2770,6 +2837,16 @@
 #endif /* CONFIG_ZEPHYR */
 #undef CONFIG_I2C_DEBUG
 #undef CONFIG_I2C_DEBUG_PASSTHRU
+
+/*
+ * Collect per-peripheral I2C transaction statistics, reported by the
+ * "i2ctrace stats" console command and EC_CMD_I2C_STATS. Requires
+ * CONFIG_I2C_DEBUG. Statistics are kept for up to CONFIG_I2C_STATS_SLOTS
+ * distinct port and peripheral address pairs.
+ */
+#undef CONFIG_I2C_STATS
+#define CONFIG_I2C_STATS_SLOTS 16
+
 #undef CONFIG_I2C_PASSTHRU_RESTRICTED
 #undef CONFIG_I2C_VIRTUAL_BATTERY
 
@@ -2808,6 +2885,13 @@
  */
 #undef CONFIG_I2C_XFER_BOARD_CALLBACK
 
+/*
+ * Enable i2c_xfer_submit(), to queue I2C requests which are executed from the
+ * hooks task. The requests queued for a port are executed back-to-back under
+ * a single bus lock, one port per deferred call.
+ */
+#undef CONFIG_I2C_XFER_ASYNC
+
 /*
  * EC uses an I2C controller interface.
  * Note: if this is defined, i2c_init() will be called
@@ -4322,6 +4406,14 @@
  */
 #define CONFIG_TASK_PROFILING
 
+/*
+ * Record, per task, the time from task_set_event() to the task actually being
+ * switched in. Reported by the taskinfo console command and
+ * EC_CMD_TASK_WAKE_LATENCY. Only the Cortex-M (not Cortex-M0), host and Zephyr
+ * task code record it; other cores fail to build with this option.
+ */
+#undef CONFIG_TASK_WAKE_LATENCY
+
 /*****************************************************************************/
 /* Mock config */
 
@@ -4659,6 +4751,22 @@
 #define CONFIG_USB_PE_SM
 #define CONFIG_USB_DPM_SM
 
+/*
+ * Define to count the transitions of each TCPMv2 state machine and measure
+ * the time spent in their entry and exit functions. The statistics are
+ * reported by the "pd <port> sm" console command.
+ */
+#undef CONFIG_USB_SM_STATS
+
+/*
+ * Define to record the messages sent and received by each port, and the
+ * transitions of its TCPMv2 state machines, in a trace buffer of
+ * CONFIG_USB_PD_TRACE_ENTRIES entries (a power of two) per port. The trace
+ * is read with EC_CMD_PD_TRACE.
+ */
+#undef CONFIG_USB_PD_TRACE
+#define CONFIG_USB_PD_TRACE_ENTRIES 64
+
 /* Enables PD Console commands */
 #define CONFIG_USB_PD_CONSOLE_CMD
 
@@ -4746,6 +4854,23 @@
  */
 #define CONFIG_USB_PD_STARTUP_DELAY_MS 0
 
+/*
+ * Define to let an idle TCPMv2 PD task sleep until the next PD timer expires
+ * or an event is received, instead of running the state machines at least
+ * every 5 ms. The task still polls for a short time after each event so that
+ * the state machines settle. The TCPC and VBUS detection must generate events
+ * on every change.
+ */
+#undef CONFIG_USB_PD_TASK_TICKLESS
+
+/*
+ * Define to run the TCPMv2 state machines of all the ports in a single PD task
+ * (TASK_ID_PD_C0), instead of one PD task per port. This saves the stack of
+ * the other PD tasks, but a port may have to wait for the other ports to be
+ * serviced. Events must be sent to a port with pd_task_set_event().
+ */
+#undef CONFIG_USB_PD_TASK_SHARED
+
 /*
  * Define if this board is using runtime flags instead of build time configs
  * to control USB PD properties.
@@ -5020,6 +5145,18 @@
 #undef CONFIG_USB_PD_TCPM_STM32GX
 #undef CONFIG_USB_PD_TCPM_CCGXXF
 
+/*
+ * Keep a per-port shadow of the TCPCI control registers (ROLE_CONTROL,
+ * POWER_CONTROL, TCPC_CONTROL, ALERT_MASK) and of CC_STATUS between alerts,
+ * so that read-modify-write operations and repeated CC queries by the TCPCI
+ * driver do not go over I2C. The shadow is invalidated on alerts, TCPC
+ * (re)initialization and low power mode transitions.
+ *
+ * Drivers which change these registers without going through the tcpc_*()
+ * accessors must call tcpci_reg_cache_invalidate().
+ */
+#undef CONFIG_USB_PD_TCPCI_REG_CACHE
+
 /* PS8XXX series are all supported by a single driver with a build time config
  * listed below (CONFIG_USB_PD_TCPM_PS*) defined to enable the specific product.
  *
@@ -6297,6 +6434,13 @@
 #define CONFIG_TEMP_SENSOR
 #endif
 
+/******************************************************************************/
+/* Smart battery burst reads refresh the smart battery register cache. */
+#if defined(CONFIG_BATTERY_SMART_BURST_READ) && \
+	!defined(CONFIG_BATTERY_SMART_CACHE)
+#define CONFIG_BATTERY_SMART_CACHE
+#endif
+
 /******************************************************************************/
 /* The Matrix Keyboard Protocol depends on MKBP input devices and events. */
 #ifdef CONFIG_KEYBOARD_PROTOCOL_MKBP
@@ -305,6 +305,22 @@ int tcpci_get_cached_rp(int port);
 void tcpci_set_cached_pull(int port, enum tcpc_cc_pull pull);
 enum tcpc_cc_pull tcpci_get_cached_pull(int port);
 
+#ifdef CONFIG_USB_PD_TCPCI_REG_CACHE
+/**
+ * Drop the register shadow of a port
+ *
+ * Needed when the TCPC registers may have changed behind the back of the
+ * tcpc_*() accessors, e.g. after a chip reset.
+ *
+ * @param port	USB-C port number
+ */
+void tcpci_reg_cache_invalidate(int port);
+#else
+static inline void tcpci_reg_cache_invalidate(int port)
+{
+}
+#endif
+
 void tcpci_tcpc_alert(int port);
 int tcpci_tcpm_init(int port);
 int tcpci_tcpm_get_cc(int port, enum tcpc_cc_voltage_status *cc1,
@@ -34,6 +34,12 @@
 
 #ifndef CONFIG_USB_PD_TCPC
 
+/*
+ * Drop the TCPCI register shadow of a register which was just written through
+ * one of the wrappers below, see CONFIG_USB_PD_TCPCI_REG_CACHE.
+ */
+void tcpci_reg_cache_clobber(int port, int reg);
+
 /* I2C wrapper functions - get I2C port / peripheral addr from config struct. */
 #ifndef CONFIG_USB_PD_TCPC_LOW_POWER
 static inline int tcpc_addr_write(int port, int i2c_addr, int reg, int val)
@@ -113,17 +119,29 @@ static inline int tcpc_write_block(int port, int reg, const uint8_t *out,
 static inline int tcpc_update8(int port, int reg, uint8_t mask,
 			       enum mask_update_action action)
 {
-	return i2c_update8(tcpc_config[port].i2c_info.port,
-			   tcpc_config[port].i2c_info.addr_flags, reg, mask,
-			   action);
+	int rv;
+
+	rv = i2c_update8(tcpc_config[port].i2c_info.port,
+			 tcpc_config[port].i2c_info.addr_flags, reg, mask,
+			 action);
+
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+	return rv;
 }
 
 static inline int tcpc_update16(int port, int reg, uint16_t mask,
 				enum mask_update_action action)
 {
-	return i2c_update16(tcpc_config[port].i2c_info.port,
-			    tcpc_config[port].i2c_info.addr_flags, reg, mask,
-			    action);
+	int rv;
+
+	rv = i2c_update16(tcpc_config[port].i2c_info.port,
+			  tcpc_config[port].i2c_info.addr_flags, reg, mask,
+			  action);
+
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+	return rv;
 }
 
 #else /* !CONFIG_USB_PD_TCPC_LOW_POWER */
@@ -148,14 +166,26 @@ int tcpc_update16(int port, int reg, uint16_t mask,
 
 static inline int tcpc_write(int port, int reg, int val)
 {
-	return tcpc_addr_write(port, tcpc_config[port].i2c_info.addr_flags, reg,
-			       val);
+	int rv;
+
+	rv = tcpc_addr_write(port, tcpc_config[port].i2c_info.addr_flags, reg,
+			     val);
+
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+	return rv;
 }
 
 static inline int tcpc_write16(int port, int reg, int val)
 {
-	return tcpc_addr_write16(port, tcpc_config[port].i2c_info.addr_flags,
-				 reg, val);
+	int rv;
+
+	rv = tcpc_addr_write16(port, tcpc_config[port].i2c_info.addr_flags,
+			       reg, val);
+
+	if (IS_ENABLED(CONFIG_USB_PD_TCPCI_REG_CACHE))
+		tcpci_reg_cache_clobber(port, reg);
+	return rv;
 }
 
 static inline int tcpc_read(int port, int reg, int *val)
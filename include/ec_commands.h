@@ -2840,6 +2840,12 @@ enum motionsense_command {
 	 */
 	MOTIONSENSE_CMD_GET_ACTIVITY = 20,
 
+	/*
+	 * Return a portion of the fifo, packed in a more compact format than
+	 * MOTIONSENSE_CMD_FIFO_READ: see ec_response_motion_sense_fifo_packed.
+	 */
+	MOTIONSENSE_CMD_FIFO_READ_PACKED = 21,
+
 	/* Number of motionsense sub-commands. */
 	MOTIONSENSE_NUM_CMDS,
 };
@@ -2964,6 +2970,43 @@ struct ec_response_motion_sense_fifo_data {
 	struct ec_response_motion_sensor_data data[0];
 } __ec_todo_packed;
 
+/*
+ * MOTIONSENSE_CMD_FIFO_READ_PACKED returns the same fifo entries as
+ * MOTIONSENSE_CMD_FIFO_READ, encoded as a stream of variable length records.
+ * Each record starts with a header byte holding the record type in its top
+ * 2 bits and, for the compact records, the sensor number in the low 6 bits:
+ *
+ * - EC_MOTION_PACKED_FULL: followed by the whole
+ *   struct ec_response_motion_sensor_data (9 bytes).
+ * - EC_MOTION_PACKED_TIMESTAMP: a timestamp entry, followed by its flags
+ *   (uint8_t) and its distance in us from the previous timestamp entry of
+ *   the response (uint16_t) (4 bytes). Its reserved field reads as 0.
+ * - EC_MOTION_PACKED_DELTA: a data entry, followed by its flags (uint8_t) and
+ *   the difference between each of its 3 axes and the previous data entry of
+ *   the same sensor in the response (int8_t[3]) (5 bytes).
+ *
+ * Only sensors below EC_MOTION_PACKED_MAX_SENSORS use DELTA records.  The
+ * deltas are reset at the start of each response, so each response decodes
+ * on its own.
+ */
+#define EC_MOTION_PACKED_TYPE_SHIFT 6
+#define EC_MOTION_PACKED_SENSOR_MASK 0x3f
+#define EC_MOTION_PACKED_MAX_SENSORS 16
+
+enum ec_motion_packed_type {
+	EC_MOTION_PACKED_FULL = 0,
+	EC_MOTION_PACKED_TIMESTAMP = 1,
+	EC_MOTION_PACKED_DELTA = 2,
+};
+
+struct ec_response_motion_sense_fifo_packed {
+	/* Number of fifo entries encoded in data */
+	uint16_t number_data;
+	/* Number of bytes of data */
+	uint16_t size;
+	uint8_t data[0];
+} __ec_todo_packed;
+
 /* List supported activity recognition */
 enum motionsensor_activity {
 	MOTIONSENSE_ACTIVITY_RESERVED = 0,
@@ -3147,14 +3190,14 @@ struct ec_params_motion_sense {
 		/* Used for MOTIONSENSE_CMD_FIFO_INFO */
 		/* (no params) */
 
-		/* Used for MOTIONSENSE_CMD_FIFO_READ */
+		/* Used for MOTIONSENSE_CMD_FIFO_READ and FIFO_READ_PACKED */
 		struct __ec_todo_unpacked {
 			/*
 			 * Number of expected vector to return.
 			 * EC may return less or 0 if none available.
 			 */
 			uint32_t max_data_vector;
-		} fifo_read;
+		} fifo_read, fifo_read_packed;
 
 		/* Used for MOTIONSENSE_CMD_SET_ACTIVITY */
 		struct ec_motion_sense_activity set_activity;
@@ -3349,6 +3392,8 @@ struct ec_response_motion_sense {
 
 		struct ec_response_motion_sense_fifo_data fifo_read;
 
+		struct ec_response_motion_sense_fifo_packed fifo_read_packed;
+
 		struct ec_response_online_calibration_data online_calib_read;
 
 		struct __ec_todo_packed {
@@ -8440,6 +8485,229 @@ struct ec_response_get_boot_time {
 	uint16_t cnt;
 } __ec_align4;
 
+/*
+ * Get host command handler timing statistics.
+ *
+ * The EC keeps a call count, min/max/total handler time and a histogram of
+ * handler time for each host command it has handled, in a fixed number of
+ * slots. Histogram bucket 0 counts calls taking less than 2 us, bucket n
+ * counts calls taking [2^n, 2^(n+1)) us and the last bucket also counts
+ * anything longer. Histogram counts saturate at UINT16_MAX.
+ */
+#define EC_CMD_HOST_COMMAND_STATS 0x0605
+
+#define EC_HOST_COMMAND_STATS_BUCKETS 16
+
+enum ec_host_command_stats_action {
+	EC_HOST_COMMAND_STATS_GET = 0,
+	EC_HOST_COMMAND_STATS_RESET = 1,
+};
+
+struct ec_params_host_command_stats {
+	uint8_t action; /* enum ec_host_command_stats_action */
+	uint8_t reserved;
+	/* First slot to return, for EC_HOST_COMMAND_STATS_GET */
+	uint16_t index;
+} __ec_align2;
+
+struct ec_host_command_stats_slot {
+	uint16_t command;
+	uint16_t reserved;
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint16_t histogram[EC_HOST_COMMAND_STATS_BUCKETS];
+} __ec_align4;
+
+struct ec_response_host_command_stats {
+	uint16_t num_slots; /* Number of slots in use */
+	uint16_t count; /* Number of slots returned */
+	uint32_t untracked; /* Calls to commands that didn't get a slot */
+	struct ec_host_command_stats_slot slots[];
+} __ec_align4;
+
+/*
+ * Get task wake-up latency statistics.
+ *
+ * Returns the number of wake-ups, the maximum latency and a histogram of the
+ * time between an event being set for a task and that task being switched in,
+ * using the same power-of-two microsecond buckets as
+ * EC_CMD_HOST_COMMAND_STATS.
+ */
+#define EC_CMD_TASK_WAKE_LATENCY 0x0606
+
+#define EC_TASK_WAKE_LATENCY_BUCKETS 16
+
+/* Reset statistics of all tasks after reading */
+#define EC_TASK_WAKE_LATENCY_RESET BIT(0)
+
+struct ec_params_task_wake_latency {
+	uint8_t task_id;
+	uint8_t flags; /* EC_TASK_WAKE_LATENCY_* */
+} __ec_align1;
+
+struct ec_response_task_wake_latency {
+	uint8_t num_tasks;
+	uint8_t reserved[3];
+	uint32_t wakeups;
+	uint32_t max_us;
+	uint16_t histogram[EC_TASK_WAKE_LATENCY_BUCKETS];
+} __ec_align4;
+
+/*
+ * Get I2C bus statistics.
+ *
+ * For each I2C port and peripheral address, the EC keeps the number of
+ * transactions, bytes moved, bus busy time, retries, timeouts and other
+ * errors, and a histogram of transaction time using the same power-of-two
+ * microsecond buckets as EC_CMD_HOST_COMMAND_STATS. The statistics are kept
+ * in a fixed number of slots, read a few at a time starting at index.
+ */
+#define EC_CMD_I2C_STATS 0x0607
+
+#define EC_I2C_STATS_BUCKETS 16
+
+enum ec_i2c_stats_action {
+	EC_I2C_STATS_GET = 0,
+	EC_I2C_STATS_RESET = 1,
+};
+
+struct ec_params_i2c_stats {
+	uint8_t action; /* enum ec_i2c_stats_action */
+	uint8_t reserved;
+	/* First slot to return, for EC_I2C_STATS_GET */
+	uint16_t index;
+} __ec_align2;
+
+struct ec_i2c_stats_slot {
+	uint8_t port;
+	uint8_t reserved;
+	uint16_t addr; /* 7-bit or 10-bit peripheral address, without flags */
+	uint32_t count; /* Transactions, including failed ones */
+	uint32_t bytes; /* Bytes written and read */
+	uint32_t retries; /* Transaction attempts retried on a busy bus */
+	uint32_t timeouts;
+	uint32_t errors; /* Failed transactions, other than timeouts */
+	uint32_t max_us;
+	uint64_t busy_us; /* Total transaction time */
+	uint16_t histogram[EC_I2C_STATS_BUCKETS];
+} __ec_align4;
+
+struct ec_response_i2c_stats {
+	uint16_t num_slots; /* Number of slots in use */
+	uint16_t count; /* Number of slots returned */
+	/* Transactions with peripherals that didn't get a slot */
+	uint32_t untracked;
+	struct ec_i2c_stats_slot slots[];
+} __ec_align4;
+
+/*
+ * Read the USB PD message trace of a port.
+ *
+ * The EC records the messages sent and received by the protocol layer and
+ * the transitions of the policy engine and Type-C state machines of each port
+ * in a ring buffer, with a microsecond timestamp. Each recorded entry gets the
+ * next sequence number of the port. The EC returns the entries starting at
+ * the requested sequence number, or at the oldest entry still in the buffer if
+ * the requested ones have been overwritten.
+ *
+ * The state transitions are recorded as state numbers, which are private to
+ * the EC firmware. EC_PD_TRACE_PE_STATE_NAME and EC_PD_TRACE_TC_STATE_NAME
+ * return the name of a state, if the EC was built with the state names.
+ */
+#define EC_CMD_PD_TRACE 0x0608
+
+enum ec_pd_trace_action {
+	EC_PD_TRACE_GET = 0,
+	/* Drop the recorded entries of the port */
+	EC_PD_TRACE_RESET = 1,
+	/* Return the name of a policy engine state */
+	EC_PD_TRACE_PE_STATE_NAME = 2,
+	/* Return the name of a Type-C state machine state */
+	EC_PD_TRACE_TC_STATE_NAME = 3,
+};
+
+struct ec_params_pd_trace {
+	uint8_t port;
+	uint8_t action; /* enum ec_pd_trace_action */
+	uint16_t reserved;
+	/*
+	 * Sequence number of the first entry to return, for EC_PD_TRACE_GET,
+	 * or state number, for EC_PD_TRACE_{PE,TC}_STATE_NAME.
+	 */
+	uint32_t seq;
+} __ec_align4;
+
+enum ec_pd_trace_type {
+	/*
+	 * The policy engine asked to send a message. data holds the message
+	 * type, and EC_PD_TRACE_REQ_DATA or EC_PD_TRACE_REQ_EXT for data and
+	 * extended messages.
+	 */
+	EC_PD_TRACE_TX_REQUEST = 0,
+	/* A message was passed to the TCPC. data holds its header. */
+	EC_PD_TRACE_TX_START = 1,
+	/*
+	 * The TCPC reported the end of the transmission. data holds the
+	 * enum ec_pd_trace_tx_status.
+	 */
+	EC_PD_TRACE_TX_STATUS = 2,
+	/*
+	 * The protocol layer reported the transmission to the policy engine.
+	 * data holds the enum ec_pd_trace_tx_status.
+	 */
+	EC_PD_TRACE_TX_COMPLETE = 3,
+	/* A message was received. data holds its header. */
+	EC_PD_TRACE_RX = 4,
+	/* The policy engine entered a state. data holds the state number. */
+	EC_PD_TRACE_PE_STATE = 5,
+	/* The Type-C state machine entered a state. data holds the number. */
+	EC_PD_TRACE_TC_STATE = 6,
+	/*
+	 * The VDM header of a Vendor_Defined message, recorded right after its
+	 * EC_PD_TRACE_TX_START or EC_PD_TRACE_RX entry. data holds the SVID,
+	 * and sop bits 0-7 of the VDM header: the command and command type of
+	 * a structured VDM. Bit 5, reserved in structured VDMs, is set for
+	 * unstructured ones.
+	 */
+	EC_PD_TRACE_VDM = 7,
+};
+
+#define EC_PD_TRACE_VDM_UNSTRUCTURED BIT(5)
+
+#define EC_PD_TRACE_REQ_DATA BIT(8)
+#define EC_PD_TRACE_REQ_EXT BIT(9)
+
+enum ec_pd_trace_tx_status {
+	EC_PD_TRACE_TX_SUCCESS = 0, /* GoodCRC received */
+	EC_PD_TRACE_TX_DISCARDED = 1,
+	EC_PD_TRACE_TX_FAILED = 2,
+};
+
+struct ec_pd_trace_entry {
+	uint32_t time_us; /* Lower 32 bits of the EC time */
+	uint8_t type; /* enum ec_pd_trace_type */
+	/*
+	 * SOP* type of the message, as in the TCPCI TRANSMIT register, or
+	 * the VDM command for EC_PD_TRACE_VDM
+	 */
+	uint8_t sop;
+	uint16_t data;
+} __ec_align4;
+
+struct ec_response_pd_trace {
+	uint32_t seq; /* Sequence number of the first entry returned */
+	uint32_t next_seq; /* Sequence number of the next entry to record */
+	uint16_t count; /* Number of entries returned */
+	uint16_t reserved;
+	struct ec_pd_trace_entry entries[];
+} __ec_align4;
+
+struct ec_response_pd_trace_state_name {
+	char name[32];
+} __ec_align1;
+
 /*****************************************************************************/
 /*
  * Reserve a range of host commands for board-specific, experimental, or
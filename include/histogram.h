@@ -0,0 +1,25 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Power-of-two microsecond histograms, as used by the statistics commands */
+
+#ifndef __CROS_EC_HISTOGRAM_H
+#define __CROS_EC_HISTOGRAM_H
+
+#include <stdint.h>
+
+/**
+ * Estimate a percentile from a power-of-two microsecond histogram.
+ *
+ * @param histogram	Bucket counts, bucket n counts [2^n, 2^(n+1)) us
+ * @param buckets	Number of buckets, the last one is open ended
+ * @param max_us	Largest value recorded
+ * @param percent	Percentile to estimate
+ * @return Upper bound, in us, of the bucket holding the percentile.
+ */
+uint32_t histogram_percentile(const uint16_t *histogram, int buckets,
+			      uint32_t max_us, int percent);
+
+#endif /* __CROS_EC_HISTOGRAM_H */
@@ -12,6 +12,7 @@
 #include "gpio_signal.h"
 #include "host_command.h"
 #include "stddef.h"
+#include "task_id.h"
 
 /*
  * I2C Peripheral Address encoding
@@ -201,6 +202,69 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 		      const uint8_t *out, int out_size, uint8_t *in,
 		      int in_size, int flags);
 
+/*
+ * One transaction of an asynchronous request. Transactions can be chained
+ * through next to form a batch, which is executed back-to-back without
+ * releasing the bus.
+ */
+struct i2c_xfer_desc {
+	uint16_t addr_flags; /* Peripheral address and flags */
+	const uint8_t *out; /* Data to send */
+	int out_size; /* Number of bytes to send */
+	uint8_t *in; /* Destination buffer for received data */
+	int in_size; /* Number of bytes to receive */
+	struct i2c_xfer_desc *next; /* Next transaction of the batch */
+};
+
+struct i2c_xfer_req;
+
+/* Completion callback of an asynchronous request */
+typedef void (*i2c_xfer_complete_t)(struct i2c_xfer_req *req);
+
+/*
+ * Asynchronous I2C request. The request and its transactions are owned by
+ * the I2C engine from submission until completion, and must not be modified
+ * in the meantime.
+ */
+struct i2c_xfer_req {
+	int port; /* Port to access */
+	struct i2c_xfer_desc *xfer; /* First transaction of the batch */
+	/*
+	 * Called on completion from the hooks task, or NULL to set
+	 * event on task instead.
+	 */
+	i2c_xfer_complete_t complete;
+	task_id_t task;
+	uint32_t event;
+	/*
+	 * Result of the batch: EC_SUCCESS or the error of the first failed
+	 * transaction, in which case the following ones are not executed.
+	 */
+	int rv;
+	/* Private to the I2C engine */
+	bool pending;
+	struct i2c_xfer_req *link;
+};
+
+/**
+ * Queue an asynchronous I2C request.
+ *
+ * Requests are executed in submission order for each port. The requests
+ * queued for a port are executed back-to-back under a single bus lock.
+ * Before the tasks are started, the request is executed synchronously.
+ *
+ * The queue is run by the hooks task, one port per deferred call, so other
+ * deferred routines can run between the ports. The ports still share the
+ * hooks task: a slow transfer on one port delays the requests of the others.
+ * A request that signals its completion with an event must not target the
+ * hooks task, which can't wait for the queue it runs.
+ *
+ * @param req		Request to queue
+ * @return EC_SUCCESS if queued, EC_ERROR_BUSY if the request is already
+ *	   pending, or EC_ERROR_INVAL if the request is malformed.
+ */
+int i2c_xfer_submit(struct i2c_xfer_req *req);
+
 #define I2C_LINE_SCL_HIGH BIT(0)
 #define I2C_LINE_SDA_HIGH BIT(1)
 #define I2C_LINE_IDLE (I2C_LINE_SCL_HIGH | I2C_LINE_SDA_HIGH)
@@ -546,6 +610,19 @@ void i2c_trace_notify(int port, uint16_t addr_flags, const uint8_t *out_data,
 		      size_t out_size, const uint8_t *in_data, size_t in_size,
 		      int ret);
 
+/**
+ * Account an I2C transaction in the I2C statistics.
+ *
+ * @param port: I2C port number
+ * @param addr_flags: peripheral device address
+ * @param size: number of bytes written and read
+ * @param ret: return of i2c transaction (EC_SUCCESS or otherwise on failure)
+ * @param retries: number of attempts retried because the bus was busy
+ * @param us: transaction time, including retries
+ */
+void i2c_stats_notify(int port, uint16_t addr_flags, size_t size, int ret,
+		      int retries, uint32_t us);
+
 /**
  * Convert an enum i2c_freq constant to numeric frequency in kHz.
  *
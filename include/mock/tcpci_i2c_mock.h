@@ -16,6 +16,7 @@ void mock_tcpci_set_reg_bits(int reg_offset, uint16_t mask);
 void mock_tcpci_clr_reg_bits(int reg_offset, uint16_t mask);
 
 uint16_t mock_tcpci_get_reg(int reg_offset);
+int mock_tcpci_get_reg_reads(int reg_offset);
 
 int verify_tcpci_transmit(enum tcpci_msg_type tx_type,
 			  enum pd_ctrl_msg_type ctrl_msg,
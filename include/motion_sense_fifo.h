@@ -96,6 +96,19 @@ void motion_sense_fifo_stage_data(struct ec_response_motion_sensor_data *data,
  */
 void motion_sense_fifo_commit_data(void);
 
+/**
+ * Start a batch of commits. Until motion_sense_fifo_batch_end() is called,
+ * motion_sense_fifo_commit_data() still spreads the staged data, but does not
+ * make it readable to the AP.
+ */
+void motion_sense_fifo_batch_begin(void);
+
+/**
+ * Commit any staged data and make all the data committed since
+ * motion_sense_fifo_batch_begin() readable to the AP at once.
+ */
+void motion_sense_fifo_batch_end(void);
+
 /**
  * Get information about the fifo.
  *
@@ -126,6 +139,19 @@ int motion_sense_fifo_over_thres(void);
 int motion_sense_fifo_read(int capacity_bytes, int max_count, void *out,
 			   uint16_t *out_size);
 
+/**
+ * Read available committed entries from the fifo, packed in the format of
+ * MOTIONSENSE_CMD_FIFO_READ_PACKED.
+ *
+ * @param capacity_bytes The number of bytes available to be written to `out`.
+ * @param max_count The maximum number of entries to be packed in `out`.
+ * @param out The target to pack the data into.
+ * @param out_size The number of bytes written to `out`.
+ * @return The number of entries packed in `out`.
+ */
+int motion_sense_fifo_read_packed(int capacity_bytes, int max_count,
+				  void *out, uint16_t *out_size);
+
 /**
  * Reset the internal data structures of the motion sense fifo.
  */
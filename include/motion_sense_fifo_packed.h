@@ -0,0 +1,65 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Encoder and decoder for MOTIONSENSE_CMD_FIFO_READ_PACKED records. */
+
+#ifndef __CROS_EC_MOTION_SENSE_FIFO_PACKED_H
+#define __CROS_EC_MOTION_SENSE_FIFO_PACKED_H
+
+#include "common.h"
+#include "ec_commands.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Running state of an encoder or decoder, valid for one response.
+ * @timestamp: Last timestamp entry seen.
+ * @has_timestamp: True once a timestamp entry has been seen.
+ * @data: Last data entry seen, per sensor.
+ * @has_data: Bitmap of the sensors with a valid @data entry.
+ */
+struct motion_sense_fifo_packed_state {
+	uint32_t timestamp;
+	uint8_t has_timestamp;
+	uint16_t has_data;
+	int16_t data[EC_MOTION_PACKED_MAX_SENSORS][3];
+};
+
+/**
+ * Reset the state at the start of a response.
+ *
+ * @param state The encoder or decoder state.
+ */
+void motion_sense_fifo_packed_init(struct motion_sense_fifo_packed_state *state);
+
+/**
+ * Encode one fifo entry.
+ *
+ * @param state The encoder state, only updated if the entry fits.
+ * @param entry The entry to encode.
+ * @param out Where to write the record.
+ * @param size The number of bytes available at out.
+ * @return The number of bytes written, 0 if the record does not fit.
+ */
+int motion_sense_fifo_pack(struct motion_sense_fifo_packed_state *state,
+			   const struct ec_response_motion_sensor_data *entry,
+			   uint8_t *out, size_t size);
+
+/**
+ * Decode one fifo entry.
+ *
+ * @param state The decoder state.
+ * @param in The records to decode.
+ * @param size The number of bytes available at in.
+ * @param entry Where to write the decoded entry.
+ * @return The number of bytes consumed, 0 if the record is truncated or
+ *	   invalid.
+ */
+int motion_sense_fifo_unpack(struct motion_sense_fifo_packed_state *state,
+			     const uint8_t *in, size_t size,
+			     struct ec_response_motion_sensor_data *entry);
+
+#endif /* __CROS_EC_MOTION_SENSE_FIFO_PACKED_H */
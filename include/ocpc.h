@@ -35,9 +35,9 @@ struct ocpc_data {
 	int last_error;
 	int integral;
 	int last_vsys;
-#ifdef HAS_TASK_PD_C1
+#if defined(HAS_TASK_PD_C1) || defined(CONFIG_USB_PD_TASK_SHARED)
 	uint32_t chg_flags[CONFIG_USB_PD_PORT_MAX_COUNT];
-#endif /* HAS_TASK_PD_C1 */
+#endif /* HAS_TASK_PD_C1 || CONFIG_USB_PD_TASK_SHARED */
 };
 
 #define OCPC_NO_ISYS_MEAS_CAP BIT(0)
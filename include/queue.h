@@ -229,6 +229,41 @@ size_t
 queue_peek_memcpy(struct queue const *q, void *dest, size_t i, size_t count,
 		  void *(*memcpy)(void *dest, const void *src, size_t n));
 
+/*
+ * Single producer / single consumer (SPSC) access.
+ *
+ * When a queue has exactly one producer and one consumer, for example an
+ * interrupt handler adding units and a task removing them, the functions
+ * below can be used without disabling interrupts or holding a lock: they order
+ * the buffer accesses against the head and tail updates with memory barriers.
+ * The producer must only use the add / write chunk / advance tail functions
+ * and the consumer only the remove / read chunk / advance head ones.
+ *
+ * They never call the queue policy.  Instead, the caller notifies the other
+ * side once per batch, e.g. by setting a task event after adding a whole
+ * chunk, rather than once per unit.
+ */
+
+/* Return the largest contiguous block of free space from the tail. */
+struct queue_chunk queue_spsc_get_write_chunk(struct queue const *q);
+
+/* Return the largest contiguous block of units from the head. */
+struct queue_chunk queue_spsc_get_read_chunk(struct queue const *q);
+
+/* Publish count units written to a write chunk.  Returns units published. */
+size_t queue_spsc_advance_tail(struct queue const *q, size_t count);
+
+/* Release count units read from a read chunk.  Returns units released. */
+size_t queue_spsc_advance_head(struct queue const *q, size_t count);
+
+/* Add up to count units to the queue.  Returns the number of units added. */
+size_t queue_spsc_add_units(struct queue const *q, const void *src,
+			    size_t count);
+
+/* Remove up to count units.  Returns the number of units removed. */
+size_t queue_spsc_remove_units(struct queue const *q, void *dest,
+			       size_t count);
+
 /*
  * These macros will statically select the queue functions based on the number
  * of units that are to be added or removed if they can.  The single unit add
@@ -263,6 +263,28 @@ void task_end_irq_handler(void *excep_return);
 #define task_start_irq_handler(excep_return)
 #endif
 
+#ifdef CONFIG_TASK_WAKE_LATENCY
+/**
+ * Start timing the wake-up of a task an event is being set for, unless it is
+ * already waiting to be switched in or is the running task.
+ *
+ * Called by the core from task_set_event().
+ */
+void task_wake_latency_start(task_id_t tskid);
+
+/**
+ * Account the wake-up latency of a task being switched in.
+ *
+ * Called by the core when the task resumes running.
+ */
+void task_wake_latency_end(task_id_t tskid);
+
+/**
+ * Print the wake-up latency statistics of all the tasks.
+ */
+void task_print_wake_latency(void);
+#endif
+
 /**
  * Change the task scheduled to run after returning from the exception.
  *
@@ -14,8 +14,10 @@
 #ifndef __CROS_EC_USB_PD_H
 #define __CROS_EC_USB_PD_H
 
+#include "atomic.h"
 #include "common.h"
 #include "ec_commands.h"
+#include "task.h"
 #include "usb_pd_tbt.h"
 #include "usb_pd_tcpm.h"
 #include "usb_pd_vdo.h"
@@ -30,15 +32,84 @@
  * Define PD_PORT_TO_TASK_ID() and TASK_ID_TO_PD_PORT() macros to
  * go between PD port number and task ID. Assume that TASK_ID_PD_C0 is the
  * lowest task ID and IDs are on a continuous range.
+ *
+ * With CONFIG_USB_PD_TASK_SHARED, TASK_ID_PD_C0 services all the ports, and
+ * its port is the one it is currently servicing.
  */
 #if defined(HAS_TASK_PD_C0) && defined(CONFIG_USB_PD_PORT_MAX_COUNT)
+#ifdef CONFIG_USB_PD_TASK_SHARED
+#define PD_PORT_TO_TASK_ID(port) TASK_ID_PD_C0
+#define TASK_ID_TO_PD_PORT(id) \
+	((id) == TASK_ID_PD_C0 ? pd_task_current_port() : -1)
+#else
 #define PD_PORT_TO_TASK_ID(port) (TASK_ID_PD_C0 + (port))
 #define TASK_ID_TO_PD_PORT(id) ((id)-TASK_ID_PD_C0)
+#endif /* CONFIG_USB_PD_TASK_SHARED */
 #else
 #define PD_PORT_TO_TASK_ID(port) -1 /* stub task ID */
 #define TASK_ID_TO_PD_PORT(id) 0
 #endif /* CONFIG_USB_PD_PORT_MAX_COUNT && HAS_TASK_PD_C0 */
 
+#ifdef CONFIG_USB_PD_TASK_SHARED
+/**
+ * Get the port whose state machines the shared PD task is running.
+ *
+ * @return USB-C port number
+ */
+int pd_task_current_port(void);
+
+/**
+ * Send events to the PD task of a port.
+ *
+ * @param port USB-C port number
+ * @param event Events to send
+ */
+void pd_task_set_event(int port, uint32_t event);
+
+/**
+ * Clear events which are pending for the PD task of a port.
+ *
+ * @param port USB-C port number
+ * @param event Events to clear
+ */
+void pd_task_clear_event(int port, uint32_t event);
+#else
+static inline void pd_task_set_event(int port, uint32_t event)
+{
+	task_set_event(PD_PORT_TO_TASK_ID(port), event);
+}
+
+static inline void pd_task_clear_event(int port, uint32_t event)
+{
+	atomic_clear_bits(task_get_event_bitmap(PD_PORT_TO_TASK_ID(port)),
+			  event);
+}
+#endif /* CONFIG_USB_PD_TASK_SHARED */
+
+/**
+ * Wake the PD task of a port. This sends it the TASK_EVENT_WAKE event.
+ *
+ * @param port USB-C port number
+ */
+static inline void pd_task_wake(int port)
+{
+	pd_task_set_event(port, TASK_EVENT_WAKE);
+}
+
+/**
+ * Wake the PD task of a port, unless the caller is that task running the
+ * state machines of the port. Requests posted to the state machines from
+ * other tasks or interrupts use this, so that a tickless PD task notices them.
+ *
+ * @param port USB-C port number
+ */
+static inline void pd_task_wake_remote(int port)
+{
+	if (in_interrupt_context() ||
+	    TASK_ID_TO_PD_PORT(task_get_current()) != port)
+		pd_task_wake(port);
+}
+
 enum pd_rx_errors {
 	PD_RX_ERR_INVAL = -1, /* Invalid packet */
 	PD_RX_ERR_HARD_RESET = -2, /* Got a Hard-Reset packet */
@@ -0,0 +1,33 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* USB Power Delivery message trace */
+
+#ifndef __CROS_EC_USB_PD_TRACE_H
+#define __CROS_EC_USB_PD_TRACE_H
+
+#include "ec_commands.h"
+
+#include <stdint.h>
+
+#ifdef CONFIG_USB_PD_TRACE
+/**
+ * Record an event in the PD trace of a port. May be called from interrupts.
+ *
+ * @param port USB-C port number
+ * @param type Event type
+ * @param sop SOP* type of the message, or 0 for state transitions
+ * @param data Event data, see enum ec_pd_trace_type
+ */
+void pd_trace(int port, enum ec_pd_trace_type type, uint8_t sop,
+	      uint16_t data);
+#else
+static inline void pd_trace(int port, enum ec_pd_trace_type type, uint8_t sop,
+			    uint16_t data)
+{
+}
+#endif /* CONFIG_USB_PD_TRACE */
+
+#endif /* __CROS_EC_USB_PD_TRACE_H */
@@ -168,6 +168,14 @@ bool pe_in_local_ams(int port);
  */
 const char *pe_get_current_state(int port);
 
+/**
+ * Returns the name of a PE state
+ *
+ * @param state PE state number, as recorded in the PD trace
+ * @return name of the state, or NULL if unknown or not built in
+ */
+const char *pe_get_state_name(int state);
+
 /**
  * Returns the flag mask of the PE state machine
  *
@@ -200,6 +208,14 @@ int pe_set_ado(int port, uint32_t data);
  */
 void pe_clear_ado(int port);
 
+/**
+ * Get the transition statistics of the Policy Engine state machine
+ *
+ * @param port USB-C port number
+ * @return Statistics of the state machine
+ */
+struct sm_stats *pe_get_sm_stats(int port);
+
 #ifdef TEST_BUILD
 /**
  * Clears all internal port data, as we would on a detach event
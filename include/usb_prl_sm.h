@@ -151,4 +151,14 @@ void prl_execute_hard_reset(int port);
  */
 void prl_set_data_role_check(int port, bool enable);
 
+/**
+ * Get the transition statistics of one of the Protocol Layer state machines
+ *
+ * @param port USB-C port number
+ * @param sm Index of the state machine, starting at 0
+ * @param name Set to the name of the state machine
+ * @return Statistics of the state machine, NULL past the last one
+ */
+struct sm_stats *prl_get_sm_stats(int port, int sm, const char **name);
+
 #endif /* __CROS_EC_USB_PRL_H */
@@ -10,6 +10,8 @@
 
 #include "compiler.h" /* for typeof() on Zephyr */
 
+#include <stdint.h>
+
 /* Function pointer that implements a portion of a usb state */
 typedef void (*state_execution)(const int port);
 
@@ -37,12 +39,24 @@ struct usb_state {
 
 typedef const struct usb_state *usb_state_ptr;
 
+/* Transition statistics of a state machine */
+struct sm_stats {
+	/* Number of set_state() calls */
+	uint32_t transitions;
+	/* Time spent in set_state(), i.e. in exit and entry functions */
+	uint32_t max_us;
+	uint64_t total_us;
+};
+
 /* Defines the current context of the usb statemachine. */
 struct sm_ctx {
 	usb_state_ptr current;
 	usb_state_ptr previous;
 	/* We use intptr_t type to accommodate host tests ptr size variance */
 	intptr_t internal[2];
+#ifdef CONFIG_USB_SM_STATS
+	struct sm_stats stats;
+#endif
 };
 
 /* Local state machine states */
@@ -90,6 +104,14 @@ void set_state(int port, struct sm_ctx *ctx, usb_state_ptr new_state);
  */
 void run_state(int port, struct sm_ctx *ctx);
 
+/**
+ * Clears a state machine context, so that it starts over without any state.
+ * The transition statistics are kept.
+ *
+ * @param ctx  State machine context
+ */
+void reset_sm_ctx(struct sm_ctx *ctx);
+
 #ifdef TEST_BUILD
 /*
  * Struct for test builds that allow unit tests to easily iterate through
@@ -76,6 +76,14 @@ uint8_t tc_get_polarity(int port);
  */
 uint8_t tc_get_pd_enabled(int port);
 
+/**
+ * Get the transition statistics of the Type-C state machine
+ *
+ * @param port USB-C port number
+ * @return Statistics of the state machine
+ */
+struct sm_stats *tc_get_sm_stats(int port);
+
 /**
  * Set the power role
  *
@@ -324,6 +332,39 @@ void tc_start_event_loop(int port);
  */
 void tc_pause_event_loop(int port);
 
+/**
+ * Get the number of times the state machine event loop ran
+ *
+ * @param port USB-C port number
+ * @param timeouts Set to the number of runs caused by a timeout, may be NULL
+ * @return Number of runs since the last reset, see pd_task_reset_wakeups()
+ */
+uint32_t pd_task_get_wakeups(int port, uint32_t *timeouts);
+
+/**
+ * Get the time elapsed since the wakeup counters were reset
+ *
+ * @param port USB-C port number
+ * @return Time in microseconds
+ */
+uint64_t pd_task_wakeups_period(int port);
+
+/**
+ * Reset the wakeup counters of the state machine event loop
+ *
+ * @param port USB-C port number
+ */
+void pd_task_reset_wakeups(int port);
+
+/**
+ * Get the time the shared PD task took to service the events sent to a port
+ *
+ * @param port USB-C port number
+ * @param max_us Set to the maximum latency in microseconds, may be NULL
+ * @return Average latency in microseconds
+ */
+uint32_t pd_task_get_latency(int port, uint32_t *max_us);
+
 /**
  * Determine if the state machine event loop is paused
  *
@@ -358,6 +399,14 @@ enum try_src_override_t tc_get_try_src_override(void);
  */
 const char *tc_get_current_state(int port);
 
+/**
+ * Returns the name of a typeC state
+ *
+ * @param state typeC state number, as recorded in the PD trace
+ * @return name of the state, or NULL if unknown or not built in
+ */
+const char *tc_get_state_name(int state);
+
 /**
  * Returns the flag mask of the typeC state machine
  *
@@ -0,0 +1,137 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the smart battery register cache and its burst reads.
+ */
+
+#include "battery.h"
+#include "battery_smart.h"
+#include "common.h"
+#include "i2c.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+static int xfer_count;
+static struct batt_params batt;
+
+void battery_compensate_params(struct batt_params *batt)
+{
+}
+
+void board_battery_compensate_params(struct batt_params *batt)
+{
+}
+
+void i2c_start_xfer_notify(const int port, const uint16_t addr_flags)
+{
+	if (port == I2C_PORT_BATTERY)
+		xfer_count++;
+}
+
+void i2c_end_xfer_notify(const int port, const uint16_t addr_flags)
+{
+}
+
+static void setup_battery(void)
+{
+	sb_write(SB_BATTERY_MODE, 0);
+	sb_write(SB_TEMPERATURE, 2981);
+	sb_write(SB_VOLTAGE, 7400);
+	sb_write(SB_CURRENT, -500);
+	sb_write(SB_AVERAGE_CURRENT, -450);
+	sb_write(SB_RELATIVE_STATE_OF_CHARGE, 50);
+	sb_write(SB_REMAINING_CAPACITY, 2000);
+	sb_write(SB_FULL_CHARGE_CAPACITY, 4000);
+	sb_write(SB_CHARGING_CURRENT, 1000);
+	sb_write(SB_CHARGING_VOLTAGE, 8400);
+	sb_write(SB_BATTERY_STATUS, 0x40);
+
+	memset(&batt, 0, sizeof(batt));
+	xfer_count = 0;
+}
+
+static int test_burst_read(void)
+{
+	setup_battery();
+	battery_get_params(&batt);
+
+	TEST_ASSERT(!(batt.flags & BATT_FLAG_BAD_ANY));
+	TEST_EQ(batt.temperature, 2981, "%d");
+	TEST_EQ(batt.voltage, 7400, "%d");
+	TEST_EQ(batt.current, -500, "%d");
+	TEST_EQ(batt.state_of_charge, 50, "%d");
+	TEST_EQ(batt.remaining_capacity, 2000, "%d");
+	TEST_EQ(batt.full_capacity, 4000, "%d");
+	TEST_EQ(batt.desired_current, 1000, "%d");
+	TEST_EQ(batt.desired_voltage, 8400, "%d");
+	TEST_EQ(batt.status, 0x40, "%d");
+
+	/* Two bursts, and the battery mode read for the capacities. */
+	TEST_EQ(xfer_count, 3, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_cache_hit(void)
+{
+	setup_battery();
+	battery_get_params(&batt);
+
+	/* Everything is fresh, host readers are served from the cache. */
+	xfer_count = 0;
+	battery_get_params(&batt);
+	TEST_EQ(battery_get_avg_current(), -450, "%d");
+	TEST_EQ(xfer_count, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_fast_registers_expire(void)
+{
+	setup_battery();
+	battery_get_params(&batt);
+
+	sb_write(SB_VOLTAGE, 7300);
+	battery_get_params(&batt);
+	TEST_EQ(batt.voltage, 7300, "%d");
+
+	/* Only the voltage, the current and the status got stale. */
+	usleep(100 * MSEC);
+	xfer_count = 0;
+	battery_get_params(&batt);
+	TEST_EQ(xfer_count, 2, "%d");
+
+	/* Once a second, the slow registers are read again too. */
+	usleep(SECOND);
+	xfer_count = 0;
+	battery_get_params(&batt);
+	TEST_EQ(xfer_count, 2, "%d");
+	TEST_ASSERT(!(batt.flags & BATT_FLAG_BAD_ANY));
+
+	return EC_SUCCESS;
+}
+
+static int test_invalidate(void)
+{
+	setup_battery();
+	battery_get_params(&batt);
+
+	sb_cache_invalidate();
+	xfer_count = 0;
+	battery_get_params(&batt);
+	TEST_EQ(xfer_count, 3, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	RUN_TEST(test_burst_read);
+	RUN_TEST(test_cache_hit);
+	RUN_TEST(test_fast_registers_expire);
+	RUN_TEST(test_invalidate);
+
+	test_print_result();
+}
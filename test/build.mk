@@ -23,6 +23,7 @@ test-list-host  = aes
 test-list-host += always_memset
 test-list-host += battery_config
 test-list-host += battery_get_params_smart
+test-list-host += battery_smart_cache
 test-list-host += benchmark
 test-list-host += bklight_lid
 test-list-host += bklight_passthru
@@ -34,10 +35,12 @@ test-list-host += cbi_wp
 test-list-host += charge_manager
 test-list-host += charge_manager_drp_charging
 test-list-host += charge_ramp
+test-list-host += charge_state_events
 test-list-host += chipset
 test-list-host += compile_time_macros
 test-list-host += console_edit
 test-list-host += crc
+test-list-host += crc_benchmark
 test-list-host += debug_unimplemented
 test-list-host += entropy
 test-list-host += extpwr_gpio
@@ -55,8 +58,11 @@ test-list-host += gettimeofday
 test-list-host += gyro_cal
 test-list-host += hooks
 test-list-host += host_command
+test-list-host += host_command_benchmark
 test-list-host += hyperdebug
+test-list-host += i2c_async
 test-list-host += i2c_bitbang
+test-list-host += i2c_stats
 test-list-host += inductive_charging
 # This test times out in the CQ, and generally doesn't seem useful.
 # It is verifying the host test scheduler, which is never used in real boards.
@@ -80,6 +86,7 @@ test-list-host += math_util
 test-list-host += motion_angle
 test-list-host += motion_angle_tablet
 test-list-host += motion_lid
+test-list-host += motion_sense_benchmark
 test-list-host += motion_sense_fifo
 test-list-host += mutex
 test-list-host += newton_fit
@@ -94,6 +101,8 @@ test-list-host += rgb_keyboard
 test-list-host += rollback_secret
 test-list-host += rsa
 test-list-host += rsa3
+test-list-host += rsa3_benchmark
+test-list-host += rsa_benchmark
 test-list-host += rtc
 test-list-host += sbrk
 test-list-host += sbs_charging
@@ -111,6 +120,7 @@ test-list-host += std_vector
 test-list-host += system
 test-list-host += tablet_broken_sensor
 test-list-host += tablet_no_sensor
+test-list-host += task_wake_latency
 test-list-host += thermal
 test-list-host += timer
 test-list-host += timer_dos
@@ -134,6 +144,10 @@ test-list-host += usb_typec_ctvpd
 test-list-host += usb_typec_drp_acc_trysrc
 test-list-host += usb_prl_old
 test-list-host += usb_tcpmv2_compliance
+test-list-host += usb_tcpmv2_reg_cache
+test-list-host += usb_tcpmv2_trace
+test-list-host += usb_tcpmv2_tickless
+test-list-host += usb_tcpmv2_shared
 test-list-host += usb_prl
 test-list-host += usb_prl_noextended
 test-list-host += usb_pe_drp_old
@@ -143,6 +157,8 @@ test-list-host += usb_pe_drp_noextended
 test-list-host += utils
 test-list-host += utils_str
 test-list-host += vboot
+test-list-host += vboot_hash
+test-list-host += vec3_benchmark
 test-list-host += version
 test-list-host += x25519
 test-list-host += stillness_detector
@@ -183,6 +199,7 @@ always_memset-y=always_memset.o
 base32-y=base32.o
 battery_config-y=battery_config.o
 battery_get_params_smart-y=battery_get_params_smart.o
+battery_smart_cache-y=battery_smart_cache.o
 benchmark-y=benchmark.o
 bklight_lid-y=bklight_lid.o
 bklight_passthru-y=bklight_passthru.o
@@ -194,11 +211,13 @@ cbi_wp-y=cbi_wp.o
 charge_manager-y=charge_manager.o fake_usbc.o
 charge_manager_drp_charging-y=charge_manager.o fake_usbc.o
 charge_ramp-y+=charge_ramp.o
+charge_state_events-y=charge_state_events.o
 chipset-y+=chipset.o
 compile_time_macros-y=compile_time_macros.o
 console_edit-y=console_edit.o
 cortexm_fpu-y=cortexm_fpu.o
 crc-y=crc.o
+crc_benchmark-y=crc_benchmark.o
 debug-y=debug.o
 debug_unimplemented-y=debug_unimplemented.o
 entropy-y=entropy.o
@@ -221,8 +240,11 @@ global_initialization-y=global_initialization.o
 gyro_cal-y=gyro_cal.o gyro_cal_init_for_test.o
 hooks-y=hooks.o
 host_command-y=host_command.o
+host_command_benchmark-y=host_command_benchmark.o
 hyperdebug-y=hyperdebug.o
+i2c_async-y=i2c_async.o
 i2c_bitbang-y=i2c_bitbang.o
+i2c_stats-y=i2c_stats.o
 inductive_charging-y=inductive_charging.o
 interrupt-y=interrupt.o
 irq_locking-y=irq_locking.o
@@ -239,6 +261,8 @@ math_util-y=math_util.o
 motion_angle-y=motion_angle.o motion_angle_data_literals.o motion_common.o
 motion_angle_tablet-y=motion_angle_tablet.o motion_angle_data_literals_tablet.o motion_common.o
 motion_lid-y=motion_lid.o
+motion_sense_benchmark-y=motion_sense_benchmark.o \
+	motion_sense_benchmark_sensors.o motion_angle_data_literals.o
 motion_sense_fifo-y=motion_sense_fifo.o
 nvidia_gpu-y=nvidia_gpu.o
 online_calibration-y=online_calibration.o
@@ -265,6 +289,8 @@ rollback_entropy-y=rollback_entropy.o
 rollback_secret-y=rollback_secret.o
 rsa-y=rsa.o
 rsa3-y=rsa.o
+rsa3_benchmark-y=rsa_benchmark.o
+rsa_benchmark-y=rsa_benchmark.o
 rtc-y=rtc.o
 scratchpad-y=scratchpad.o
 sbrk-y=sbrk.o
@@ -282,6 +308,7 @@ system-y=system.o
 system_is_locked-y=system_is_locked.o
 tablet_broken_sensor-y=tablet_broken_sensor.o
 tablet_no_sensor-y=tablet_no_sensor.o
+task_wake_latency-y=task_wake_latency.o
 thermal-y=thermal.o
 timer_calib-y=timer_calib.o
 timer_dos-y=timer_dos.o
@@ -331,9 +358,15 @@ usb_tcpmv2_compliance-y=usb_tcpmv2_compliance.o usb_tcpmv2_compliance_common.o \
 	usb_tcpmv2_td_pd_snk3_e12.o \
 	usb_tcpmv2_td_pd_vndi3_e3.o \
 	usb_tcpmv2_td_pd_other.o
+usb_tcpmv2_reg_cache-y=$(usb_tcpmv2_compliance-y)
+usb_tcpmv2_trace-y=$(usb_tcpmv2_compliance-y)
+usb_tcpmv2_tickless-y=usb_tcpmv2_tickless.o usb_tcpmv2_compliance_common.o
+usb_tcpmv2_shared-y=usb_tcpmv2_shared.o usb_tcpmv2_compliance_common.o
 utils-y=utils.o
 utils_str-y=utils_str.o
 vboot-y=vboot.o
+vboot_hash-y=vboot_hash.o
+vec3_benchmark-y=vec3_benchmark.o
 version-y += version.o
 float-y=fp.o
 fp-y=fp.o
@@ -673,6 +673,83 @@ static int test_rejected_port(void)
 	return EC_SUCCESS;
 }
 
+static int active_supplier(void)
+{
+	return charge_manager_get_supplier();
+}
+
+static int test_supplier_ranking(void)
+{
+	struct charge_port_info charge;
+
+	/* Initialize table to no charge. */
+	initialize_charge_table(0, 5000, 5000);
+	TEST_ASSERT(active_charge_port == CHARGE_PORT_NONE);
+
+	/* Offer several suppliers on both ports. */
+	charge.voltage = 5000;
+	charge.current = 500;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST10, 0, &charge);
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST7, 1, &charge);
+	charge.current = 1500;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST5, 0, &charge);
+	charge.current = 2000;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST8, 1, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 0);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST5);
+	TEST_ASSERT(active_charge_limit == 1500);
+
+	/* Raise the power of a lower priority supplier on the other port. */
+	charge.current = 3000;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST7, 1, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 0);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST5);
+
+	/* Drop the best supplier, verify the next best one takes over. */
+	charge.current = 0;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST5, 0, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 1);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST7);
+	TEST_ASSERT(active_charge_limit == 3000);
+
+	/*
+	 * Offer an equal priority and power supplier on the active port, and
+	 * verify the active supplier is kept.
+	 */
+	charge.current = 1000;
+	charge.voltage = 15000;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST4, 1, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 1);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST4);
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST3, 1, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 1);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST4);
+
+	/* A higher power supplier of equal priority wins on another port. */
+	charge.current = 2000;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST2, 0, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 0);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST2);
+	TEST_ASSERT(active_charge_limit == 2000);
+
+	/* Unplug everything from port 0, verify we fall back to port 1. */
+	charge.current = 0;
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST2, 0, &charge);
+	charge_manager_update_charge(CHARGE_SUPPLIER_TEST10, 0, &charge);
+	wait_for_charge_manager_refresh();
+	TEST_ASSERT(active_charge_port == 1);
+	TEST_ASSERT(active_supplier() == CHARGE_SUPPLIER_TEST3);
+	TEST_ASSERT(active_charge_limit == 1000);
+
+	return EC_SUCCESS;
+}
+
 static int test_unknown_dualrole_capability(void)
 {
 	struct charge_port_info charge;
@@ -794,6 +871,7 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_override);
 	RUN_TEST(test_dual_role);
 	RUN_TEST(test_rejected_port);
+	RUN_TEST(test_supplier_ranking);
 	RUN_TEST(test_unknown_dualrole_capability);
 
 	/* Some handlers are still running after the test ends. */
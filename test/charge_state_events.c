@@ -0,0 +1,137 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the event-driven charge_state poll period.
+ */
+
+#include "battery.h"
+#include "battery_smart.h"
+#include "charge_state.h"
+#include "charger.h"
+#include "chipset.h"
+#include "common.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "task.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+static int battery_xfer_count;
+
+int board_cut_off_battery(void)
+{
+	return EC_SUCCESS;
+}
+
+int chipset_in_state(int state_mask)
+{
+	return state_mask & CHIPSET_STATE_ON;
+}
+
+void i2c_start_xfer_notify(const int port, const uint16_t addr_flags)
+{
+	if (port == I2C_PORT_BATTERY)
+		battery_xfer_count++;
+}
+
+void i2c_end_xfer_notify(const int port, const uint16_t addr_flags)
+{
+}
+
+static void setup_discharging(void)
+{
+	const struct battery_info *bat_info = battery_get_info();
+
+	sb_write(SB_RELATIVE_STATE_OF_CHARGE, 50);
+	sb_write(SB_FULL_CHARGE_CAPACITY, 0xf000);
+	sb_write(SB_TEMPERATURE, CELSIUS_TO_DECI_KELVIN(25));
+	sb_write(SB_VOLTAGE, bat_info->voltage_normal);
+	sb_write(SB_CHARGING_VOLTAGE, bat_info->voltage_max);
+	sb_write(SB_CHARGING_CURRENT, 4000);
+	sb_write(SB_CURRENT, -100);
+	gpio_set_level(GPIO_AC_PRESENT, 0);
+
+	charge_wakeup();
+	msleep(CHARGE_POLL_PERIOD_LONG / MSEC);
+}
+
+/* Count the battery transactions of a single charge loop. */
+static int xfers_per_loop(void)
+{
+	battery_xfer_count = 0;
+	charge_wakeup();
+	msleep(10);
+	return battery_xfer_count;
+}
+
+static int test_poll_backoff(void)
+{
+	int per_loop;
+
+	setup_discharging();
+	per_loop = xfers_per_loop();
+	TEST_GT(per_loop, 0, "%d");
+
+	/*
+	 * Nothing changes: the 500ms polls back off to 8s. Without back off,
+	 * 20s would take 40 loops.
+	 */
+	battery_xfer_count = 0;
+	msleep(20 * SECOND / MSEC);
+	TEST_LE(battery_xfer_count, 8 * per_loop, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_drift_resets_poll(void)
+{
+	int per_loop;
+	int i;
+
+	setup_discharging();
+	per_loop = xfers_per_loop();
+
+	/* Back off, then drift beyond the deadband. */
+	msleep(20 * SECOND / MSEC);
+	sb_write(SB_VOLTAGE, battery_get_info()->voltage_normal - 100);
+
+	/* Wait for the next poll, which notices the change. */
+	battery_xfer_count = 0;
+	for (i = 0; i < 100 && !battery_xfer_count; i++)
+		msleep(100);
+	TEST_NE(battery_xfer_count, 0, "%d");
+
+	/* Polls restart from 500ms, then 1s. */
+	battery_xfer_count = 0;
+	msleep(1600);
+	TEST_GE(battery_xfer_count, 2 * per_loop, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_event_wakes_loop(void)
+{
+	setup_discharging();
+	msleep(20 * SECOND / MSEC);
+
+	/* An event is handled right away, regardless of the back off. */
+	sb_write(SB_RELATIVE_STATE_OF_CHARGE, 40);
+	charge_wakeup();
+	msleep(10);
+	TEST_EQ(charge_get_percent(), 40, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_poll_backoff);
+	RUN_TEST(test_drift_resets_poll);
+	RUN_TEST(test_event_wakes_loop);
+
+	test_print_result();
+}
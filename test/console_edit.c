@@ -8,6 +8,7 @@
 #include "common.h"
 #include "console.h"
 #include "ec_commands.h"
+#include "link_defs.h"
 #include "test_util.h"
 #include "timer.h"
 #include "uart.h"
@@ -30,6 +31,23 @@ static int command_test_2(int argc, const char **argv)
 }
 DECLARE_CONSOLE_COMMAND(test2, command_test_2, NULL, NULL);
 
+static int cmd_prefix_call_cnt;
+static int cmd_prefixlong_call_cnt;
+
+static int command_prefix(int argc, const char **argv)
+{
+	cmd_prefix_call_cnt++;
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(tprefix, command_prefix, NULL, NULL);
+
+static int command_prefixlong(int argc, const char **argv)
+{
+	cmd_prefixlong_call_cnt++;
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(tprefixlong, command_prefixlong, NULL, NULL);
+
 /*****************************************************************************/
 /* Test utilities */
 
@@ -104,6 +122,49 @@ static int test_backspace(void)
 	return EC_SUCCESS;
 }
 
+static int test_command_sorted(void)
+{
+	const struct console_command *cmd;
+
+	/* Binary search relies on case-insensitive name order */
+	for (cmd = __cmds + 1; cmd < __cmds_end; cmd++)
+		TEST_LT(strcasecmp(cmd[-1].name, cmd->name), 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_command_prefix(void)
+{
+	cmd_1_call_cnt = 0;
+	cmd_2_call_cnt = 0;
+	cmd_prefix_call_cnt = 0;
+	cmd_prefixlong_call_cnt = 0;
+
+	/* Ambiguous prefix runs nothing */
+	UART_INJECT("test\n");
+	msleep(30);
+	TEST_EQ(cmd_1_call_cnt + cmd_2_call_cnt, 0, "%d");
+
+	/* Match is case-insensitive */
+	UART_INJECT("TEST2\n");
+	msleep(30);
+	TEST_EQ(cmd_2_call_cnt, 1, "%d");
+
+	/* Exact match wins over a longer command with the same prefix */
+	UART_INJECT("tprefix\n");
+	msleep(30);
+	TEST_EQ(cmd_prefix_call_cnt, 1, "%d");
+	TEST_EQ(cmd_prefixlong_call_cnt, 0, "%d");
+
+	/* Unique prefix selects the longer command */
+	UART_INJECT("tprefixl\n");
+	msleep(30);
+	TEST_EQ(cmd_prefix_call_cnt, 1, "%d");
+	TEST_EQ(cmd_prefixlong_call_cnt, 1, "%d");
+
+	return EC_SUCCESS;
+}
+
 static int test_insert_char(void)
 {
 	cmd_1_call_cnt = 0;
@@ -338,6 +399,8 @@ void run_test(int argc, const char **argv)
 	test_reset();
 
 	RUN_TEST(test_backspace);
+	RUN_TEST(test_command_sorted);
+	RUN_TEST(test_command_prefix);
 	RUN_TEST(test_insert_char);
 	RUN_TEST(test_delete_char);
 	RUN_TEST(test_insert_delete_char);
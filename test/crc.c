@@ -2,7 +2,7 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  *
- * Tests crc32 sw implementation.
+ * Tests crc32 sw implementation, and the static version against it.
  */
 
 #include "common.h"
@@ -52,6 +52,30 @@ static int test_8(void)
 	return EC_SUCCESS;
 }
 
+// test that unaligned and odd-length buffers match the context version
+static int test_unaligned(void)
+{
+	uint8_t buffer[40];
+	uint32_t crc;
+	int offset, size, i;
+
+	for (i = 0; i < sizeof(buffer); ++i)
+		buffer[i] = i * 37 + 11;
+
+	for (offset = 0; offset < 4; ++offset) {
+		for (size = 0; size <= 33; ++size) {
+			crc32_ctx_init(&crc);
+			crc32_ctx_hash(&crc, buffer + offset, size);
+
+			crc32_init();
+			crc32_hash(buffer + offset, size);
+			TEST_EQ(crc32_result(), crc32_ctx_result(&crc), "%08x");
+		}
+	}
+
+	return EC_SUCCESS;
+}
+
 // http://www.febooti.com/products/filetweak/members/hash-and-crc/test-vectors/
 static int test_kat0(void)
 {
@@ -104,6 +128,7 @@ void run_test(int argc, const char **argv)
 
 	RUN_TEST(test_static_version);
 	RUN_TEST(test_8);
+	RUN_TEST(test_unaligned);
 	RUN_TEST(test_kat0);
 	RUN_TEST(test_cros_crc8);
 	RUN_TEST(test_crc16);
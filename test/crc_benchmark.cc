@@ -0,0 +1,103 @@
+/* Copyright 2023 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Compare the bytewise and slicing-by-4/8 software CRC32 routines.
+ */
+
+#include "benchmark.h"
+
+#include <array>
+
+extern "C" {
+#include "crc.h"
+#include "test_util.h"
+
+uint32_t crc32_hash_bytewise(uint32_t crc, const void *buf, int size);
+uint32_t crc32_hash_slice4(uint32_t crc, const void *buf, int size);
+uint32_t crc32_hash_slice8(uint32_t crc, const void *buf, int size);
+}
+
+/* Size of the buffer hashed by the benchmark, like a small flash region */
+constexpr int kBufferSize = 4096;
+
+static std::array<uint8_t, kBufferSize + 8> buffer;
+
+/* Sink for the benchmarked results */
+static volatile uint32_t crc;
+
+test_static int test_slices_match()
+{
+	for (size_t i = 0; i < buffer.size(); ++i)
+		buffer[i] = (uint8_t)(i * 131 + (i >> 8));
+
+	/* Cover every alignment and every tail length */
+	for (int offset = 0; offset < 8; ++offset) {
+		for (int size = 0; size < 64; ++size) {
+			const uint8_t *p = buffer.data() + offset;
+			uint32_t expected =
+				crc32_hash_bytewise(0xFFFFFFFF, p, size);
+
+			TEST_EQ(crc32_hash_slice4(0xFFFFFFFF, p, size),
+				expected, "%08x");
+			TEST_EQ(crc32_hash_slice8(0xFFFFFFFF, p, size),
+				expected, "%08x");
+		}
+	}
+
+	TEST_EQ(crc32_hash_slice8(0xFFFFFFFF, buffer.data() + 3, kBufferSize),
+		crc32_hash_bytewise(0xFFFFFFFF, buffer.data() + 3,
+				    kBufferSize),
+		"%08x");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_kat()
+{
+	uint32_t ctx;
+	const char input[] = "The quick brown fox jumps over the lazy dog";
+
+	crc32_ctx_init(&ctx);
+	crc32_ctx_hash(&ctx, input, strlen(input));
+	TEST_EQ(crc32_ctx_result(&ctx), 0x414fa339U, "%08x");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_crc32_benchmark()
+{
+	Benchmark benchmark({ .num_iterations = 100 });
+
+	auto bytewise = benchmark.run("bytewise", [] {
+		crc = crc32_hash_bytewise(0xFFFFFFFF, buffer.data(),
+					  kBufferSize);
+	});
+	auto slice4 = benchmark.run("slice4", [] {
+		crc = crc32_hash_slice4(0xFFFFFFFF, buffer.data(), kBufferSize);
+	});
+	auto slice8 = benchmark.run("slice8", [] {
+		crc = crc32_hash_slice8(0xFFFFFFFF, buffer.data(), kBufferSize);
+	});
+
+	TEST_ASSERT(bytewise.has_value());
+	TEST_ASSERT(slice4.has_value());
+	TEST_ASSERT(slice8.has_value());
+
+	benchmark.print_results();
+	BenchmarkResult::compare(*bytewise, *slice4);
+	BenchmarkResult::compare(*bytewise, *slice8);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_slices_match);
+	RUN_TEST(test_kat);
+	RUN_TEST(test_crc32_benchmark);
+
+	test_print_result();
+}
@@ -131,6 +131,49 @@ static int test_deferred(void)
 	return EC_SUCCESS;
 }
 
+static int deferred_order[4];
+static int deferred_order_count;
+
+#define DECLARE_ORDERED_DEFERRED(n)                                   \
+	static void deferred_order_##n(void)                          \
+	{                                                             \
+		if (deferred_order_count < ARRAY_SIZE(deferred_order)) \
+			deferred_order[deferred_order_count] = n;     \
+		deferred_order_count++;                               \
+	}                                                             \
+	DECLARE_DEFERRED(deferred_order_##n)
+
+DECLARE_ORDERED_DEFERRED(0);
+DECLARE_ORDERED_DEFERRED(1);
+DECLARE_ORDERED_DEFERRED(2);
+DECLARE_ORDERED_DEFERRED(3);
+
+static int test_deferred_order(void)
+{
+	deferred_order_count = 0;
+
+	/* Deferred routines must fire in deadline order */
+	hook_call_deferred(&deferred_order_2_data, 40 * MSEC);
+	hook_call_deferred(&deferred_order_0_data, 60 * MSEC);
+	hook_call_deferred(&deferred_order_3_data, 20 * MSEC);
+	hook_call_deferred(&deferred_order_1_data, 80 * MSEC);
+
+	/* Re-arming moves a pending routine; cancelling removes it */
+	hook_call_deferred(&deferred_order_0_data, 10 * MSEC);
+	hook_call_deferred(&deferred_order_1_data, 30 * MSEC);
+	hook_call_deferred(&deferred_order_2_data, -1);
+	hook_call_deferred(&deferred_order_2_data, 50 * MSEC);
+	hook_call_deferred(&deferred_order_3_data, -1);
+
+	usleep(150 * MSEC);
+	TEST_EQ(deferred_order_count, 3, "%d");
+	TEST_EQ(deferred_order[0], 0, "%d");
+	TEST_EQ(deferred_order[1], 1, "%d");
+	TEST_EQ(deferred_order[2], 2, "%d");
+
+	return EC_SUCCESS;
+}
+
 static int repeating_deferred_count;
 static void deferred_repeating_func(void);
 DECLARE_DEFERRED(deferred_repeating_func);
@@ -164,6 +207,7 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_ticks);
 	RUN_TEST(test_priority);
 	RUN_TEST(test_deferred);
+	RUN_TEST(test_deferred_order);
 	RUN_TEST(test_repeating_deferred);
 
 	test_print_result();
@@ -306,6 +306,61 @@ static int test_hostcmd_clears_unused_data(void)
 	return EC_SUCCESS;
 }
 
+static int test_hostcmd_stats(void)
+{
+	struct ec_params_host_command_stats params = {
+		.action = EC_HOST_COMMAND_STATS_RESET,
+	};
+	struct ec_params_hello hello_p = { .in_data = 0 };
+	struct ec_response_hello hello_r;
+	const struct ec_host_command_stats_slot *slot = NULL;
+	int slot_calls = 0;
+	struct ec_response_host_command_stats *stats =
+		(struct ec_response_host_command_stats *)resp_buf;
+	int i;
+
+	TEST_EQ(test_send_host_command(EC_CMD_HOST_COMMAND_STATS, 0, &params,
+				       sizeof(params), NULL, 0),
+		EC_RES_SUCCESS, "%d");
+
+	for (i = 0; i < 3; i++)
+		TEST_EQ(test_send_host_command(EC_CMD_HELLO, 0, &hello_p,
+					       sizeof(hello_p), &hello_r,
+					       sizeof(hello_r)),
+			EC_RES_SUCCESS, "%d");
+
+	/* Unknown commands don't get a slot */
+	TEST_EQ(test_send_host_command(0x3fff, 0, NULL, 0, NULL, 0),
+		EC_RES_INVALID_COMMAND, "%d");
+
+	params.action = EC_HOST_COMMAND_STATS_GET;
+	params.index = 0;
+	TEST_EQ(test_send_host_command(EC_CMD_HOST_COMMAND_STATS, 0, &params,
+				       sizeof(params), resp_buf,
+				       sizeof(resp_buf)),
+		EC_RES_SUCCESS, "%d");
+
+	/* The reset itself and the hello commands */
+	TEST_EQ(stats->num_slots, 2, "%d");
+	TEST_EQ(stats->count, 2, "%d");
+	TEST_EQ(stats->untracked, 0, "%d");
+
+	for (i = 0; i < stats->count; i++) {
+		if (stats->slots[i].command == EC_CMD_HELLO)
+			slot = &stats->slots[i];
+	}
+	TEST_ASSERT(slot);
+	TEST_EQ(slot->count, 3, "%d");
+	TEST_LE(slot->min_us, slot->max_us, "%d");
+	TEST_ASSERT(slot->total_us <= 3 * (uint64_t)slot->max_us);
+
+	for (i = 0; i < EC_HOST_COMMAND_STATS_BUCKETS; i++)
+		slot_calls += slot->histogram[i];
+	TEST_EQ(slot_calls, 3, "%d");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	wait_for_task_started();
@@ -321,6 +376,7 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_hostcmd_invalid_checksum);
 	RUN_TEST(test_hostcmd_reuse_response_buffer);
 	RUN_TEST(test_hostcmd_clears_unused_data);
+	RUN_TEST(test_hostcmd_stats);
 
 	test_print_result();
 }
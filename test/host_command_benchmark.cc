@@ -0,0 +1,90 @@
+/* Copyright 2023 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Compare the linear, binary search and indexed host command lookups.
+ */
+
+#include "benchmark.h"
+
+extern "C" {
+#include "host_command.h"
+#include "link_defs.h"
+#include "test_util.h"
+
+const struct host_command *find_host_command_linear(int command);
+const struct host_command *find_host_command_sorted(int command);
+const struct host_command *find_host_command_indexed(int command);
+}
+
+/* Highest command code checked, including codes past the indexed range */
+constexpr int kMaxCommand = 0x4100;
+
+test_static int test_lookup_matches()
+{
+	for (int command = 0; command < kMaxCommand; ++command) {
+		const struct host_command *linear =
+			find_host_command_linear(command);
+
+		TEST_ASSERT(find_host_command_sorted(command) == linear);
+		TEST_ASSERT(find_host_command_indexed(command) == linear);
+		TEST_ASSERT(!linear || linear->command == command);
+	}
+
+	/* Every registered command must be found */
+	for (const struct host_command *cmd = __hcmds; cmd < __hcmds_end;
+	     ++cmd)
+		TEST_ASSERT(find_host_command_indexed(cmd->command) == cmd);
+
+	return EC_SUCCESS;
+}
+
+/* Look up every registered command, plus a miss for each one */
+static void lookup_all(const struct host_command *(*find)(int))
+{
+	for (int i = 0; i < 100; ++i) {
+		for (const struct host_command *cmd = __hcmds;
+		     cmd < __hcmds_end; ++cmd) {
+			const struct host_command *volatile found;
+
+			found = find(cmd->command);
+			found = find(cmd->command + 0x2000);
+			(void)found;
+		}
+	}
+}
+
+test_static int test_lookup_benchmark()
+{
+	Benchmark benchmark({ .num_iterations = 100 });
+
+	auto linear = benchmark.run(
+		"linear", [] { lookup_all(find_host_command_linear); });
+	auto sorted = benchmark.run(
+		"sorted", [] { lookup_all(find_host_command_sorted); });
+	auto indexed = benchmark.run(
+		"indexed", [] { lookup_all(find_host_command_indexed); });
+
+	TEST_ASSERT(linear.has_value());
+	TEST_ASSERT(sorted.has_value());
+	TEST_ASSERT(indexed.has_value());
+
+	ccprintf("%d host commands\n", (int)(__hcmds_end - __hcmds));
+	benchmark.print_results();
+	BenchmarkResult::compare(*linear, *sorted);
+	BenchmarkResult::compare(*sorted, *indexed);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	/* Let the host command task start and build its index */
+	wait_for_task_started();
+	test_reset();
+
+	RUN_TEST(test_lookup_matches);
+	RUN_TEST(test_lookup_benchmark);
+
+	test_print_result();
+}
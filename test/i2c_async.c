@@ -0,0 +1,309 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test asynchronous I2C requests.
+ */
+
+#include "common.h"
+#include "hooks.h"
+#include "i2c.h"
+#include "task.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define TEST_PORT I2C_PORT_BATTERY
+#define TEST_OTHER_PORT (TEST_PORT + 1)
+#define TEST_ADDR_FLAGS 0x40
+#define TEST_MISSING_ADDR_FLAGS 0x41
+
+#define TEST_EVENT TASK_EVENT_CUSTOM_BIT(0)
+
+/* Registers of the mock peripheral, accessed with an 8-bit offset. */
+static uint8_t regs[16];
+
+/* Number of transactions seen by the mock peripheral. */
+static int xfer_count;
+
+/* Order in which the requests were completed. */
+static struct i2c_xfer_req *completed[4];
+static int completed_count;
+
+static int mock_xfer(const int port, const uint16_t addr_flags,
+		     const uint8_t *out, int out_size, uint8_t *in, int in_size,
+		     int flags)
+{
+	int offset;
+
+	if (port != TEST_PORT || addr_flags != TEST_ADDR_FLAGS)
+		return EC_ERROR_INVAL;
+	if (out_size < 1 || out[0] + out_size - 1 + in_size > sizeof(regs))
+		return EC_ERROR_UNKNOWN;
+
+	xfer_count++;
+	offset = out[0];
+	memcpy(&regs[offset], out + 1, out_size - 1);
+	memcpy(in, &regs[offset], in_size);
+
+	return EC_SUCCESS;
+}
+DECLARE_TEST_I2C_XFER(mock_xfer);
+
+static void record_completion(struct i2c_xfer_req *req)
+{
+	if (completed_count < ARRAY_SIZE(completed))
+		completed[completed_count] = req;
+	completed_count++;
+}
+
+static void reset_mock(void)
+{
+	memset(regs, 0, sizeof(regs));
+	xfer_count = 0;
+	completed_count = 0;
+}
+
+static int test_batch(void)
+{
+	const uint8_t write[] = { 2, 0xaa, 0xbb };
+	const uint8_t offset[] = { 2 };
+	uint8_t in[2] = {};
+	struct i2c_xfer_desc rd = {
+		.addr_flags = TEST_ADDR_FLAGS,
+		.out = offset,
+		.out_size = sizeof(offset),
+		.in = in,
+		.in_size = sizeof(in),
+	};
+	struct i2c_xfer_desc wr = {
+		.addr_flags = TEST_ADDR_FLAGS,
+		.out = write,
+		.out_size = sizeof(write),
+		.next = &rd,
+	};
+	struct i2c_xfer_req req = {
+		.port = TEST_PORT,
+		.xfer = &wr,
+		.complete = record_completion,
+	};
+
+	reset_mock();
+	TEST_EQ(i2c_xfer_submit(&req), EC_SUCCESS, "%d");
+
+	/* The request is pending until the engine runs. */
+	TEST_EQ(i2c_xfer_submit(&req), EC_ERROR_BUSY, "%d");
+	TEST_EQ(completed_count, 0, "%d");
+
+	msleep(10);
+	TEST_EQ(completed_count, 1, "%d");
+	TEST_EQ(completed[0], &req, "%p");
+	TEST_EQ(req.rv, EC_SUCCESS, "%d");
+	TEST_EQ(xfer_count, 2, "%d");
+	TEST_EQ(in[0], 0xaa, "0x%x");
+	TEST_EQ(in[1], 0xbb, "0x%x");
+
+	/* Once completed, the request can be submitted again. */
+	TEST_EQ(i2c_xfer_submit(&req), EC_SUCCESS, "%d");
+	msleep(10);
+	TEST_EQ(completed_count, 2, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_batch_error(void)
+{
+	const uint8_t write[] = { 4, 0x55 };
+	const uint8_t offset[] = { 0 };
+	uint8_t in[1];
+	struct i2c_xfer_desc last = {
+		.addr_flags = TEST_ADDR_FLAGS,
+		.out = write,
+		.out_size = sizeof(write),
+	};
+	struct i2c_xfer_desc missing = {
+		.addr_flags = TEST_MISSING_ADDR_FLAGS,
+		.out = offset,
+		.out_size = sizeof(offset),
+		.in = in,
+		.in_size = sizeof(in),
+		.next = &last,
+	};
+	struct i2c_xfer_req req = {
+		.port = TEST_PORT,
+		.xfer = &missing,
+		.complete = record_completion,
+	};
+
+	reset_mock();
+	TEST_EQ(i2c_xfer_submit(&req), EC_SUCCESS, "%d");
+	msleep(10);
+
+	/* The batch stops at the first failed transaction. */
+	TEST_EQ(completed_count, 1, "%d");
+	TEST_NE(req.rv, EC_SUCCESS, "%d");
+	TEST_EQ(xfer_count, 0, "%d");
+	TEST_EQ(regs[4], 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_submission_order(void)
+{
+	uint8_t writes[3][2] = { { 1, 0x11 }, { 1, 0x22 }, { 1, 0x33 } };
+	struct i2c_xfer_desc xfers[3];
+	struct i2c_xfer_req reqs[3];
+	int i;
+
+	reset_mock();
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		xfers[i] = (struct i2c_xfer_desc){
+			.addr_flags = TEST_ADDR_FLAGS,
+			.out = writes[i],
+			.out_size = sizeof(writes[i]),
+		};
+		reqs[i] = (struct i2c_xfer_req){
+			.port = TEST_PORT,
+			.xfer = &xfers[i],
+			.complete = record_completion,
+		};
+		TEST_EQ(i2c_xfer_submit(&reqs[i]), EC_SUCCESS, "%d");
+	}
+	msleep(10);
+
+	TEST_EQ(completed_count, 3, "%d");
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		TEST_EQ(completed[i], &reqs[i], "%p");
+		TEST_EQ(reqs[i].rv, EC_SUCCESS, "%d");
+	}
+	/* The last write wins. */
+	TEST_EQ(regs[1], 0x33, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_event_completion(void)
+{
+	const uint8_t write[] = { 8, 0x42 };
+	struct i2c_xfer_desc wr = {
+		.addr_flags = TEST_ADDR_FLAGS,
+		.out = write,
+		.out_size = sizeof(write),
+	};
+	struct i2c_xfer_req req = {
+		.port = TEST_PORT,
+		.xfer = &wr,
+		.task = task_get_current(),
+		.event = TEST_EVENT,
+	};
+	uint32_t events;
+
+	reset_mock();
+	TEST_EQ(i2c_xfer_submit(&req), EC_SUCCESS, "%d");
+
+	events = task_wait_event_mask(TEST_EVENT, 100 * MSEC);
+	TEST_BITS_SET(events, TEST_EVENT);
+	TEST_EQ(req.rv, EC_SUCCESS, "%d");
+	TEST_EQ(regs[8], 0x42, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static const uint8_t hook_write[] = { 9, 0x24 };
+static struct i2c_xfer_desc hook_xfer = {
+	.addr_flags = TEST_ADDR_FLAGS,
+	.out = hook_write,
+	.out_size = sizeof(hook_write),
+};
+static struct i2c_xfer_req hook_req = {
+	.port = TEST_PORT,
+	.xfer = &hook_xfer,
+	.event = TEST_EVENT,
+};
+
+static void submit_from_hooks(void)
+{
+	hook_req.rv = i2c_xfer_submit(&hook_req);
+}
+DECLARE_DEFERRED(submit_from_hooks);
+
+static int test_hooks_event_completion(void)
+{
+	uint32_t events;
+
+	/* The hooks task may signal the completion to another task. */
+	reset_mock();
+	hook_req.task = task_get_current();
+	hook_call_deferred(&submit_from_hooks_data, 0);
+
+	events = task_wait_event_mask(TEST_EVENT, 100 * MSEC);
+	TEST_BITS_SET(events, TEST_EVENT);
+	TEST_EQ(hook_req.rv, EC_SUCCESS, "%d");
+	TEST_EQ(regs[9], 0x24, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_ports(void)
+{
+	uint8_t writes[3][2] = { { 1, 0x11 }, { 1, 0x22 }, { 1, 0x33 } };
+	const int ports[3] = { TEST_OTHER_PORT, TEST_PORT, TEST_OTHER_PORT };
+	struct i2c_xfer_desc xfers[3];
+	struct i2c_xfer_req reqs[3];
+	int i;
+
+	reset_mock();
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		xfers[i] = (struct i2c_xfer_desc){
+			.addr_flags = TEST_ADDR_FLAGS,
+			.out = writes[i],
+			.out_size = sizeof(writes[i]),
+		};
+		reqs[i] = (struct i2c_xfer_req){
+			.port = ports[i],
+			.xfer = &xfers[i],
+			.complete = record_completion,
+		};
+		TEST_EQ(i2c_xfer_submit(&reqs[i]), EC_SUCCESS, "%d");
+	}
+	msleep(10);
+
+	/* The requests of the first port run first, then the other port. */
+	TEST_EQ(completed_count, 3, "%d");
+	TEST_EQ(completed[0], &reqs[0], "%p");
+	TEST_EQ(completed[1], &reqs[2], "%p");
+	TEST_EQ(completed[2], &reqs[1], "%p");
+	TEST_NE(reqs[0].rv, EC_SUCCESS, "%d");
+	TEST_EQ(reqs[1].rv, EC_SUCCESS, "%d");
+	TEST_NE(reqs[2].rv, EC_SUCCESS, "%d");
+	TEST_EQ(regs[1], 0x22, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_invalid_request(void)
+{
+	struct i2c_xfer_req req = {
+		.port = TEST_PORT,
+	};
+
+	TEST_EQ(i2c_xfer_submit(NULL), EC_ERROR_INVAL, "%d");
+	TEST_EQ(i2c_xfer_submit(&req), EC_ERROR_INVAL, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_batch);
+	RUN_TEST(test_batch_error);
+	RUN_TEST(test_submission_order);
+	RUN_TEST(test_event_completion);
+	RUN_TEST(test_hooks_event_completion);
+	RUN_TEST(test_ports);
+	RUN_TEST(test_invalid_request);
+
+	test_print_result();
+}
@@ -0,0 +1,183 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test I2C transaction statistics.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define TEST_PORT I2C_PORT_BATTERY
+#define TEST_ADDR_FLAGS 0x40
+#define TEST_BUSY_ADDR_FLAGS 0x41
+#define TEST_SLOW_ADDR_FLAGS 0x42
+#define TEST_MISSING_ADDR_FLAGS 0x43
+
+/* Time taken by a transaction with the slow peripheral */
+#define TEST_SLOW_XFER_US 300
+
+/* Number of times the busy peripheral reports a busy bus */
+static int busy_count;
+
+static int mock_xfer(const int port, const uint16_t addr_flags,
+		     const uint8_t *out, int out_size, uint8_t *in, int in_size,
+		     int flags)
+{
+	if (port != TEST_PORT)
+		return EC_ERROR_INVAL;
+
+	switch (addr_flags) {
+	case TEST_ADDR_FLAGS:
+		memset(in, 0, in_size);
+		return EC_SUCCESS;
+	case TEST_BUSY_ADDR_FLAGS:
+		if (busy_count) {
+			busy_count--;
+			return EC_ERROR_BUSY;
+		}
+		return EC_SUCCESS;
+	case TEST_SLOW_ADDR_FLAGS:
+		udelay(TEST_SLOW_XFER_US);
+		return EC_ERROR_TIMEOUT;
+	default:
+		return EC_ERROR_INVAL;
+	}
+}
+DECLARE_TEST_I2C_XFER(mock_xfer);
+
+static struct {
+	struct ec_response_i2c_stats r;
+	struct ec_i2c_stats_slot slots[CONFIG_I2C_STATS_SLOTS];
+} resp;
+
+static int get_stats(int index)
+{
+	struct ec_params_i2c_stats p = {
+		.action = EC_I2C_STATS_GET,
+		.index = index,
+	};
+
+	return test_send_host_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p),
+				      &resp, sizeof(resp));
+}
+
+static int reset_stats(void)
+{
+	struct ec_params_i2c_stats p = {
+		.action = EC_I2C_STATS_RESET,
+	};
+
+	return test_send_host_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p), NULL,
+				      0);
+}
+
+static const struct ec_i2c_stats_slot *find_slot(int port, int addr)
+{
+	int i;
+
+	for (i = 0; i < resp.r.count; i++)
+		if (resp.slots[i].port == port && resp.slots[i].addr == addr)
+			return &resp.slots[i];
+	return NULL;
+}
+
+static int test_stats(void)
+{
+	const struct ec_i2c_stats_slot *slot;
+	uint8_t out[2] = { 0x10, 0x20 };
+	uint8_t in[4];
+	int i, hist_total;
+
+	TEST_EQ(reset_stats(), EC_RES_SUCCESS, "%d");
+
+	for (i = 0; i < 3; i++)
+		TEST_EQ(i2c_xfer(TEST_PORT, TEST_ADDR_FLAGS, out, sizeof(out),
+				 in, sizeof(in)),
+			EC_SUCCESS, "%d");
+	busy_count = 2;
+	TEST_EQ(i2c_xfer(TEST_PORT, TEST_BUSY_ADDR_FLAGS, out, 1, NULL, 0),
+		EC_SUCCESS, "%d");
+	TEST_EQ(i2c_xfer(TEST_PORT, TEST_SLOW_ADDR_FLAGS, out, 1, in, 1),
+		EC_ERROR_TIMEOUT, "%d");
+	TEST_NE(i2c_xfer(TEST_PORT, TEST_MISSING_ADDR_FLAGS, out, 1, NULL, 0),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(get_stats(0), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.num_slots, 4, "%d");
+	TEST_EQ(resp.r.count, 4, "%d");
+	TEST_EQ(resp.r.untracked, 0, "%d");
+
+	slot = find_slot(TEST_PORT, TEST_ADDR_FLAGS);
+	TEST_ASSERT(slot);
+	TEST_EQ(slot->count, 3, "%d");
+	TEST_EQ(slot->bytes, 3 * (int)(sizeof(out) + sizeof(in)), "%d");
+	TEST_EQ(slot->retries, 0, "%d");
+	TEST_EQ(slot->errors, 0, "%d");
+	for (i = 0, hist_total = 0; i < EC_I2C_STATS_BUCKETS; i++)
+		hist_total += slot->histogram[i];
+	TEST_EQ(hist_total, 3, "%d");
+
+	slot = find_slot(TEST_PORT, TEST_BUSY_ADDR_FLAGS);
+	TEST_ASSERT(slot);
+	TEST_EQ(slot->count, 1, "%d");
+	TEST_EQ(slot->retries, 2, "%d");
+	TEST_EQ(slot->errors, 0, "%d");
+
+	slot = find_slot(TEST_PORT, TEST_SLOW_ADDR_FLAGS);
+	TEST_ASSERT(slot);
+	TEST_EQ(slot->timeouts, 1, "%d");
+	TEST_EQ(slot->errors, 0, "%d");
+	TEST_GE(slot->max_us, TEST_SLOW_XFER_US, "%d");
+	TEST_GE((int)slot->busy_us, TEST_SLOW_XFER_US, "%d");
+	TEST_EQ(slot->histogram[__fls(slot->max_us)], 1, "%d");
+
+	slot = find_slot(TEST_PORT, TEST_MISSING_ADDR_FLAGS);
+	TEST_ASSERT(slot);
+	TEST_EQ(slot->errors, 1, "%d");
+	TEST_EQ(slot->timeouts, 0, "%d");
+
+	/* Read the slots starting past the first ones. */
+	TEST_EQ(get_stats(3), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.num_slots, 4, "%d");
+	TEST_EQ(resp.r.count, 1, "%d");
+
+	TEST_EQ(reset_stats(), EC_RES_SUCCESS, "%d");
+	TEST_EQ(get_stats(0), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.num_slots, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_untracked(void)
+{
+	uint8_t out = 0;
+	int i;
+
+	TEST_EQ(reset_stats(), EC_RES_SUCCESS, "%d");
+
+	/* Fill all the slots with distinct (missing) peripherals. */
+	for (i = 0; i <= CONFIG_I2C_STATS_SLOTS; i++)
+		i2c_xfer(TEST_PORT, 0x60 + i, &out, 1, NULL, 0);
+
+	TEST_EQ(get_stats(0), EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp.r.num_slots, CONFIG_I2C_STATS_SLOTS, "%d");
+	TEST_EQ(resp.r.untracked, 1, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_stats);
+	RUN_TEST(test_untracked);
+
+	test_print_result();
+}
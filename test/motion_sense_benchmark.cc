@@ -0,0 +1,276 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Replay recorded accelerometer samples through the motion sense pipeline
+ * and measure the cost of each stage.
+ */
+
+#include "benchmark.h"
+
+#include <array>
+
+extern "C" {
+#include "accelgyro.h"
+#include "body_detection.h"
+#include "motion_common.h"
+#include "motion_lid.h"
+#include "motion_sense.h"
+#include "motion_sense_fifo.h"
+#include "online_calibration.h"
+#include "test_util.h"
+}
+
+/* Upper bound of the number of samples replayed per sensor */
+constexpr int kMaxSamples = 512;
+
+/* Replay parameters, the sensors run at the same data rate */
+struct ReplayConfig {
+	/* Output data rate, in mHz */
+	int odr;
+	/* Number of sensors replayed, starting from BASE */
+	int num_sensors;
+};
+
+constexpr std::array<ReplayConfig, 3> kReplayConfigs = { {
+	{ .odr = 100000, .num_sensors = 1 },
+	{ .odr = 100000, .num_sensors = 2 },
+	{ .odr = 400000, .num_sensors = 2 },
+} };
+
+/* Trace converted to raw sensor units, for each sensor */
+static intv3_t samples[SENSOR_COUNT][kMaxSamples];
+static int num_samples;
+
+static ReplayConfig config;
+
+/* Timestamp of the next replayed sample, kept monotonic across runs */
+static uint32_t sample_time;
+
+/* FIFO occupancy, sampled after each committed sample */
+static int fifo_max_count;
+static int64_t fifo_total_count;
+static int fifo_num_polls;
+
+/* Sinks for the benchmarked results */
+static volatile int sink;
+static intv3_t rotated;
+
+static struct {
+	struct ec_response_motion_sense_fifo_info info;
+	uint16_t lost[MAX_MOTION_SENSORS];
+} fifo_info;
+
+static std::array<struct ec_response_motion_sensor_data,
+		  CONFIG_ACCEL_FIFO_SIZE>
+	fifo_out;
+
+static int filler(const struct motion_sensor_t *s, const float v)
+{
+	return (v * MOTION_SCALING_FACTOR) / s->current_range;
+}
+
+static void load_trace(void)
+{
+	num_samples = MIN(kMaxSamples,
+			  (int)kAccelerometerLaptopModeTestDataLength /
+				  TEST_LID_SAMPLE_SIZE);
+
+	/* The sensors are not initialized by the motion sense task. */
+	for (int s = 0; s < SENSOR_COUNT; s++)
+		motion_sensors[s].current_range =
+			motion_sensors[s].default_range;
+
+	for (int i = 0; i < num_samples; i++) {
+		for (int s = 0; s < SENSOR_COUNT; s++) {
+			const float *v = &kAccelerometerLaptopModeTestData
+				[i * TEST_LID_SAMPLE_SIZE + s * 3];
+
+			for (int j = X; j <= Z; j++)
+				samples[s][i][j] = filler(&motion_sensors[s],
+							  v[j]);
+		}
+	}
+}
+
+static void setup_replay(const ReplayConfig &c)
+{
+	config = c;
+
+	for (int s = 0; s < c.num_sensors; s++) {
+		struct motion_sensor_t *sensor = &motion_sensors[s];
+
+		sensor->drv->set_data_rate(sensor, c.odr, 0);
+		sensor->oversampling_ratio = 1;
+		motion_sense_set_data_period(s, 1000000000 / c.odr);
+	}
+
+	motion_sense_fifo_reset();
+	online_calibration_init();
+	body_detect_set_enable(true);
+	body_detect_reset();
+
+	fifo_max_count = 0;
+	fifo_total_count = 0;
+	fifo_num_polls = 0;
+}
+
+static void load_sample(int i)
+{
+	for (int s = 0; s < config.num_sensors; s++)
+		memcpy(motion_sensors[s].xyz, samples[s][i], sizeof(intv3_t));
+}
+
+static void replay_rotate(void)
+{
+	for (int i = 0; i < num_samples; i++) {
+		for (int s = 0; s < config.num_sensors; s++)
+			rotate(samples[s][i],
+			       *motion_sensors[s].rot_standard_ref, rotated);
+	}
+}
+
+static void replay_online_calibration(void)
+{
+	struct ec_response_motion_sensor_data data = {};
+	uint32_t period = 1000000000 / config.odr;
+
+	for (int i = 0; i < num_samples; i++) {
+		for (int s = 0; s < config.num_sensors; s++) {
+			data.sensor_num = s;
+			for (int j = X; j <= Z; j++)
+				data.data[j] = samples[s][i][j];
+			sink = online_calibration_process_data(
+				&data, &motion_sensors[s], sample_time);
+		}
+		sample_time += period;
+	}
+}
+
+static void poll_fifo(void)
+{
+	uint16_t out_size;
+
+	motion_sense_fifo_get_info(&fifo_info.info, 0);
+	fifo_max_count = MAX(fifo_max_count, fifo_info.info.count);
+	fifo_total_count += fifo_info.info.count;
+	fifo_num_polls++;
+
+	/* The AP drains the FIFO once it is told the threshold is reached. */
+	if (motion_sense_fifo_over_thres())
+		sink = motion_sense_fifo_read(sizeof(fifo_out), fifo_out.size(),
+					      fifo_out.data(), &out_size);
+}
+
+static void replay_fifo(void)
+{
+	struct ec_response_motion_sensor_data data = {};
+	uint32_t period = 1000000000 / config.odr;
+
+	for (int i = 0; i < num_samples; i++) {
+		/* One motion sense task loop per sample period */
+		motion_sense_fifo_batch_begin();
+		for (int s = 0; s < config.num_sensors; s++) {
+			data.sensor_num = s;
+			data.flags = 0;
+			for (int j = X; j <= Z; j++)
+				data.data[j] = samples[s][i][j];
+			motion_sense_fifo_stage_data(&data, &motion_sensors[s],
+						     3, sample_time);
+		}
+		motion_sense_fifo_batch_end();
+		sample_time += period;
+
+		poll_fifo();
+	}
+}
+
+static void replay_body_detect(void)
+{
+	for (int i = 0; i < num_samples; i++) {
+		load_sample(i);
+		body_detect();
+	}
+}
+
+static void replay_lid_angle(void)
+{
+	for (int i = 0; i < num_samples; i++) {
+		load_sample(i);
+		motion_lid_calc();
+	}
+	sink = motion_lid_get_angle();
+}
+
+test_static int test_replay_fifo()
+{
+	uint16_t out_size;
+
+	load_trace();
+	setup_replay(kReplayConfigs[1]);
+	replay_fifo();
+
+	/* Everything staged is either read by the AP or still queued. */
+	do {
+		sink = motion_sense_fifo_read(sizeof(fifo_out), fifo_out.size(),
+					      fifo_out.data(), &out_size);
+	} while (sink);
+	motion_sense_fifo_get_info(&fifo_info.info, 1);
+
+	TEST_EQ(fifo_info.info.count, 0, "%d");
+	TEST_EQ(fifo_info.info.total_lost, 0, "%d");
+	TEST_LE(fifo_max_count, CONFIG_ACCEL_FIFO_SIZE, "%d");
+	TEST_NE(fifo_num_polls, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_motion_sense_benchmark()
+{
+	load_trace();
+	ccprintf("Replaying %d samples\n", num_samples);
+
+	for (const ReplayConfig &c : kReplayConfigs) {
+		Benchmark benchmark({ .num_iterations = 10 });
+
+		setup_replay(c);
+		ccprintf("ODR %d mHz, %d sensor(s)\n", c.odr, c.num_sensors);
+
+		auto rotate = benchmark.run("rotate", replay_rotate);
+		auto calib = benchmark.run("online_calib",
+					   replay_online_calibration);
+		auto fifo = benchmark.run("fifo", replay_fifo);
+		auto body = benchmark.run("body_detect", replay_body_detect);
+
+		TEST_ASSERT(rotate.has_value());
+		TEST_ASSERT(calib.has_value());
+		TEST_ASSERT(fifo.has_value());
+		TEST_ASSERT(body.has_value());
+
+		/* The lid angle needs both the base and the lid sensors. */
+		if (c.num_sensors > LID) {
+			auto lid = benchmark.run("lid_angle", replay_lid_angle);
+
+			TEST_ASSERT(lid.has_value());
+		}
+
+		benchmark.print_results();
+		BenchmarkResult::compare(*calib, *fifo);
+		ccprintf("FIFO occupancy: max %d, average %d (size %d)\n",
+			 fifo_max_count,
+			 (int)(fifo_total_count / MAX(fifo_num_polls, 1)),
+			 CONFIG_ACCEL_FIFO_SIZE);
+	}
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_replay_fifo);
+	RUN_TEST(test_motion_sense_benchmark);
+
+	test_print_result();
+}
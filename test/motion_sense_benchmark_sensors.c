@@ -0,0 +1,131 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Mock sensors used to replay recorded samples in the motion sense benchmark.
+ */
+
+#include "accel_cal.h"
+#include "accelgyro.h"
+#include "motion_sense.h"
+#include "timer.h"
+
+/* Temperature reported by the mock sensors, in Kelvin. */
+#define TEST_SENSOR_TEMP 300
+
+/* RMS noise of the mock sensors, in ug, like a BMI160 at 100Hz. */
+#define TEST_SENSOR_RMS_NOISE 1300
+
+static int test_data_rate[SENSOR_COUNT];
+
+/* The replayed samples are consumed directly, without waking up the AP. */
+int mkbp_send_event(uint8_t event_type)
+{
+	return 1;
+}
+
+/*****************************************************************************/
+/* Mock functions */
+static int accel_init(struct motion_sensor_t *s)
+{
+	return sensor_init_done(s);
+}
+
+static int accel_read(const struct motion_sensor_t *s, intv3_t v)
+{
+	rotate(s->xyz, *s->rot_standard_ref, v);
+	return EC_SUCCESS;
+}
+
+static int accel_set_range(struct motion_sensor_t *s, int range, int rnd)
+{
+	s->current_range = range;
+	return EC_SUCCESS;
+}
+
+static int accel_set_data_rate(const struct motion_sensor_t *s, const int rate,
+			       const int rnd)
+{
+	test_data_rate[s - motion_sensors] = rate;
+	return EC_SUCCESS;
+}
+
+static int accel_get_data_rate(const struct motion_sensor_t *s)
+{
+	return test_data_rate[s - motion_sensors];
+}
+
+static int accel_get_rms_noise(const struct motion_sensor_t *s)
+{
+	return TEST_SENSOR_RMS_NOISE;
+}
+
+static int accel_read_temp(const struct motion_sensor_t *s, int *temp)
+{
+	*temp = TEST_SENSOR_TEMP;
+	return EC_SUCCESS;
+}
+
+static const struct accelgyro_drv test_motion_sense = {
+	.init = accel_init,
+	.read = accel_read,
+	.set_range = accel_set_range,
+	.set_data_rate = accel_set_data_rate,
+	.get_data_rate = accel_get_data_rate,
+	.get_rms_noise = accel_get_rms_noise,
+	.read_temp = accel_read_temp,
+};
+
+static struct accel_cal_algo base_accel_cal_algos[] = { {
+	.newton_fit = NEWTON_FIT(4, 15, FLOAT_TO_FP(0.01f), FLOAT_TO_FP(0.25f),
+				 FLOAT_TO_FP(1.0e-8f), 100),
+} };
+
+static struct accel_cal base_accel_cal_data = {
+	.still_det =
+		STILL_DET(FLOAT_TO_FP(0.00025f), 800 * MSEC, 1200 * MSEC, 5),
+	.algos = base_accel_cal_algos,
+	.num_temp_windows = ARRAY_SIZE(base_accel_cal_algos),
+};
+
+static struct accel_cal_algo lid_accel_cal_algos[] = { {
+	.newton_fit = NEWTON_FIT(4, 15, FLOAT_TO_FP(0.01f), FLOAT_TO_FP(0.25f),
+				 FLOAT_TO_FP(1.0e-8f), 100),
+} };
+
+static struct accel_cal lid_accel_cal_data = {
+	.still_det =
+		STILL_DET(FLOAT_TO_FP(0.00025f), 800 * MSEC, 1200 * MSEC, 5),
+	.algos = lid_accel_cal_algos,
+	.num_temp_windows = ARRAY_SIZE(lid_accel_cal_algos),
+};
+
+struct motion_sensor_t motion_sensors[] = {
+	[BASE] = {
+		.name = "base",
+		.active_mask = SENSOR_ACTIVE_S0_S3_S5,
+		.chip = MOTIONSENSE_CHIP_LSM6DS0,
+		.type = MOTIONSENSE_TYPE_ACCEL,
+		.location = MOTIONSENSE_LOC_BASE,
+		.drv = &test_motion_sense,
+		.rot_standard_ref = NULL,
+		.default_range = 2, /* g, enough for laptop. */
+		.online_calib_data[0] = {
+			.type_specific_data = &base_accel_cal_data,
+		},
+	},
+	[LID] = {
+		.name = "lid",
+		.active_mask = SENSOR_ACTIVE_S0,
+		.chip = MOTIONSENSE_CHIP_KXCJ9,
+		.type = MOTIONSENSE_TYPE_ACCEL,
+		.location = MOTIONSENSE_LOC_LID,
+		.drv = &test_motion_sense,
+		.rot_standard_ref = NULL,
+		.default_range = 2, /* g, enough for laptop. */
+		.online_calib_data[0] = {
+			.type_specific_data = &lid_accel_cal_data,
+		},
+	},
+};
+const unsigned int motion_sensor_count = ARRAY_SIZE(motion_sensors);
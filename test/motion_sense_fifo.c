@@ -9,6 +9,7 @@
 #include "ec_commands.h"
 #include "hwtimer.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_fifo_packed.h"
 #include "stdio.h"
 #include "task.h"
 #include "test_util.h"
@@ -276,6 +277,128 @@ static int test_add_data_no_spreading_different_timestamps(void)
 	return EC_SUCCESS;
 }
 
+static int test_batch_commit_visible_at_end(void)
+{
+	int read_count;
+
+	motion_sensors[0].oversampling_ratio = 1;
+	motion_sensors[1].oversampling_ratio = 1;
+
+	motion_sense_fifo_batch_begin();
+	motion_sense_fifo_stage_data(data, motion_sensors, 3, 100);
+	motion_sense_fifo_commit_data();
+	motion_sense_fifo_stage_data(data, motion_sensors + 1, 3, 110);
+	motion_sense_fifo_commit_data();
+	motion_sense_fifo_stage_data(data, motion_sensors, 3, 120);
+
+	/* Nothing is readable until the batch ends. */
+	read_count = motion_sense_fifo_read(
+		sizeof(data), CONFIG_ACCEL_FIFO_SIZE, data, &data_bytes_read);
+	TEST_EQ(read_count, 0, "%d");
+
+	motion_sense_fifo_batch_end();
+	read_count = motion_sense_fifo_read(
+		sizeof(data), CONFIG_ACCEL_FIFO_SIZE, data, &data_bytes_read);
+	TEST_EQ(read_count, 6, "%d");
+	TEST_EQ(data[0].timestamp, 100, "%u");
+	TEST_EQ(data[2].timestamp, 110, "%u");
+	TEST_EQ(data[4].timestamp, 120, "%u");
+
+	return EC_SUCCESS;
+}
+
+static int test_batch_commit_published_on_overflow(void)
+{
+	int i, read_count;
+
+	motion_sensors[0].oversampling_ratio = 1;
+
+	/* Fill the whole fifo from within a batch. */
+	motion_sense_fifo_batch_begin();
+	for (i = 0; i < CONFIG_ACCEL_FIFO_SIZE / 2 + 1; i++) {
+		motion_sense_fifo_stage_data(data, motion_sensors, 3, i);
+		motion_sense_fifo_commit_data();
+	}
+	motion_sense_fifo_batch_end();
+
+	/* The oldest sample was dropped to make room for the newest one. */
+	read_count = motion_sense_fifo_read(
+		sizeof(data), CONFIG_ACCEL_FIFO_SIZE, data, &data_bytes_read);
+	TEST_EQ(read_count, CONFIG_ACCEL_FIFO_SIZE, "%d");
+	TEST_BITS_SET(data[0].flags, MOTIONSENSE_SENSOR_FLAG_TIMESTAMP);
+	TEST_EQ(data[0].timestamp, 1, "%u");
+	TEST_EQ(data[CONFIG_ACCEL_FIFO_SIZE - 2].timestamp,
+		CONFIG_ACCEL_FIFO_SIZE / 2, "%u");
+
+	return EC_SUCCESS;
+}
+
+static int test_read_packed(void)
+{
+	struct motion_sense_fifo_packed_state state;
+	struct ec_response_motion_sensor_data entry;
+	static uint8_t packed[CONFIG_ACCEL_FIFO_SIZE * 9];
+	uint16_t packed_size;
+	int i, read_count, offset, len;
+
+	motion_sensors[0].oversampling_ratio = 1;
+	motion_sensors[1].oversampling_ratio = 1;
+
+	/* Small steps with an unsigned wrap around, then another sensor. */
+	for (i = 0; i < 3; i++) {
+		data[0].data[X] = 100 + i;
+		data[0].data[Y] = -100 - 2 * i;
+		data[0].data[Z] = i == 2 ? 20000 : 0x7fff + i;
+		data[0].sensor_num = i / 2;
+		motion_sense_fifo_stage_data(data, motion_sensors + i / 2, 3,
+					     1000 + 10 * i);
+	}
+	motion_sense_fifo_commit_data();
+	motion_sense_fifo_insert_async_event(motion_sensors, ASYNC_EVENT_FLUSH);
+
+	/* Too small a buffer packs fewer entries. */
+	read_count =
+		motion_sense_fifo_read_packed(8, 10, packed, &packed_size);
+	TEST_EQ(read_count, 0, "%d");
+	TEST_EQ(packed_size, 0, "%d");
+
+	read_count = motion_sense_fifo_read_packed(
+		sizeof(packed), CONFIG_ACCEL_FIFO_SIZE, packed, &packed_size);
+	TEST_EQ(read_count, 7, "%d");
+	/*
+	 * Full timestamp and data, timestamp and delta data, timestamp and
+	 * full data of the second sensor, full flush event.
+	 */
+	TEST_EQ(packed_size, 9 + 9 + 4 + 5 + 4 + 9 + 9, "%d");
+	TEST_EQ(motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE,
+				       data, &data_bytes_read),
+		0, "%d");
+
+	motion_sense_fifo_packed_init(&state);
+	for (i = offset = 0; i < read_count; i++) {
+		len = motion_sense_fifo_unpack(&state, packed + offset,
+					       packed_size - offset, &entry);
+		TEST_NE(len, 0, "%d");
+		offset += len;
+		data[i] = entry;
+	}
+	TEST_EQ(offset, packed_size, "%d");
+
+	for (i = 0; i < 3; i++) {
+		TEST_BITS_SET(data[2 * i].flags,
+			      MOTIONSENSE_SENSOR_FLAG_TIMESTAMP);
+		TEST_EQ(data[2 * i].timestamp, 1000 + 10 * i, "%u");
+		TEST_EQ(data[2 * i + 1].sensor_num, i / 2, "%d");
+		TEST_EQ(data[2 * i + 1].data[X], 100 + i, "%d");
+		TEST_EQ(data[2 * i + 1].data[Y], -100 - 2 * i, "%d");
+		TEST_EQ(data[2 * i + 1].udata[Z],
+			i == 2 ? 20000 : 0x7fff + i, "%d");
+	}
+	TEST_BITS_SET(data[6].flags, ASYNC_EVENT_FLUSH);
+
+	return EC_SUCCESS;
+}
+
 static int test_spread_data_in_window(void)
 {
 	uint32_t now;
@@ -518,6 +641,9 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_stage_data_evicts_data_with_timestamp);
 	RUN_TEST(test_add_data_no_spreading_when_different_sensors);
 	RUN_TEST(test_add_data_no_spreading_different_timestamps);
+	RUN_TEST(test_batch_commit_visible_at_end);
+	RUN_TEST(test_batch_commit_published_on_overflow);
+	RUN_TEST(test_read_packed);
 	RUN_TEST(test_spread_data_in_window);
 	RUN_TEST(test_spread_data_on_overflow);
 	RUN_TEST(test_spread_data_by_collection_rate);
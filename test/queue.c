@@ -15,6 +15,29 @@
 static struct queue const test_queue8 = QUEUE_NULL(8, char);
 static struct queue const test_queue2 = QUEUE_NULL(2, int16_t);
 
+static int policy_add_count;
+static int policy_remove_count;
+
+static void counting_policy_add(struct queue_policy const *policy,
+				size_t count)
+{
+	policy_add_count++;
+}
+
+static void counting_policy_remove(struct queue_policy const *policy,
+				   size_t count)
+{
+	policy_remove_count++;
+}
+
+static struct queue_policy const counting_policy = {
+	.add = counting_policy_add,
+	.remove = counting_policy_remove,
+};
+
+static struct queue const test_queue8_counting =
+	QUEUE(8, char, counting_policy);
+
 static int test_queue8_empty(void)
 {
 	char tmp = 1;
@@ -415,9 +438,90 @@ static int test_queue8_iterate_next_reset_on_change(void)
 	return EC_SUCCESS;
 }
 
+static int test_queue8_spsc_units(void)
+{
+	struct queue const *q = &test_queue8_counting;
+	char data[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	char res[8];
+
+	/* Move the head and tail so that the next transfers wrap around */
+	TEST_ASSERT(queue_spsc_add_units(q, data, 6) == 6);
+	TEST_ASSERT(queue_spsc_remove_units(q, res, 6) == 6);
+	TEST_ASSERT_ARRAY_EQ(data, res, 6);
+
+	TEST_ASSERT(queue_spsc_add_units(q, data, 10) == 8);
+	TEST_ASSERT(queue_is_full(q));
+	TEST_ASSERT(queue_spsc_add_units(q, data, 1) == 0);
+	TEST_ASSERT(queue_spsc_remove_units(q, res, 10) == 8);
+	TEST_ASSERT_ARRAY_EQ(data, res, 8);
+	TEST_ASSERT(queue_is_empty(q));
+	TEST_ASSERT(queue_spsc_remove_units(q, res, 1) == 0);
+
+	/* The SPSC functions leave notification to the caller */
+	TEST_EQ(policy_add_count, 0, "%d");
+	TEST_EQ(policy_remove_count, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_queue8_spsc_chunks(void)
+{
+	struct queue const *q = &test_queue8_counting;
+	struct queue_chunk chunk;
+	char data[3] = { 10, 20, 30 };
+	char res[3];
+
+	TEST_ASSERT(queue_spsc_get_read_chunk(q).count == 0);
+
+	/*
+	 * Fill a write chunk in place, wrapping around the end:
+	 *      H T
+	 * |-----xx-|
+	 */
+	TEST_ASSERT(queue_spsc_advance_tail(q, 7) == 7);
+	TEST_ASSERT(queue_spsc_advance_head(q, 5) == 5);
+
+	chunk = queue_spsc_get_write_chunk(q);
+	TEST_ASSERT(chunk.count == 1);
+	TEST_ASSERT(chunk.buffer == q->buffer + 7);
+	((char *)chunk.buffer)[0] = data[0];
+	TEST_ASSERT(queue_spsc_advance_tail(q, 1) == 1);
+
+	chunk = queue_spsc_get_write_chunk(q);
+	TEST_ASSERT(chunk.count == 5);
+	TEST_ASSERT(chunk.buffer == q->buffer);
+	memcpy(chunk.buffer, data + 1, 2);
+	TEST_ASSERT(queue_spsc_advance_tail(q, 2) == 2);
+	TEST_ASSERT(queue_count(q) == 5);
+
+	/* Drain the two filler units, then read back what was written */
+	TEST_ASSERT(queue_spsc_advance_head(q, 2) == 2);
+
+	chunk = queue_spsc_get_read_chunk(q);
+	TEST_ASSERT(chunk.count == 1);
+	TEST_ASSERT(chunk.buffer == q->buffer + 7);
+	res[0] = ((char *)chunk.buffer)[0];
+	TEST_ASSERT(queue_spsc_advance_head(q, 1) == 1);
+
+	chunk = queue_spsc_get_read_chunk(q);
+	TEST_ASSERT(chunk.count == 2);
+	memcpy(res + 1, chunk.buffer, 2);
+	TEST_ASSERT(queue_spsc_advance_head(q, 10) == 2);
+
+	TEST_ASSERT_ARRAY_EQ(data, res, 3);
+	TEST_ASSERT(queue_is_empty(q));
+	TEST_EQ(policy_add_count, 0, "%d");
+	TEST_EQ(policy_remove_count, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
 void before_test(void)
 {
 	queue_init(&test_queue2);
+	queue_init(&test_queue8_counting);
+	policy_add_count = 0;
+	policy_remove_count = 0;
 	queue_init(&test_queue8);
 }
 
@@ -442,6 +546,8 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_queue8_iterate_next);
 	RUN_TEST(test_queue2_iterate_next_full);
 	RUN_TEST(test_queue8_iterate_next_reset_on_change);
+	RUN_TEST(test_queue8_spsc_units);
+	RUN_TEST(test_queue8_spsc_chunks);
 
 	test_print_result();
 }
@@ -0,0 +1,117 @@
+/* Copyright 2023 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Benchmark RSA signature verification and its Montgomery squaring.
+ */
+
+#include "benchmark.h"
+
+#include <array>
+
+extern "C" {
+#include "rsa.h"
+#include "test_util.h"
+#include "util.h"
+
+#ifdef CONFIG_RSA_EXPONENT_3
+#include "rsa3072-3.h"
+#else
+#include "rsa2048-F4.h"
+#endif
+
+void mont_mul(const struct rsa_public_key *key, uint32_t *c, const uint32_t *a,
+	      const uint32_t *b);
+void mont_sqr(const struct rsa_public_key *key, uint32_t *t, const uint32_t *a);
+}
+
+static uint32_t rsa_workbuf[3 * RSANUMWORDS];
+static std::array<uint32_t, RSANUMWORDS> x;
+static std::array<uint32_t, RSANUMWORDS> product;
+static std::array<uint32_t, 2 * RSANUMWORDS> square;
+
+/* Return a[] mod n, for a[] < 2 * n */
+static std::array<uint32_t, RSANUMWORDS>
+reduce(const uint32_t *a, const struct rsa_public_key *key)
+{
+	std::array<uint32_t, RSANUMWORDS> r;
+	int64_t borrow = 0;
+
+	for (size_t i = 0; i < RSANUMWORDS; ++i) {
+		borrow += (uint64_t)a[i] - key->n[i];
+		r[i] = (uint32_t)borrow;
+		borrow >>= 32;
+	}
+
+	if (borrow)
+		std::copy(a, a + RSANUMWORDS, r.begin());
+
+	return r;
+}
+
+test_static int test_mont_sqr()
+{
+	/* Start from the (reduced) signature and square it repeatedly */
+	for (size_t i = 0; i < RSANUMWORDS; ++i)
+		x[i] = sig[RSANUMBYTES - 1 - 4 * i] |
+		       sig[RSANUMBYTES - 2 - 4 * i] << 8 |
+		       sig[RSANUMBYTES - 3 - 4 * i] << 16 |
+		       (uint32_t)sig[RSANUMBYTES - 4 - 4 * i] << 24;
+
+	for (int round = 0; round < 20; ++round) {
+		mont_mul(rsa_key, product.data(), x.data(), x.data());
+		mont_sqr(rsa_key, square.data(), x.data());
+
+		TEST_ASSERT(reduce(product.data(), rsa_key) ==
+			    reduce(square.data() + RSANUMWORDS, rsa_key));
+
+		std::copy(square.begin() + RSANUMWORDS, square.end(),
+			  x.begin());
+	}
+
+	return EC_SUCCESS;
+}
+
+test_static int test_rsa_verify()
+{
+	TEST_ASSERT(rsa_verify(rsa_key, sig, hash, rsa_workbuf));
+	TEST_ASSERT(!rsa_verify(rsa_key, sig, hash_wrong, rsa_workbuf));
+
+	return EC_SUCCESS;
+}
+
+test_static int test_rsa_benchmark()
+{
+	Benchmark benchmark({ .num_iterations = 20 });
+
+	auto mul = benchmark.run("mont_mul", [] {
+		mont_mul(rsa_key, product.data(), x.data(), x.data());
+	});
+	auto sqr = benchmark.run("mont_sqr", [] {
+		mont_sqr(rsa_key, square.data(), x.data());
+	});
+	auto verify = benchmark.run("rsa_verify", [] {
+		rsa_verify(rsa_key, sig, hash, rsa_workbuf);
+	});
+
+	TEST_ASSERT(mul.has_value());
+	TEST_ASSERT(sqr.has_value());
+	TEST_ASSERT(verify.has_value());
+
+	ccprintf("RSA-%d\n", CONFIG_RSA_KEY_SIZE);
+	benchmark.print_results();
+	BenchmarkResult::compare(*mul, *sqr);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_mont_sqr);
+	RUN_TEST(test_rsa_verify);
+	RUN_TEST(test_rsa_benchmark);
+
+	test_print_result();
+}
@@ -0,0 +1,160 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test task wake-up latency statistics.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "histogram.h"
+#include "host_command.h"
+#include "task.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+static int wakee_runs;
+
+int wakee_task(void *unused)
+{
+	while (1) {
+		task_wait_event(-1);
+		wakee_runs++;
+	}
+
+	return EC_SUCCESS;
+}
+
+static int get_wake_latency(task_id_t tskid, uint8_t flags,
+			    struct ec_response_task_wake_latency *r)
+{
+	struct ec_params_task_wake_latency p = {
+		.task_id = tskid,
+		.flags = flags,
+	};
+
+	return test_send_host_command(EC_CMD_TASK_WAKE_LATENCY, 0, &p,
+				      sizeof(p), r, sizeof(*r));
+}
+
+static uint32_t histogram_total(const struct ec_response_task_wake_latency *r)
+{
+	uint32_t total = 0;
+	int i;
+
+	for (i = 0; i < EC_TASK_WAKE_LATENCY_BUCKETS; i++)
+		total += r->histogram[i];
+
+	return total;
+}
+
+void before_test(void)
+{
+	struct ec_response_task_wake_latency r;
+
+	/* Let the wakee reach its wait before counting anything */
+	task_wake(TASK_ID_WAKEE);
+	task_wait_event(10 * MSEC);
+
+	get_wake_latency(TASK_ID_WAKEE, EC_TASK_WAKE_LATENCY_RESET, &r);
+	wakee_runs = 0;
+}
+
+test_static int test_wake_latency_count(void)
+{
+	struct ec_response_task_wake_latency r;
+	int i;
+
+	TEST_EQ(get_wake_latency(TASK_ID_WAKEE, 0, &r), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.num_tasks, TASK_ID_COUNT, "%d");
+	TEST_EQ(r.wakeups, 0, "%u");
+
+	for (i = 0; i < 5; i++) {
+		task_wake(TASK_ID_WAKEE);
+		task_wait_event(10 * MSEC);
+	}
+	TEST_EQ(wakee_runs, 5, "%d");
+
+	TEST_EQ(get_wake_latency(TASK_ID_WAKEE, 0, &r), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.wakeups, 5, "%u");
+	TEST_EQ(histogram_total(&r), 5, "%u");
+	TEST_LT(r.max_us, 10 * MSEC, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_wake_latency_pending(void)
+{
+	struct ec_response_task_wake_latency r;
+
+	/* Events set before the task gets to run are a single wake-up. */
+	task_wake(TASK_ID_WAKEE);
+	task_wake(TASK_ID_WAKEE);
+	task_wait_event(10 * MSEC);
+	TEST_EQ(wakee_runs, 1, "%d");
+
+	TEST_EQ(get_wake_latency(TASK_ID_WAKEE, 0, &r), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.wakeups, 1, "%u");
+
+	/* Events a task sets for itself are not counted. */
+	task_wake(task_get_current());
+	task_wait_event(10 * MSEC);
+	TEST_EQ(get_wake_latency(TASK_ID_TEST_RUNNER, 0, &r), EC_RES_SUCCESS,
+		"%d");
+	TEST_EQ(r.wakeups, 0, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_wake_latency_reset(void)
+{
+	struct ec_response_task_wake_latency r;
+
+	task_wake(TASK_ID_WAKEE);
+	task_wait_event(10 * MSEC);
+
+	TEST_EQ(get_wake_latency(TASK_ID_WAKEE, EC_TASK_WAKE_LATENCY_RESET,
+				 &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.wakeups, 1, "%u");
+
+	TEST_EQ(get_wake_latency(TASK_ID_WAKEE, 0, &r), EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.wakeups, 0, "%u");
+	TEST_EQ(r.max_us, 0, "%u");
+	TEST_EQ(histogram_total(&r), 0, "%u");
+
+	TEST_EQ(get_wake_latency(TASK_ID_COUNT, 0, &r), EC_RES_INVALID_PARAM,
+		"%d");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_histogram_percentile(void)
+{
+	const uint16_t histogram[4] = { 10, 80, 9, 1 };
+	const uint16_t empty[4] = { 0 };
+
+	TEST_EQ(histogram_percentile(histogram, 4, 100, 10), 1, "%u");
+	TEST_EQ(histogram_percentile(histogram, 4, 100, 50), 3, "%u");
+	TEST_EQ(histogram_percentile(histogram, 4, 100, 99), 7, "%u");
+	/* The last bucket is open ended */
+	TEST_EQ(histogram_percentile(histogram, 4, 100, 100), 100, "%u");
+	/* The bound never exceeds the largest value recorded */
+	TEST_EQ(histogram_percentile(histogram, 4, 2, 50), 2, "%u");
+	TEST_EQ(histogram_percentile(empty, 4, 0, 50), 0, "%u");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_wake_latency_count);
+	RUN_TEST(test_wake_latency_pending);
+	RUN_TEST(test_wake_latency_reset);
+	RUN_TEST(test_histogram_percentile);
+
+	test_print_result();
+}
@@ -19,6 +19,9 @@
 /* Host commands are sorted. */
 #define CONFIG_HOSTCMD_SECTION_SORTED
 
+/* Console commands are sorted. */
+#define CONFIG_CONSOLE_CMD_SECTION_SORTED
+
 /* Don't compile features unless specifically testing for them */
 #undef CONFIG_VBOOT_HASH
 
@@ -35,6 +38,14 @@
 #define CONFIG_BORINGSSL_CRYPTO
 #endif
 
+#ifdef TEST_HOST_COMMAND
+#define CONFIG_HOST_COMMAND_STATS
+#endif
+
+#ifdef TEST_HOST_COMMAND_BENCHMARK
+#define CONFIG_HOSTCMD_SECTION_INDEXED
+#endif
+
 #ifdef TEST_BASE32
 #define CONFIG_BASE32
 #endif
@@ -209,6 +220,20 @@ enum battery_type {
 #define CONFIG_MKBP_USE_GPIO
 #endif
 
+#ifdef TEST_MOTION_SENSE_BENCHMARK
+#define CONFIG_FPU
+#define CONFIG_ONLINE_CALIB
+#define CONFIG_MKBP_EVENT
+#define CONFIG_MKBP_USE_GPIO
+#define CONFIG_ACCEL_FIFO
+#define CONFIG_ACCEL_FIFO_SIZE 256
+#define CONFIG_ACCEL_FIFO_THRES 10
+#define CONFIG_BODY_DETECTION
+#define CONFIG_BODY_DETECTION_SENSOR BASE
+#define CONFIG_SENSOR_TIGHT_TIMESTAMPS
+#define CONFIG_ACCEL_STD_REF_FRAME_OLD
+#endif
+
 #if defined(CONFIG_ONLINE_CALIB) && !defined(CONFIG_TEMP_CACHE_STALE_THRES)
 #define CONFIG_TEMP_CACHE_STALE_THRES (1 * SECOND)
 #endif /* CONFIG_ONLINE_CALIB && !CONFIG_TEMP_CACHE_STALE_THRES */
@@ -224,7 +249,8 @@ enum sensor_id {
 };
 
 #if defined(TEST_MOTION_ANGLE) || defined(TEST_MOTION_ANGLE_TABLET) || \
-	defined(TEST_MOTION_LID) || defined(TEST_TABLET_BROKEN_SENSOR)
+	defined(TEST_MOTION_LID) || defined(TEST_TABLET_BROKEN_SENSOR) ||  \
+	defined(TEST_MOTION_SENSE_BENCHMARK)
 #define CONFIG_LID_ANGLE
 #define CONFIG_LID_ANGLE_SENSOR_BASE BASE
 #define CONFIG_LID_ANGLE_SENSOR_LID LID
@@ -297,6 +323,16 @@ enum sensor_id {
 #define CONFIG_SW_CRC
 #endif
 
+#ifdef TEST_VEC3_BENCHMARK
+#define CONFIG_FPU
+#endif
+
+#ifdef TEST_CRC_BENCHMARK
+#define CONFIG_SW_CRC
+#undef CONFIG_SW_CRC32_SLICES
+#define CONFIG_SW_CRC32_SLICES 8
+#endif
+
 #ifdef TEST_RSA
 #define CONFIG_RSA
 #ifdef CONFIG_RSA_EXPONENT_3
@@ -311,6 +347,18 @@ enum sensor_id {
 #define CONFIG_RWSIG_TYPE_RWSIG
 #endif
 
+#ifdef TEST_RSA_BENCHMARK
+#define CONFIG_RSA
+#define CONFIG_RWSIG_TYPE_RWSIG
+#endif
+
+#ifdef TEST_RSA3_BENCHMARK
+#define CONFIG_RSA
+#define CONFIG_RSA_EXPONENT_3
+#define CONFIG_RSA_KEY_SIZE 3072
+#define CONFIG_RWSIG_TYPE_RWSIG
+#endif
+
 #ifdef TEST_SHA256
 #define CONFIG_SHA256
 #endif
@@ -324,6 +372,24 @@ enum sensor_id {
 #define CONFIG_MALLOC
 #endif
 
+#ifdef TEST_CHARGE_STATE_EVENTS
+#define CONFIG_BATTERY
+#define CONFIG_BATTERY_V2
+#define CONFIG_BATTERY_COUNT 1
+#define CONFIG_BATTERY_MOCK
+#define CONFIG_BATTERY_SMART
+#define CONFIG_CHARGER
+#define CONFIG_CHARGER_DEFAULT_CURRENT_LIMIT 4032
+#define CONFIG_CHARGE_STATE_EVENT_DRIVEN
+#define CONFIG_TEST_DISABLE_INLINE_CHIPSET_IN_STATE
+#define CONFIG_I2C
+#define CONFIG_I2C_CONTROLLER
+#define CONFIG_I2C_XFER_BOARD_CALLBACK
+#define I2C_PORT_MASTER 0
+#define I2C_PORT_BATTERY 0
+#define I2C_PORT_CHARGER 0
+#endif
+
 #ifdef TEST_SBS_CHARGING
 #define CONFIG_BATTERY
 #define CONFIG_BATTERY_V2
@@ -346,6 +412,10 @@ int board_discharge_on_ac(int enabled);
 #define CONFIG_BATTERY_LOW_VOLTAGE_TIMEOUT (2 * SECOND)
 #endif
 
+#ifdef TEST_TASK_WAKE_LATENCY
+#define CONFIG_TASK_WAKE_LATENCY
+#endif
+
 #ifdef TEST_THERMAL
 #define CONFIG_CHIPSET_CAN_THROTTLE
 #define CONFIG_FANS 1
@@ -381,6 +451,20 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define I2C_PORT_CHARGER 0
 #endif
 
+#ifdef TEST_BATTERY_SMART_CACHE
+#define CONFIG_BATTERY_MOCK
+#define CONFIG_BATTERY_SMART
+#define CONFIG_BATTERY_SMART_CACHE
+#define CONFIG_BATTERY_SMART_BURST_READ
+#define CONFIG_CHARGER_DEFAULT_CURRENT_LIMIT 4032
+#define CONFIG_I2C
+#define CONFIG_I2C_CONTROLLER
+#define CONFIG_I2C_XFER_BOARD_CALLBACK
+#define I2C_PORT_MASTER 0
+#define I2C_PORT_BATTERY 0
+#define I2C_PORT_CHARGER 0
+#endif
+
 #ifdef TEST_LIGHTBAR
 #define CONFIG_I2C
 #define CONFIG_I2C_CONTROLLER
@@ -412,6 +496,7 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #if defined(TEST_USB_SM_FRAMEWORK_H3) || defined(TEST_USB_SM_FRAMEWORK_H2) || \
 	defined(TEST_USB_SM_FRAMEWORK_H1) || defined(TEST_USB_SM_FRAMEWORK_H0)
 #define CONFIG_TEST_SM
+#define CONFIG_USB_SM_STATS
 #endif
 
 #if defined(TEST_USB_PRL_OLD) || defined(TEST_USB_PRL_NOEXTENDED)
@@ -436,7 +521,7 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #endif
 
 #if defined(TEST_USB_PD_TIMER)
-#define CONFIG_USB_PD_PORT_MAX_COUNT 2
+#define CONFIG_USB_PD_PORT_MAX_COUNT 4
 #define CONFIG_MATH_UTIL
 #define CONFIG_TEST_USB_PD_TIMER
 #endif
@@ -564,7 +649,9 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #undef CONFIG_USB_PD_HOST_CMD
 #endif
 
-#ifdef TEST_USB_TCPMV2_COMPLIANCE
+#if defined(TEST_USB_TCPMV2_COMPLIANCE) || \
+	defined(TEST_USB_TCPMV2_REG_CACHE) || defined(TEST_USB_TCPMV2_TRACE) || \
+	defined(TEST_USB_TCPMV2_TICKLESS) || defined(TEST_USB_TCPMV2_SHARED)
 #define CONFIG_USB_DRP_ACC_TRYSRC
 #define CONFIG_USB_PD_DUAL_ROLE
 #define CONFIG_USB_PD_DUAL_ROLE_AUTO_TOGGLE
@@ -572,7 +659,6 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define CONFIG_USB_PD_TCPC_LOW_POWER
 #define CONFIG_USB_PD_TRY_SRC
 #define CONFIG_USB_PD_TCPMV2
-#define CONFIG_USB_PD_PORT_MAX_COUNT 1
 #define CONFIG_USBC_SS_MUX
 #define CONFIG_USB_PD_VBUS_DETECT_TCPC
 #define CONFIG_USB_POWER_DELIVERY
@@ -593,7 +679,23 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define CONFIG_USB_PD_EXTENDED_MESSAGES
 #define CONFIG_USB_PD_DECODE_SOP
 #define CONFIG_USB_PD_3A_PORTS 0 /* Host does not define a 3.0 A PDO */
+#ifdef TEST_USB_TCPMV2_REG_CACHE
+#define CONFIG_USB_PD_TCPCI_REG_CACHE
+#endif
+#ifdef TEST_USB_TCPMV2_TRACE
+#define CONFIG_USB_PD_TRACE
+#define CONFIG_USB_SM_STATS
+#endif
+#ifdef TEST_USB_TCPMV2_TICKLESS
+#define CONFIG_USB_PD_TASK_TICKLESS
+#endif
+#ifdef TEST_USB_TCPMV2_SHARED
+#define CONFIG_USB_PD_TASK_SHARED
+#define CONFIG_USB_PD_PORT_MAX_COUNT 2
+#else
+#define CONFIG_USB_PD_PORT_MAX_COUNT 1
 #endif
+#endif /* TEST_USB_TCPMV2_{COMPLIANCE,REG_CACHE,TRACE,TICKLESS,SHARED} */
 
 #ifdef TEST_USB_PD_INT
 #define CONFIG_USB_POWER_DELIVERY
@@ -649,6 +751,7 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define CONFIG_USBC_VCONN
 #define CONFIG_USBC_VCONN_SWAP
 #define CONFIG_CMD_PD_TIMER
+#define CONFIG_USB_SM_STATS
 #undef CONFIG_USB_PD_HOST_CMD
 #undef CONFIG_USB_PRL_SM
 #undef CONFIG_USB_DPM_SM
@@ -702,10 +805,21 @@ int ncp15wb_calculate_temp(uint16_t adc);
 	(CONFIG_RW_B_STORAGE_OFF + CONFIG_RW_SIZE - CONFIG_RW_SIG_SIZE)
 #endif
 
+#ifdef TEST_VBOOT_HASH
+#define CONFIG_VBOOT_HASH
+#endif
+
 #ifdef TEST_X25519
 #define CONFIG_CURVE25519
 #endif /* TEST_X25519 */
 
+#ifdef TEST_I2C_ASYNC
+#define CONFIG_I2C
+#define CONFIG_I2C_CONTROLLER
+#define CONFIG_I2C_XFER_ASYNC
+#define I2C_PORT_BATTERY 0
+#endif
+
 #ifdef TEST_I2C_BITBANG
 #define CONFIG_I2C
 #define CONFIG_I2C_CONTROLLER
@@ -713,6 +827,16 @@ int ncp15wb_calculate_temp(uint16_t adc);
 #define I2C_BITBANG_PORT_COUNT 1
 #endif
 
+#ifdef TEST_I2C_STATS
+#define CONFIG_I2C
+#define CONFIG_I2C_CONTROLLER
+#define CONFIG_I2C_DEBUG
+#define CONFIG_I2C_STATS
+#undef CONFIG_I2C_NACK_RETRY_COUNT
+#define CONFIG_I2C_NACK_RETRY_COUNT 2
+#define I2C_PORT_BATTERY 0
+#endif
+
 #ifdef TEST_PANIC
 #undef CONFIG_PANIC_STRIP_GPR
 #endif
@@ -292,6 +292,24 @@ enum pd_cc_states pd_get_task_cc_state(int port)
 	return PD_CC_NONE;
 }
 
+static struct sm_stats tc_sm_stats;
+static struct sm_stats pe_sm_stats;
+
+struct sm_stats *tc_get_sm_stats(int port)
+{
+	return &tc_sm_stats;
+}
+
+struct sm_stats *pe_get_sm_stats(int port)
+{
+	return &pe_sm_stats;
+}
+
+struct sm_stats *prl_get_sm_stats(int port, int sm, const char **name)
+{
+	return NULL;
+}
+
 static int test_command_pd_dump(void)
 {
 	int argc = 3;
@@ -762,6 +780,44 @@ static int test_command_pd_epr(void)
 	return EC_SUCCESS;
 }
 
+static int test_command_pd_wakeups(void)
+{
+	const char *argv[] = { "pd", "0", "wakeups", "reset", 0 };
+	uint32_t timeouts;
+
+	TEST_ASSERT(command_pd(4, argv) == EC_SUCCESS);
+	TEST_EQ(pd_task_get_wakeups(0, &timeouts), 0, "%u");
+	TEST_EQ(timeouts, 0, "%u");
+	TEST_ASSERT(command_pd(3, argv) == EC_SUCCESS);
+
+	argv[3] = "clear";
+	TEST_ASSERT(command_pd(4, argv) == EC_ERROR_PARAM3);
+
+	return EC_SUCCESS;
+}
+
+static int test_command_pd_sm(void)
+{
+	const char *argv[] = { "pd", "0", "sm", "reset", 0 };
+
+	tc_sm_stats.transitions = 3;
+	tc_sm_stats.total_us = 30;
+	tc_sm_stats.max_us = 20;
+	pe_sm_stats.transitions = 5;
+	TEST_ASSERT(command_pd(3, argv) == EC_SUCCESS);
+	TEST_EQ(tc_sm_stats.transitions, 3, "%u");
+
+	TEST_ASSERT(command_pd(4, argv) == EC_SUCCESS);
+	TEST_EQ(tc_sm_stats.transitions, 0, "%u");
+	TEST_EQ(tc_sm_stats.max_us, 0, "%u");
+	TEST_EQ(pe_sm_stats.transitions, 0, "%u");
+
+	argv[3] = "clear";
+	TEST_ASSERT(command_pd(4, argv) == EC_ERROR_PARAM3);
+
+	return EC_SUCCESS;
+}
+
 static int test_command_pd_timer(void)
 {
 	int argc = 3;
@@ -809,6 +865,8 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_command_pd_epr);
 	RUN_TEST(test_command_pd_state);
 	RUN_TEST(test_command_pd_srccaps);
+	RUN_TEST(test_command_pd_wakeups);
+	RUN_TEST(test_command_pd_sm);
 	RUN_TEST(test_command_pd_timer);
 
 	test_print_result();
@@ -5,9 +5,17 @@
  * Test USB PD timer module.
  */
 #include "atomic.h"
+#include "console.h"
 #include "test_util.h"
 #include "timer.h"
 #include "usb_pd_timer.h"
+#include "util.h"
+
+/*
+ * Allowed error on expiration times due to the time elapsed between a
+ * timestamp taken by the test and the one taken by the timer module
+ */
+#define EXPIRE_SLACK_US 100
 
 /*
  * Verify the bit operations and make sure another port is not affected
@@ -207,11 +215,152 @@ int test_pd_timers(void)
 	return EC_SUCCESS;
 }
 
+/*
+ * Verify that the next expiration matches the earliest enabled timer while
+ * timers are randomly enabled, disabled and expired on all ports.
+ */
+int test_pd_timers_next_expiration(void)
+{
+	uint64_t expires[MAX_PD_PORTS][PD_TIMER_COUNT];
+	uint32_t seed = 0x1234;
+	int port, timer, i;
+
+	for (port = 0; port < MAX_PD_PORTS; port++) {
+		pd_timer_init(port);
+		for (timer = 0; timer < PD_TIMER_COUNT; timer++)
+			expires[port][timer] = 0;
+	}
+
+	for (i = 0; i < 2000; i++) {
+		uint64_t now, next = 0;
+		int next_expiration, op;
+		bool active;
+
+		seed = prng(seed);
+		port = seed % MAX_PD_PORTS;
+		timer = (seed >> 8) % PD_TIMER_COUNT;
+		op = (seed >> 16) % 8;
+
+		/* Let the earliest timers expire */
+		if (op == 1)
+			msleep(1 + (seed >> 24) % 4);
+
+		/* Every expiration below is relative to this one timestamp */
+		now = get_time().val;
+
+		switch (op) {
+		case 0:
+			pd_timer_disable(port, timer);
+			expires[port][timer] = 0;
+			break;
+		case 1:
+			pd_timer_manage_expired(port);
+			for (timer = 0; timer < PD_TIMER_COUNT; timer++) {
+				if (!expires[port][timer])
+					continue;
+				active = PD_CHK_ACTIVE(port, timer);
+				if (expires[port][timer] <= now)
+					TEST_ASSERT(!active);
+				else if (expires[port][timer] >
+					 now + EXPIRE_SLACK_US)
+					TEST_ASSERT(active);
+				if (!active)
+					expires[port][timer] = 0;
+			}
+			break;
+		default: {
+			/* Enable or restart a timer */
+			uint32_t delay = 100 + (seed >> 20) % 5000;
+
+			expires[port][timer] = now + delay;
+			pd_timer_enable(port, timer, delay);
+			break;
+		}
+		}
+
+		for (timer = 0; timer < PD_TIMER_COUNT; timer++) {
+			if (expires[port][timer] &&
+			    (!next || expires[port][timer] < next))
+				next = expires[port][timer];
+		}
+
+		next_expiration = pd_timer_next_expiration(port);
+		if (!next) {
+			TEST_EQ(next_expiration, -1, "%d");
+		} else if (next <= now) {
+			TEST_LE(next_expiration, 0, "%d");
+		} else {
+			TEST_GE(next_expiration,
+				(int)(next - now) - EXPIRE_SLACK_US, "%d");
+			TEST_LE(next_expiration, (int)(next - now), "%d");
+		}
+	}
+
+	/* Expire everything. */
+	msleep(10);
+	for (port = 0; port < MAX_PD_PORTS; port++) {
+		pd_timer_manage_expired(port);
+		TEST_EQ(pd_timer_next_expiration(port), -1, "%d");
+		for (timer = 0; timer < PD_TIMER_COUNT; timer++) {
+			TEST_EQ(PD_CHK_ACTIVE(port, timer), 0, "%d");
+			if (expires[port][timer])
+				TEST_ASSERT(pd_timer_is_expired(port, timer));
+		}
+	}
+
+	return EC_SUCCESS;
+}
+
+/*
+ * Measure the timer overhead of the PD task loop: expiring the timers and
+ * finding the next expiration, on every port with several timers running.
+ */
+int test_pd_timers_loop_benchmark(void)
+{
+	const int iterations = 1000;
+	const int timers_per_port = 8;
+	timestamp_t start;
+	uint32_t elapsed;
+	int next_expiration = 0;
+	int port, timer, i;
+
+	for (port = 0; port < MAX_PD_PORTS; port++) {
+		pd_timer_init(port);
+		for (i = 0; i < timers_per_port; i++) {
+			timer = (i * PD_TIMER_COUNT) / timers_per_port;
+			pd_timer_enable(port, timer, (i + 1) * SECOND);
+		}
+	}
+
+	start = get_time();
+	for (i = 0; i < iterations; i++) {
+		for (port = 0; port < MAX_PD_PORTS; port++) {
+			pd_timer_manage_expired(port);
+			next_expiration = pd_timer_next_expiration(port);
+		}
+	}
+	elapsed = time_since32(start);
+	TEST_GT(next_expiration, 0, "%d");
+
+	ccprintf("PD timer loop: %d ports, %d timers: %u us / %d loops "
+		 "(%u ns per port)\n",
+		 MAX_PD_PORTS, timers_per_port, elapsed, iterations,
+		 (uint32_t)((uint64_t)elapsed * 1000 /
+			    (iterations * MAX_PD_PORTS)));
+
+	for (port = 0; port < MAX_PD_PORTS; port++)
+		pd_timer_init(port);
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	RUN_TEST(test_pd_timers_init);
 	RUN_TEST(test_pd_timers_bit_ops);
 	RUN_TEST(test_pd_timers);
+	RUN_TEST(test_pd_timers_next_expiration);
+	RUN_TEST(test_pd_timers_loop_benchmark);
 
 	test_print_result();
 }
@@ -1139,6 +1139,36 @@ static const struct usb_state states[] = {
 	},
 };
 
+#ifdef CONFIG_USB_SM_STATS
+test_static int test_sm_stats(void)
+{
+	int port = PORT0;
+	struct sm_stats *stats = &sm[port].ctx.stats;
+
+	set_state_sm(port, SM_TEST_A4);
+	TEST_EQ(stats->transitions, 1, "%u");
+
+	/* A4 runs once, then transitions to B4 */
+	run_sm();
+	TEST_EQ(stats->transitions, 1, "%u");
+	run_sm();
+	TEST_EQ(stats->transitions, 2, "%u");
+	TEST_ASSERT(stats->max_us > 0);
+	TEST_ASSERT(stats->total_us >= stats->max_us);
+
+	/* Resetting the context keeps the statistics */
+	reset_sm_ctx(&sm[port].ctx);
+	TEST_ASSERT(sm[port].ctx.current == NULL);
+	TEST_EQ(stats->transitions, 2, "%u");
+
+	set_state_sm(port, SM_TEST_C);
+	TEST_EQ(stats->transitions, 3, "%u");
+	TEST_EQ(sm[port].seq[sm[port].idx - 1], ENTER_C, "%d");
+
+	return EC_SUCCESS;
+}
+#endif
+
 /* Run before each RUN_TEST line */
 void before_test(void)
 {
@@ -1173,6 +1203,9 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_hierarchy_1);
 #else
 	RUN_TEST(test_hierarchy_0);
+#endif
+#ifdef CONFIG_USB_SM_STATS
+	RUN_TEST(test_sm_stats);
 #endif
 	test_print_result();
 }
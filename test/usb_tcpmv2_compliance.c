@@ -56,6 +56,12 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_td_pd_vndi3_e3_ufp);
 
 	RUN_TEST(test_connect_as_nonpd_sink);
+#ifdef CONFIG_USB_PD_TCPCI_REG_CACHE
+	RUN_TEST(test_tcpci_reg_cache);
+#endif
+#ifdef CONFIG_USB_PD_TRACE
+	RUN_TEST(test_pd_trace);
+#endif
 	RUN_TEST(test_retry_count_sop);
 	RUN_TEST(test_retry_count_hard_reset);
 
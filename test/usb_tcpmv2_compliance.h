@@ -89,6 +89,8 @@ int test_td_pd_vndi3_e3_dfp(void);
 int test_td_pd_vndi3_e3_ufp(void);
 
 int test_connect_as_nonpd_sink(void);
+int test_tcpci_reg_cache(void);
+int test_pd_trace(void);
 int test_retry_count_sop(void);
 int test_retry_count_hard_reset(void);
 
@@ -4,6 +4,7 @@
  */
 
 #include "hooks.h"
+#include "mock/tcpc_mock.h"
 #include "mock/tcpci_i2c_mock.h"
 #include "mock/usb_mux_mock.h"
 #include "task.h"
@@ -28,14 +29,30 @@ const struct tcpc_config_t tcpc_config[CONFIG_USB_PD_PORT_MAX_COUNT] = {
 		.drv = &tcpci_tcpm_drv,
 		.flags = TCPC_FLAGS_TCPCI_REV2_0,
 	},
+#if CONFIG_USB_PD_PORT_MAX_COUNT > 1
+	/* The other ports are only driven through mock_tcpc */
+	{
+		.drv = &mock_tcpc_driver,
+	},
+#endif
 };
 
-const struct usb_mux_chain usb_muxes[CONFIG_USB_PD_PORT_MAX_COUNT] = { {
-	.mux =
-		&(const struct usb_mux){
-			.driver = &mock_usb_mux_driver,
-		},
-} };
+const struct usb_mux_chain usb_muxes[CONFIG_USB_PD_PORT_MAX_COUNT] = {
+	{
+		.mux =
+			&(const struct usb_mux){
+				.driver = &mock_usb_mux_driver,
+			},
+	},
+#if CONFIG_USB_PD_PORT_MAX_COUNT > 1
+	{
+		.mux =
+			&(const struct usb_mux){
+				.driver = &mock_usb_mux_driver,
+			},
+	},
+#endif
+};
 
 void mock_set_cc(enum mock_connect_result cr, enum mock_cc_state cc1,
 		 enum mock_cc_state cc2)
@@ -487,3 +504,23 @@ int handle_attach_expected_msgs(enum pd_data_role data_role)
 	task_wait_event(1 * SECOND);
 	return EC_SUCCESS;
 }
+
+int test_connect_as_nonpd_sink(void)
+{
+	task_wait_event(10 * SECOND);
+
+	/* Simulate a non-PD power supply being plugged in. */
+	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_RP_3_0);
+	mock_set_alert(TCPC_REG_ALERT_CC_STATUS);
+
+	task_wait_event(50 * MSEC);
+
+	mock_tcpci_set_reg(TCPC_REG_POWER_STATUS,
+			   TCPC_REG_POWER_STATUS_VBUS_PRES);
+	mock_set_alert(TCPC_REG_ALERT_POWER_STATUS);
+
+	task_wait_event(10 * SECOND);
+	TEST_EQ(tc_is_attached_snk(PORT0), true, "%d");
+
+	return EC_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test servicing several ports from the shared PD task, i.e. with
+ * CONFIG_USB_PD_TASK_SHARED.
+ */
+
+#include "mock/tcpc_mock.h"
+#include "mock/tcpci_i2c_mock.h"
+#include "mock/usb_mux_mock.h"
+#include "task.h"
+#include "tcpm/tcpci.h"
+#include "test_util.h"
+#include "timer.h"
+#include "usb_pd.h"
+#include "usb_tc_sm.h"
+#include "usb_tcpmv2_compliance.h"
+
+#define PORT1 1
+
+BUILD_ASSERT(CONFIG_USB_PD_PORT_MAX_COUNT == 2);
+
+void before_test(void)
+{
+	partner_set_pd_rev(PD_REV30);
+	partner_tx_msg_id_reset(TCPCI_MSG_SOP_ALL);
+
+	mock_usb_mux_reset();
+	mock_tcpci_reset();
+	mock_tcpc_reset();
+
+	/* Restart the PD task and let it settle */
+	task_set_event(TASK_ID_PD_C0, TASK_EVENT_RESET_DONE);
+	task_wait_event(SECOND);
+
+	tc_try_src_override(TRY_SRC_OVERRIDE_OFF);
+}
+
+/* Attach or detach a non-PD source on PORT1, driven by the TCPC mock */
+static void port1_set_source(bool attached)
+{
+	mock_tcpc.cc1 = attached ? TYPEC_CC_VOLT_RP_3_0 : TYPEC_CC_VOLT_OPEN;
+	mock_tcpc.cc2 = TYPEC_CC_VOLT_OPEN;
+	mock_tcpc.vbus_level = attached;
+	pd_task_set_event(PORT1, PD_EVENT_CC);
+}
+
+test_static int test_pd_task_shared(void)
+{
+	uint32_t avg, max;
+
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
+
+	/* Only the shared PD task is bound to the ports. */
+	TEST_EQ(PD_PORT_TO_TASK_ID(PORT0), TASK_ID_PD_C0, "%d");
+	TEST_EQ(PD_PORT_TO_TASK_ID(PORT1), TASK_ID_PD_C0, "%d");
+	TEST_EQ(TASK_ID_TO_PD_PORT(task_get_current()), -1, "%d");
+
+	/* Events sent to the port are serviced, and the latency measured. */
+	pd_task_reset_wakeups(PORT0);
+	pd_task_wake(PORT0);
+	task_wait_event(10 * MSEC);
+	TEST_GE(pd_task_get_wakeups(PORT0, NULL), 1, "%u");
+	avg = pd_task_get_latency(PORT0, &max);
+	TEST_LE(avg, max, "%u");
+	TEST_LT(max, 5 * MSEC, "%u");
+	TEST_EQ(tc_is_attached_snk(PORT0), true, "%d");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_pd_task_shared_ports(void)
+{
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
+	TEST_EQ(tc_is_attached_snk(PORT1), false, "%d");
+
+	/* An event on one port only runs the state machines of that port. */
+	task_wait_event(SECOND);
+	pd_task_reset_wakeups(PORT0);
+	pd_task_reset_wakeups(PORT1);
+	port1_set_source(true);
+	task_wait_event(SECOND);
+	TEST_EQ(tc_is_attached_snk(PORT1), true, "%d");
+	TEST_EQ(tc_is_attached_snk(PORT0), true, "%d");
+	TEST_GT(pd_task_get_wakeups(PORT1, NULL),
+		pd_task_get_wakeups(PORT0, NULL), "%u");
+
+	/* Both ports keep being serviced while the other one changes. */
+	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_OPEN);
+	mock_set_alert(TCPC_REG_ALERT_CC_STATUS);
+	mock_tcpci_set_reg(TCPC_REG_POWER_STATUS, 0);
+	mock_set_alert(TCPC_REG_ALERT_POWER_STATUS);
+	task_wait_event(SECOND);
+	TEST_EQ(tc_is_attached_snk(PORT0), false, "%d");
+	TEST_EQ(tc_is_attached_snk(PORT1), true, "%d");
+
+	/* PORT1 may be in a hard reset, which ignores the detach for a while */
+	port1_set_source(false);
+	task_wait_event(5 * SECOND);
+	TEST_EQ(tc_is_attached_snk(PORT1), false, "%d");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_pd_task_shared);
+	RUN_TEST(test_pd_task_shared_ports);
+
+	test_print_result();
+}
@@ -3,31 +3,202 @@
  * found in the LICENSE file.
  */
 
+#include "ec_commands.h"
+#include "host_command.h"
 #include "mock/tcpci_i2c_mock.h"
 #include "task.h"
 #include "tcpm/tcpci.h"
 #include "test_util.h"
 #include "timer.h"
+#include "usb_pe_sm.h"
 #include "usb_prl_sm.h"
 #include "usb_tc_sm.h"
 #include "usb_tcpmv2_compliance.h"
 
-int test_connect_as_nonpd_sink(void)
+int test_tcpci_reg_cache(void)
 {
-	task_wait_event(10 * SECOND);
+	enum tcpc_cc_voltage_status cc1, cc2;
+	int role_reads, cc_reads, power_reads;
+	int i;
+
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
 
-	/* Simulate a non-PD power supply being plugged in. */
-	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_RP_3_0);
+	/* Repeated CC queries are served from the shadow. */
+	tcpm_get_cc(PORT0, &cc1, &cc2);
+	role_reads = mock_tcpci_get_reg_reads(TCPC_REG_ROLE_CTRL);
+	cc_reads = mock_tcpci_get_reg_reads(TCPC_REG_CC_STATUS);
+	for (i = 0; i < 5; i++) {
+		TEST_EQ(tcpm_get_cc(PORT0, &cc1, &cc2), EC_SUCCESS, "%d");
+		TEST_EQ(cc1, TYPEC_CC_VOLT_OPEN, "%d");
+		TEST_EQ(cc2, TYPEC_CC_VOLT_RP_3_0, "%d");
+	}
+	TEST_EQ(mock_tcpci_get_reg_reads(TCPC_REG_ROLE_CTRL), role_reads,
+		"%d");
+	TEST_EQ(mock_tcpci_get_reg_reads(TCPC_REG_CC_STATUS), cc_reads, "%d");
+
+	/* A CC status alert makes the new status visible. */
+	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_RP_1_5);
 	mock_set_alert(TCPC_REG_ALERT_CC_STATUS);
+	task_wait_event(5 * MSEC);
+	TEST_EQ(tcpm_get_cc(PORT0, &cc1, &cc2), EC_SUCCESS, "%d");
+	TEST_EQ(cc2, TYPEC_CC_VOLT_RP_1_5, "%d");
+	TEST_GT(mock_tcpci_get_reg_reads(TCPC_REG_CC_STATUS), cc_reads, "%d");
 
-	task_wait_event(50 * MSEC);
+	/* Read-modify-write operations don't read the register back. */
+	TEST_EQ(tcpm_set_vconn(PORT0, 0), EC_SUCCESS, "%d");
+	power_reads = mock_tcpci_get_reg_reads(TCPC_REG_POWER_CTRL);
+	TEST_EQ(tcpm_set_vconn(PORT0, 1), EC_SUCCESS, "%d");
+	TEST_BITS_SET(mock_tcpci_get_reg(TCPC_REG_POWER_CTRL),
+		      TCPC_REG_POWER_CTRL_VCONN(1));
+	TEST_EQ(tcpm_set_vconn(PORT0, 0), EC_SUCCESS, "%d");
+	TEST_BITS_CLEARED(mock_tcpci_get_reg(TCPC_REG_POWER_CTRL),
+			  TCPC_REG_POWER_CTRL_VCONN(1));
+	TEST_EQ(mock_tcpci_get_reg_reads(TCPC_REG_POWER_CTRL), power_reads,
+		"%d");
 
-	mock_tcpci_set_reg(TCPC_REG_POWER_STATUS,
-			   TCPC_REG_POWER_STATUS_VBUS_PRES);
-	mock_set_alert(TCPC_REG_ALERT_POWER_STATUS);
+	return EC_SUCCESS;
+}
 
-	task_wait_event(10 * SECOND);
-	TEST_EQ(tc_is_attached_snk(PORT0), true, "%d");
+static struct {
+	struct ec_response_pd_trace r;
+	struct ec_pd_trace_entry entries[CONFIG_USB_PD_TRACE_ENTRIES];
+} trace_resp;
+
+static int pd_trace_read(uint8_t action, uint32_t seq)
+{
+	struct ec_params_pd_trace p = {
+		.port = PORT0,
+		.action = action,
+		.seq = seq,
+	};
+
+	return test_send_host_command(EC_CMD_PD_TRACE, 0, &p, sizeof(p),
+				      &trace_resp, sizeof(trace_resp));
+}
+
+static int pd_trace_state_name(uint8_t action, uint32_t state,
+			       struct ec_response_pd_trace_state_name *r)
+{
+	struct ec_params_pd_trace p = {
+		.port = PORT0,
+		.action = action,
+		.seq = state,
+	};
+
+	return test_send_host_command(EC_CMD_PD_TRACE, 0, &p, sizeof(p), r,
+				      sizeof(*r));
+}
+
+int test_pd_trace(void)
+{
+	/*
+	 * The events of a sink negotiation, in order. The protocol layer may
+	 * handle the Accept before reporting the Request sent to the policy
+	 * engine, so EC_PD_TRACE_TX_COMPLETE is only checked to be there.
+	 */
+	const struct {
+		uint8_t type;
+		uint16_t data;
+	} expected[] = {
+		{ EC_PD_TRACE_RX, PD_DATA_SOURCE_CAP },
+		{ EC_PD_TRACE_TX_REQUEST,
+		  PD_DATA_REQUEST | EC_PD_TRACE_REQ_DATA },
+		{ EC_PD_TRACE_TX_START, PD_DATA_REQUEST },
+		{ EC_PD_TRACE_TX_STATUS, EC_PD_TRACE_TX_SUCCESS },
+		{ EC_PD_TRACE_RX, PD_CTRL_ACCEPT },
+		{ EC_PD_TRACE_RX, PD_CTRL_PS_RDY },
+	};
+	uint32_t vdm = VDO(USB_SID_PD, 1,
+			   VDO_SVDM_VERS_MAJOR(SVDM_VER_2_0) |
+				   CMD_DISCOVER_IDENT);
+	struct ec_response_pd_trace_state_name name;
+	const struct ec_pd_trace_entry *e;
+	uint32_t next_seq;
+	uint16_t data;
+	int pe_state = -1, tc_state = -1;
+	int vdms = 0;
+	int pe_states = 0;
+	int tx_complete = 0;
+	int backwards = 0;
+	int i, j = 0;
+
+	TEST_EQ(pd_trace_read(EC_PD_TRACE_RESET, 0), EC_RES_SUCCESS, "%d");
+
+	partner_set_pd_rev(PD_REV30);
+	TEST_EQ(proc_pd_e1(PD_ROLE_UFP, INITIAL_AND_ALREADY_ATTACHED),
+		EC_SUCCESS, "%d");
+
+	TEST_EQ(pd_trace_read(EC_PD_TRACE_GET, 0), EC_RES_SUCCESS, "%d");
+	TEST_GT(trace_resp.r.count, 0, "%d");
+	TEST_EQ(trace_resp.r.seq + trace_resp.r.count, trace_resp.r.next_seq,
+		"%u");
+
+	for (i = 0; i < trace_resp.r.count; i++) {
+		e = &trace_resp.r.entries[i];
+		if (i > 0 && (int32_t)(e->time_us - e[-1].time_us) < 0)
+			backwards++;
+		if (e->type == EC_PD_TRACE_PE_STATE) {
+			pe_state = e->data;
+			pe_states++;
+		}
+		if (e->type == EC_PD_TRACE_TC_STATE)
+			tc_state = e->data;
+		if (e->type == EC_PD_TRACE_TX_COMPLETE &&
+		    e->data == EC_PD_TRACE_TX_SUCCESS)
+			tx_complete++;
+		if (j == ARRAY_SIZE(expected) || e->type != expected[j].type)
+			continue;
+
+		data = e->data;
+		if (e->type == EC_PD_TRACE_RX ||
+		    e->type == EC_PD_TRACE_TX_START)
+			data = PD_HEADER_TYPE(data);
+		if (data == expected[j].data) {
+			TEST_EQ(e->sop, TCPCI_MSG_SOP, "%d");
+			j++;
+		}
+	}
+	TEST_EQ(j, (int)ARRAY_SIZE(expected), "%d");
+	TEST_EQ(backwards, 0, "%d");
+	TEST_GT(tx_complete, 0, "%d");
+	TEST_GT(pe_states, 0, "%d");
+
+	/* Nothing more to read past the last entry */
+	next_seq = trace_resp.r.next_seq;
+	TEST_EQ(pd_trace_read(EC_PD_TRACE_GET, next_seq), EC_RES_SUCCESS,
+		"%d");
+	TEST_EQ(trace_resp.r.count, 0, "%d");
+	TEST_EQ(trace_resp.r.seq, next_seq, "%u");
+
+	/* The recorded states can be named */
+	TEST_EQ(pd_trace_state_name(EC_PD_TRACE_PE_STATE_NAME, pe_state,
+				    &name),
+		EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(!strcmp(name.name, pe_get_state_name(pe_state)));
+	TEST_GE(tc_state, 0, "%d");
+	TEST_EQ(pd_trace_state_name(EC_PD_TRACE_TC_STATE_NAME, tc_state,
+				    &name),
+		EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(!strcmp(name.name, tc_get_state_name(tc_state)));
+	TEST_EQ(pd_trace_state_name(EC_PD_TRACE_PE_STATE_NAME, 0xffff, &name),
+		EC_RES_INVALID_PARAM, "%d");
+
+	/* A received VDM is followed by its header */
+	partner_send_msg(TCPCI_MSG_SOP, PD_DATA_VENDOR_DEF, 1, 0, &vdm);
+	task_wait_event(10 * MSEC);
+	TEST_EQ(pd_trace_read(EC_PD_TRACE_GET, next_seq), EC_RES_SUCCESS,
+		"%d");
+	for (i = 1; i < trace_resp.r.count; i++) {
+		e = &trace_resp.r.entries[i];
+		if (e->type != EC_PD_TRACE_VDM)
+			continue;
+		TEST_EQ(e[-1].type, EC_PD_TRACE_RX, "%d");
+		TEST_EQ(PD_HEADER_TYPE(e[-1].data), PD_DATA_VENDOR_DEF, "%d");
+		TEST_EQ(e->data, USB_SID_PD, "0x%x");
+		TEST_EQ(e->sop, vdm & 0xff, "0x%x");
+		vdms++;
+	}
+	TEST_EQ(vdms, 1, "%d");
 
 	return EC_SUCCESS;
 }
@@ -0,0 +1,177 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the tickless PD task, i.e. with CONFIG_USB_PD_TASK_TICKLESS.
+ */
+
+#include "mock/tcpci_i2c_mock.h"
+#include "mock/usb_mux_mock.h"
+#include "task.h"
+#include "tcpm/tcpci.h"
+#include "test_util.h"
+#include "timer.h"
+#include "usb_pd.h"
+#include "usb_tc_sm.h"
+#include "usb_tcpmv2_compliance.h"
+
+void before_test(void)
+{
+	partner_set_pd_rev(PD_REV30);
+	partner_tx_msg_id_reset(TCPCI_MSG_SOP_ALL);
+
+	mock_usb_mux_reset();
+	mock_tcpci_reset();
+
+	/* Restart the PD task and let it settle */
+	task_set_event(TASK_ID_PD_C0, TASK_EVENT_RESET_DONE);
+	task_wait_event(SECOND);
+
+	tc_try_src_override(TRY_SRC_OVERRIDE_OFF);
+}
+
+test_static int test_pd_task_tickless(void)
+{
+	uint32_t wakeups;
+
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
+
+	/* An idle attached port doesn't poll its state machines. */
+	pd_task_reset_wakeups(PORT0);
+	task_wait_event(SECOND);
+	wakeups = pd_task_get_wakeups(PORT0, NULL);
+	TEST_LE(wakeups, 10, "%u");
+
+	/* It still reacts to events. */
+	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_OPEN);
+	mock_set_alert(TCPC_REG_ALERT_CC_STATUS);
+	mock_tcpci_set_reg(TCPC_REG_POWER_STATUS, 0);
+	mock_set_alert(TCPC_REG_ALERT_POWER_STATUS);
+	task_wait_event(SECOND);
+	TEST_EQ(tc_is_attached_snk(PORT0), false, "%d");
+	TEST_GT(pd_task_get_wakeups(PORT0, NULL), wakeups, "%u");
+
+	return EC_SUCCESS;
+}
+
+/*
+ * Reply Not_Supported to the messages sent by the UUT until it stops sending
+ * any. Return the number of refused messages.
+ */
+static int refuse_requests(void)
+{
+	int count = 0;
+	int idle;
+
+	for (idle = 0; idle < 100; idle++) {
+		task_wait_event(5 * MSEC);
+		if (!mock_tcpci_get_reg(TCPC_REG_TRANSMIT))
+			continue;
+
+		mock_tcpci_set_reg(TCPC_REG_TRANSMIT, 0);
+		mock_set_alert(TCPC_REG_ALERT_TX_SUCCESS);
+		task_wait_event(1 * MSEC);
+		partner_send_msg(TCPCI_MSG_SOP, PD_CTRL_NOT_SUPPORTED, 0, 0,
+				 NULL);
+		count++;
+		idle = 0;
+	}
+	return count;
+}
+
+test_static int test_pd_task_tickless_dpm_request(void)
+{
+	uint32_t wakeups;
+
+	TEST_EQ(tcpci_startup(), EC_SUCCESS, "%d");
+	TEST_EQ(proc_pd_e1(PD_ROLE_UFP, INITIAL_AND_ALREADY_ATTACHED),
+		EC_SUCCESS, "%d");
+
+	/*
+	 * Let the UUT start its AMSs once in the explicit contract, and refuse
+	 * all of them so the port settles.
+	 */
+	mock_set_cc(MOCK_CC_DUT_IS_SNK, MOCK_CC_SNK_OPEN, MOCK_CC_SNK_RP_3_0);
+	mock_set_alert(TCPC_REG_ALERT_CC_STATUS);
+	TEST_GT(refuse_requests(), 0, "%d");
+	pd_task_reset_wakeups(PORT0);
+	task_wait_event(SECOND);
+	wakeups = pd_task_get_wakeups(PORT0, NULL);
+	TEST_LE(wakeups, 10, "%u");
+
+	/*
+	 * A request from another task is serviced right away, not on the
+	 * next event of the port.
+	 */
+	pd_dpm_request(PORT0, DPM_REQUEST_NEW_POWER_LEVEL);
+	TEST_EQ(verify_tcpci_tx_timeout(TCPCI_MSG_SOP, 0, PD_DATA_REQUEST,
+					20 * MSEC),
+		EC_SUCCESS, "%d");
+	TEST_GT(pd_task_get_wakeups(PORT0, NULL), wakeups, "%u");
+	mock_set_alert(TCPC_REG_ALERT_TX_SUCCESS);
+	partner_send_msg(TCPCI_MSG_SOP, PD_CTRL_ACCEPT, 0, 0, NULL);
+	task_wait_event(10 * MSEC);
+	partner_send_msg(TCPCI_MSG_SOP, PD_CTRL_PS_RDY, 0, 0, NULL);
+	task_wait_event(10 * MSEC);
+	TEST_EQ(tc_is_attached_snk(PORT0), true, "%d");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_pd_task_tickless_error_recovery(void)
+{
+	uint32_t wakeups;
+
+	TEST_EQ(test_connect_as_nonpd_sink(), EC_SUCCESS, "%d");
+	pd_task_reset_wakeups(PORT0);
+	task_wait_event(SECOND);
+	wakeups = pd_task_get_wakeups(PORT0, NULL);
+	TEST_LE(wakeups, 10, "%u");
+
+	/* The OCP handler requests error recovery from another task. */
+	pd_set_error_recovery(PORT0);
+	task_wait_event(20 * MSEC);
+	TEST_EQ(tc_is_attached_snk(PORT0), false, "%d");
+	TEST_GT(pd_task_get_wakeups(PORT0, NULL), wakeups, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_pd_task_tickless_rp_update(void)
+{
+	uint32_t wakeups;
+
+	TEST_EQ(tcpci_startup(), EC_SUCCESS, "%d");
+	TEST_EQ(proc_pd_e1(PD_ROLE_DFP, INITIAL_AND_ALREADY_ATTACHED),
+		EC_SUCCESS, "%d");
+	refuse_requests();
+	pd_task_reset_wakeups(PORT0);
+	task_wait_event(SECOND);
+	wakeups = pd_task_get_wakeups(PORT0, NULL);
+	TEST_LE(wakeups, 10, "%u");
+
+	/*
+	 * Source current balancing selects a new Rp from another task, which
+	 * updates the contract right away, after the tSinkTx collision
+	 * avoidance delay.
+	 */
+	typec_select_src_current_limit_rp(PORT0, TYPEC_RP_1A5);
+	TEST_EQ(verify_tcpci_tx_timeout(TCPCI_MSG_SOP, 0, PD_DATA_SOURCE_CAP,
+					50 * MSEC),
+		EC_SUCCESS, "%d");
+	TEST_GT(pd_task_get_wakeups(PORT0, NULL), wakeups, "%u");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_pd_task_tickless);
+	RUN_TEST(test_pd_task_tickless_dpm_request);
+	RUN_TEST(test_pd_task_tickless_error_recovery);
+	RUN_TEST(test_pd_task_tickless_rp_update);
+
+	test_print_result();
+}
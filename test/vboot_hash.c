@@ -0,0 +1,172 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the vboot hash of flash regions, computed with deferred calls or with
+ * a blocking call.
+ */
+
+#include "common.h"
+#include "ec_commands.h"
+#include "flash.h"
+#include "host_command.h"
+#include "sha256.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+#include "vboot_hash.h"
+
+int vboot_hash_start(uint32_t offset, uint32_t size, const uint8_t *nonce,
+		     int nonce_size, bool deferred);
+
+/*
+ * The RW image size is 0 on host, so hash an explicit region. The odd size
+ * leaves a partial chunk at the end.
+ */
+#define HASH_OFFSET CONFIG_EC_WRITABLE_STORAGE_OFF
+#define HASH_SIZE 12345
+
+static int hash_cmd(uint8_t cmd, uint32_t offset, uint32_t size,
+		    struct ec_response_vboot_hash *r)
+{
+	struct ec_params_vboot_hash p = {
+		.cmd = cmd,
+		.hash_type = EC_VBOOT_HASH_TYPE_SHA256,
+		.offset = offset,
+		.size = size,
+	};
+
+	return test_send_host_command(EC_CMD_VBOOT_HASH, 0, &p, sizeof(p), r,
+				      sizeof(*r));
+}
+
+/* Wait for the deferred hash of a region to be done */
+static int wait_hash_done(uint32_t offset, struct ec_response_vboot_hash *r)
+{
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		TEST_EQ(hash_cmd(EC_VBOOT_HASH_GET, offset, 0, r),
+			EC_RES_SUCCESS, "%d");
+		if (r->status != EC_VBOOT_HASH_STATUS_BUSY)
+			break;
+		msleep(10);
+	}
+	TEST_EQ(r->status, EC_VBOOT_HASH_STATUS_DONE, "%d");
+
+	return EC_SUCCESS;
+}
+
+/* Check a digest against the SHA-256 of the flash region */
+static int check_digest(const uint8_t *digest, uint32_t offset, uint32_t size)
+{
+	struct sha256_ctx ctx;
+	const uint8_t *expected;
+
+	SHA256_init(&ctx);
+	SHA256_update(&ctx,
+		      (const uint8_t *)CONFIG_MAPPED_STORAGE_BASE + offset,
+		      size);
+	expected = SHA256_final(&ctx);
+	TEST_ASSERT_ARRAY_EQ(digest, expected, SHA256_DIGEST_SIZE);
+
+	return EC_SUCCESS;
+}
+
+test_static int test_blocking_hash(void)
+{
+	struct ec_response_vboot_hash r;
+
+	/* The hash is done when the blocking call returns */
+	TEST_EQ(vboot_hash_start(HASH_OFFSET, HASH_SIZE, NULL, 0, false),
+		EC_SUCCESS, "%d");
+	TEST_ASSERT(!vboot_hash_in_progress());
+
+	/* and it is reported like a deferred one */
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_GET, HASH_OFFSET, HASH_SIZE, &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.status, EC_VBOOT_HASH_STATUS_DONE, "%d");
+	TEST_EQ(r.offset, HASH_OFFSET, "%d");
+	TEST_EQ(r.size, HASH_SIZE, "%d");
+
+	return check_digest(r.hash_digest, HASH_OFFSET, HASH_SIZE);
+}
+
+test_static int test_blocking_matches_deferred(void)
+{
+	struct ec_response_vboot_hash r;
+	uint8_t deferred[SHA256_DIGEST_SIZE];
+
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_START, HASH_OFFSET, HASH_SIZE, &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(vboot_hash_in_progress());
+	TEST_EQ(wait_hash_done(HASH_OFFSET, &r), EC_SUCCESS, "%d");
+	TEST_EQ(r.size, HASH_SIZE, "%d");
+	memcpy(deferred, r.hash_digest, sizeof(deferred));
+
+	TEST_EQ(vboot_hash_start(HASH_OFFSET, HASH_SIZE, NULL, 0, false),
+		EC_SUCCESS, "%d");
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_GET, HASH_OFFSET, HASH_SIZE, &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.status, EC_VBOOT_HASH_STATUS_DONE, "%d");
+	TEST_ASSERT_ARRAY_EQ(r.hash_digest, deferred, SHA256_DIGEST_SIZE);
+
+	return check_digest(deferred, HASH_OFFSET, HASH_SIZE);
+}
+
+test_static int test_blocking_busy(void)
+{
+	struct ec_response_vboot_hash r;
+	const uint8_t *digest;
+
+	/* A blocking hash can't start while a deferred one runs */
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_START, HASH_OFFSET, HASH_SIZE, &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_ASSERT(vboot_hash_in_progress());
+	TEST_EQ(vboot_get_rw_hash(&digest), EC_ERROR_BUSY, "%d");
+
+	/* Once aborted, there is no hash until the next one is done */
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_ABORT, 0, 0, &r), EC_RES_SUCCESS, "%d");
+	msleep(10);
+	TEST_ASSERT(!vboot_hash_in_progress());
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_GET, HASH_OFFSET, HASH_SIZE, &r),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r.status, EC_VBOOT_HASH_STATUS_NONE, "%d");
+
+	TEST_EQ(vboot_get_rw_hash(&digest), EC_SUCCESS, "%d");
+	TEST_NE(digest, NULL, "%p");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_invalid_region(void)
+{
+	struct ec_response_vboot_hash r;
+
+	TEST_EQ(hash_cmd(EC_VBOOT_HASH_START, CONFIG_FLASH_SIZE_BYTES, 1, &r),
+		EC_RES_INVALID_PARAM, "%d");
+	TEST_ASSERT(!vboot_hash_in_progress());
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	int i;
+
+	test_reset();
+
+	/* Something else than erased flash to hash */
+	for (i = 0; i < CONFIG_FLASH_SIZE_BYTES; i++)
+		__host_flash[i] = i * 7 + (i >> 10);
+
+	/* Let the hash started at init complete */
+	msleep(100);
+
+	RUN_TEST(test_blocking_hash);
+	RUN_TEST(test_blocking_matches_deferred);
+	RUN_TEST(test_blocking_busy);
+	RUN_TEST(test_invalid_region);
+
+	test_print_result();
+}
@@ -0,0 +1,158 @@
+/* Copyright 2024 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Measure the per-sample cost of the vec3 primitives in an online calibration
+ * style kernel, comparing out-of-line calls with the inline header versions.
+ */
+
+#include "benchmark.h"
+
+#include <array>
+
+extern "C" {
+#include "test_util.h"
+#include "vec3.h"
+}
+
+/* Number of orientations each sample is compared to, as in newton_fit */
+constexpr int kOrientations = 32;
+
+/* Number of samples processed per benchmark iteration */
+constexpr int kSamples = 64;
+
+static std::array<fpv3_t, kOrientations> orientations;
+static std::array<fpv3_t, kSamples> samples;
+
+/* Sink for the benchmarked results */
+static volatile int nearest;
+
+/* Out-of-line copies of the vec3 primitives, as they were before inlining */
+__attribute__((noinline)) static void ref_fpv3_sub(fpv3_t out, const fpv3_t a,
+						   const fpv3_t b)
+{
+	out[X] = a[X] - b[X];
+	out[Y] = a[Y] - b[Y];
+	out[Z] = a[Z] - b[Z];
+}
+
+__attribute__((noinline)) static void ref_fpv3_add(fpv3_t out, const fpv3_t a,
+						   const fpv3_t b)
+{
+	out[X] = a[X] + b[X];
+	out[Y] = a[Y] + b[Y];
+	out[Z] = a[Z] + b[Z];
+}
+
+__attribute__((noinline)) static void ref_fpv3_scalar_mul(fpv3_t v, fp_t c)
+{
+	v[X] = fp_mul(v[X], c);
+	v[Y] = fp_mul(v[Y], c);
+	v[Z] = fp_mul(v[Z], c);
+}
+
+__attribute__((noinline)) static fp_t ref_fpv3_dot(const fpv3_t v,
+						   const fpv3_t w)
+{
+	return fp_mul(v[X], w[X]) + fp_mul(v[Y], w[Y]) + fp_mul(v[Z], w[Z]);
+}
+
+/*
+ * For each sample, find the closest stored orientation and blend the sample
+ * into it, like newton_fit_accumulate() does. Returns the sum of the indices
+ * of the closest orientations, to compare both versions.
+ */
+#define DEFINE_KERNEL(name, sub, add, scalar_mul, dot)                         \
+	static int name(std::array<fpv3_t, kOrientations> &o)                  \
+	{                                                                      \
+		int sum = 0;                                                   \
+                                                                               \
+		for (int s = 0; s < kSamples; ++s) {                           \
+			fpv3_t delta, v;                                       \
+			fp_t best = FLOAT_TO_FP(1000.0f);                      \
+			int best_i = 0;                                        \
+                                                                               \
+			for (int i = 0; i < kOrientations; ++i) {              \
+				fp_t d;                                        \
+                                                                               \
+				sub(delta, samples[s], o[i]);                  \
+				d = dot(delta, delta);                         \
+				if (d < best) {                                \
+					best = d;                              \
+					best_i = i;                            \
+				}                                              \
+			}                                                      \
+			memcpy(v, samples[s], sizeof(v));                      \
+			scalar_mul(o[best_i], FLOAT_TO_FP(0.75f));             \
+			scalar_mul(v, FLOAT_TO_FP(0.25f));                     \
+			add(o[best_i], o[best_i], v);                          \
+			sum += best_i;                                         \
+		}                                                              \
+		return sum;                                                    \
+	}
+
+DEFINE_KERNEL(kernel_ref, ref_fpv3_sub, ref_fpv3_add, ref_fpv3_scalar_mul,
+	      ref_fpv3_dot)
+DEFINE_KERNEL(kernel_inline, fpv3_sub, fpv3_add, fpv3_scalar_mul, fpv3_dot)
+
+static void init_vectors()
+{
+	for (int i = 0; i < kOrientations; ++i)
+		fpv3_init(orientations[i], FLOAT_TO_FP((i % 4) * 0.5f - 0.75f),
+			  FLOAT_TO_FP((i / 4 % 4) * 0.5f - 0.75f),
+			  FLOAT_TO_FP((i / 16) * 1.0f - 0.5f));
+	for (int s = 0; s < kSamples; ++s)
+		fpv3_init(samples[s], FLOAT_TO_FP((s % 7) * 0.25f - 0.75f),
+			  FLOAT_TO_FP((s % 5) * 0.3f - 0.6f),
+			  FLOAT_TO_FP((s % 3) * 0.5f - 0.5f));
+}
+
+test_static int test_kernels_match()
+{
+	std::array<fpv3_t, kOrientations> ref, inl;
+
+	init_vectors();
+	memcpy(ref.data(), orientations.data(), sizeof(orientations));
+	memcpy(inl.data(), orientations.data(), sizeof(orientations));
+
+	TEST_EQ(kernel_ref(ref), kernel_inline(inl), "%d");
+	TEST_ASSERT_ARRAY_EQ((const uint8_t *)ref.data(),
+			     (const uint8_t *)inl.data(), sizeof(ref));
+
+	return EC_SUCCESS;
+}
+
+test_static int test_vec3_benchmark()
+{
+	Benchmark benchmark({ .num_iterations = 100 });
+	static std::array<fpv3_t, kOrientations> o;
+
+	init_vectors();
+
+	auto ref = benchmark.run("out-of-line", [] {
+		memcpy(o.data(), orientations.data(), sizeof(o));
+		nearest = kernel_ref(o);
+	});
+	auto inl = benchmark.run("inline", [] {
+		memcpy(o.data(), orientations.data(), sizeof(o));
+		nearest = kernel_inline(o);
+	});
+
+	TEST_ASSERT(ref.has_value());
+	TEST_ASSERT(inl.has_value());
+
+	benchmark.print_results();
+	BenchmarkResult::compare(*ref, *inl);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_kernels_match);
+	RUN_TEST(test_vec3_benchmark);
+
+	test_print_result();
+}
@@ -33,6 +33,8 @@ iteflash-objs = iteflash.o usb_if.o
 ectool-objs=ectool.o ectool_keyscan.o ec_flash.o $(comm-objs)
 ectool-objs+=ectool_i2c.o
 ectool-objs+=../common/crc.o
+ectool-objs+=../common/histogram.o
+ectool-objs+=../common/motion_sense_fifo_packed.o
 ectool_servo-objs=$(ectool-objs) comm-servo-spi.o
 lbplay-objs=lbplay.o $(comm-objs)
 
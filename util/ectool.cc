@@ -13,10 +13,12 @@
 #include "ec_flash.h"
 #include "ec_version.h"
 #include "ectool.h"
+#include "histogram.h"
 #include "i2c.h"
 #include "lightbar.h"
 #include "lock/gec_lock.h"
 #include "misc_util.h"
+#include "motion_sense_fifo_packed.h"
 #include "panic.h"
 #include "tablet_mode.h"
 #include "usb_pd.h"
@@ -43,6 +45,7 @@
 #include <libec/flash_protect_command.h>
 #include <libec/rand_num_command.h>
 #include <libec/versions_command.h>
+#include <map>
 #include <memory>
 #include <string>
 #include <unistd.h>
@@ -198,6 +201,8 @@ const char help_str[] =
 	"      Set the value of GPIO signal\n"
 	"  hangdetect <flags> <event_msec> <reboot_msec> | stop | start\n"
 	"      Configure or start/stop the hang detect timer\n"
+	"  hcstats [reset]\n"
+	"      Prints or resets host command handler timing statistics\n"
 	"  hello\n"
 	"      Checks for basic communication with EC\n"
 	"  hibdelay [sec]\n"
@@ -212,6 +217,8 @@ const char help_str[] =
 	"      Read I2C bus\n"
 	"  i2cspeed <port> [speed]\n"
 	"      Get or set EC's I2C bus speed\n"
+	"  i2cstats [reset]\n"
+	"      Prints or resets I2C transaction statistics\n"
 	"  i2cwrite\n"
 	"      Write I2C bus\n"
 	"  i2cxfer <port> <peripheral_addr> <read_count> [write bytes...]\n"
@@ -254,6 +261,8 @@ const char help_str[] =
 	"      Get PD chip information\n"
 	"  pdlog\n"
 	"      Prints the PD event log entries\n"
+	"  pdtrace <port> [reset]\n"
+	"      Prints or resets the PD message trace of a port\n"
 	"  pdwritelog <type> <port>\n"
 	"      Writes a PD event log of the given <type>\n"
 	"  pdgetmode <port>\n"
@@ -642,6 +651,57 @@ int cmd_hello(int argc, char *argv[])
 	return 0;
 }
 
+int cmd_hcstats(int argc, char *argv[])
+{
+	struct ec_params_host_command_stats p;
+	struct ec_response_host_command_stats *r =
+		(struct ec_response_host_command_stats *)ec_inbuf;
+	int rv;
+	int i;
+
+	memset(&p, 0, sizeof(p));
+
+	if (argc == 2 && !strcasecmp(argv[1], "reset")) {
+		p.action = EC_HOST_COMMAND_STATS_RESET;
+		return ec_command(EC_CMD_HOST_COMMAND_STATS, 0, &p, sizeof(p),
+				  NULL, 0);
+	} else if (argc != 1) {
+		fprintf(stderr, "Usage: %s [reset]\n", argv[0]);
+		return -1;
+	}
+
+	p.action = EC_HOST_COMMAND_STATS_GET;
+	printf("cmd      count   min(us)   avg(us)   max(us)   p99(us)\n");
+	do {
+		rv = ec_command(EC_CMD_HOST_COMMAND_STATS, 0, &p, sizeof(p),
+				ec_inbuf, ec_max_insize);
+		if (rv < 0)
+			return rv;
+
+		for (i = 0; i < r->count; i++) {
+			const struct ec_host_command_stats_slot *s =
+				&r->slots[i];
+
+			if (!s->count)
+				continue;
+
+			printf("0x%04x %7u %9u %9" PRIu64 " %9u %9u\n",
+			       s->command, s->count, s->min_us,
+			       s->total_us / s->count, s->max_us,
+			       histogram_percentile(
+				       s->histogram,
+				       EC_HOST_COMMAND_STATS_BUCKETS,
+				       s->max_us, 99));
+		}
+		p.index += r->count;
+	} while (r->count && p.index < r->num_slots);
+
+	if (r->untracked)
+		printf("%u calls to untracked commands\n", r->untracked);
+
+	return 0;
+}
+
 int cmd_hibdelay(int argc, char *argv[])
 {
 	struct ec_params_hibernation_delay p;
@@ -5316,6 +5376,7 @@ static const struct {
 	ST_BOTH_SIZES(sensor_scale),
 	ST_BOTH_SIZES(online_calib_read),
 	ST_BOTH_SIZES(get_activity),
+	ST_BOTH_SIZES(fifo_read_packed),
 };
 BUILD_ASSERT(ARRAY_SIZE(ms_command_sizes) == MOTIONSENSE_NUM_CMDS);
 
@@ -5383,6 +5444,73 @@ static void motionsense_display_activities(uint32_t activities)
 		       MOTIONSENSE_ACTIVITY_BODY_DETECTION);
 }
 
+static void motionsense_print_fifo_entry(
+	const struct ec_response_motion_sensor_data *vector)
+{
+	if (vector->flags & (MOTIONSENSE_SENSOR_FLAG_TIMESTAMP |
+			     MOTIONSENSE_SENSOR_FLAG_FLUSH)) {
+		printf("Timestamp:%" PRIx32 "%s\n", vector->timestamp,
+		       (vector->flags & MOTIONSENSE_SENSOR_FLAG_FLUSH ?
+				" - Flush" :
+				""));
+	} else {
+		printf("Sensor %d: %d\t%d\t%d "
+		       "(as uint16: %u\t%u\t%u)\n",
+		       vector->sensor_num, vector->data[0], vector->data[1],
+		       vector->data[2], vector->data[0], vector->data[1],
+		       vector->data[2]);
+	}
+}
+
+/* Read and print up to max_data fifo entries, using the packed format. */
+static int motionsense_fifo_read_packed(int max_data)
+{
+	struct ec_params_motion_sense param;
+	struct ec_response_motion_sensor_data vector;
+	struct motion_sense_fifo_packed_state state;
+	std::unique_ptr<uint8_t[]> buffer =
+		std::make_unique<uint8_t[]>(ec_max_insize);
+	auto *packed = reinterpret_cast<ec_response_motion_sense_fifo_packed *>(
+		buffer.get());
+	int rv, len, print_data = 0;
+	size_t offset;
+
+	do {
+		param.cmd = MOTIONSENSE_CMD_FIFO_READ_PACKED;
+		param.fifo_read_packed.max_data_vector = max_data - print_data;
+
+		rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
+				ms_command_sizes[param.cmd].outsize, packed,
+				ec_max_insize);
+		if (rv < 0)
+			return rv;
+		if (rv < (int)sizeof(*packed) ||
+		    packed->size > rv - sizeof(*packed)) {
+			fprintf(stderr, "Bad packed fifo response size.\n");
+			return -1;
+		}
+
+		/* Each response decodes on its own. */
+		motion_sense_fifo_packed_init(&state);
+		offset = 0;
+		for (int i = 0; i < packed->number_data; i++) {
+			len = motion_sense_fifo_unpack(&state,
+						       packed->data + offset,
+						       packed->size - offset,
+						       &vector);
+			if (!len) {
+				fprintf(stderr, "Bad packed fifo record.\n");
+				return -1;
+			}
+			offset += len;
+			motionsense_print_fifo_entry(&vector);
+		}
+		print_data += packed->number_data;
+	} while (packed->number_data != 0 && print_data < max_data);
+
+	return 0;
+}
+
 static int cmd_motionsense(int argc, char **argv)
 {
 	int i, rv, status_only = (argc == 2);
@@ -5898,9 +6026,14 @@ static int cmd_motionsense(int argc, char **argv)
 			fprintf(stderr, "Bad %s arg.\n", argv[2]);
 			return -1;
 		}
+
+		rv = motionsense_fifo_read_packed(max_data);
+		/* Older ECs only support the unpacked format. */
+		if (rv != -EECRESULT - EC_RES_INVALID_PARAM)
+			return rv;
+
 		while (fifo_read_buffer.number_data != 0 &&
 		       print_data < max_data) {
-			struct ec_response_motion_sensor_data *vector;
 			param.cmd = MOTIONSENSE_CMD_FIFO_READ;
 			param.fifo_read.max_data_vector =
 				MIN(ARRAY_SIZE(fifo_read_buffer.data),
@@ -5913,26 +6046,9 @@ static int cmd_motionsense(int argc, char **argv)
 				return rv;
 
 			print_data += fifo_read_buffer.number_data;
-			for (i = 0; i < fifo_read_buffer.number_data; i++) {
-				vector = &fifo_read_buffer.data[i];
-				if (vector->flags &
-				    (MOTIONSENSE_SENSOR_FLAG_TIMESTAMP |
-				     MOTIONSENSE_SENSOR_FLAG_FLUSH)) {
-					printf("Timestamp:%" PRIx32 "%s\n",
-					       vector->timestamp,
-					       (vector->flags & MOTIONSENSE_SENSOR_FLAG_FLUSH ?
-							" - Flush" :
-							""));
-				} else {
-					printf("Sensor %d: %d\t%d\t%d "
-					       "(as uint16: %u\t%u\t%u)\n",
-					       vector->sensor_num,
-					       vector->data[0], vector->data[1],
-					       vector->data[2], vector->data[0],
-					       vector->data[1],
-					       vector->data[2]);
-				}
-			}
+			for (i = 0; i < fifo_read_buffer.number_data; i++)
+				motionsense_print_fifo_entry(
+					&fifo_read_buffer.data[i]);
 		}
 		return 0;
 	}
@@ -11116,6 +11232,333 @@ int cmd_pd_log(int argc, char *argv[])
 	return 0;
 }
 
+static const char *pd_trace_sop_name(uint8_t sop)
+{
+	static const char *const names[] = {
+		"SOP",
+		"SOP'",
+		"SOP''",
+		"SOP'_Debug",
+		"SOP''_Debug",
+		"Hard_Reset",
+		"Cable_Reset",
+		"BIST_Mode_2",
+	};
+
+	return sop < ARRAY_SIZE(names) ? names[sop] : "???";
+}
+
+/* Last SOP* type carrying a message, the others are signaling */
+#define PD_TRACE_SOP_MSG_LAST 4
+
+/* Message types used to measure the Request to PS_RDY time */
+#define PD_TRACE_MSG_PS_RDY 6
+#define PD_TRACE_MSG_REQUEST 2
+
+/* VDM command used to measure the Enter Mode to ACK time */
+#define PD_TRACE_VDM_ENTER_MODE 4
+
+/* Name of a message type, as found in its header or in a TX request */
+static const char *pd_trace_msg_name(unsigned int type, bool data, bool ext)
+{
+	static const char *const ctrl_names[] = {
+		"Reserved",
+		"GoodCRC",
+		"GotoMin",
+		"Accept",
+		"Reject",
+		"Ping",
+		"PS_RDY",
+		"Get_Source_Cap",
+		"Get_Sink_Cap",
+		"DR_Swap",
+		"PR_Swap",
+		"VCONN_Swap",
+		"Wait",
+		"Soft_Reset",
+		"Data_Reset",
+		"Data_Reset_Complete",
+		"Not_Supported",
+		"Get_Source_Cap_Extended",
+		"Get_Status",
+		"FR_Swap",
+		"Get_PPS_Status",
+		"Get_Country_Codes",
+		"Get_Sink_Cap_Extended",
+		"Get_Source_Info",
+		"Get_Revision",
+	};
+	static const char *const data_names[] = {
+		"Reserved",
+		"Source_Capabilities",
+		"Request",
+		"BIST",
+		"Sink_Capabilities",
+		"Battery_Status",
+		"Alert",
+		"Get_Country_Info",
+		"Enter_USB",
+		"EPR_Request",
+		"EPR_Mode",
+		"Source_Info",
+		"Revision",
+		"Reserved",
+		"Reserved",
+		"Vendor_Defined",
+	};
+
+	if (ext)
+		return "Extended";
+	if (data)
+		return type < ARRAY_SIZE(data_names) ? data_names[type] :
+						       "Reserved";
+	return type < ARRAY_SIZE(ctrl_names) ? ctrl_names[type] : "Reserved";
+}
+
+static void pd_trace_print_header(uint16_t header)
+{
+	int type = header & 0x1f;
+	int cnt = (header >> 12) & 7;
+	bool ext = header >> 15;
+
+	printf(" %s", pd_trace_msg_name(type, cnt, ext));
+	if (ext)
+		printf(" type %d", type);
+	printf(" id %d", (header >> 9) & 7);
+	if (cnt)
+		printf(" %d objs", cnt);
+}
+
+static void pd_trace_print_vdm(uint8_t cmd, uint16_t svid)
+{
+	static const char *const cmd_names[] = {
+		"Reserved",
+		"Discover_Identity",
+		"Discover_SVIDs",
+		"Discover_Modes",
+		"Enter_Mode",
+		"Exit_Mode",
+		"Attention",
+	};
+	static const char *const cmd_types[] = {
+		"REQ",
+		"ACK",
+		"NAK",
+		"BUSY",
+	};
+	int command = cmd & 0x1f;
+
+	printf("VDM SVID 0x%04x", svid);
+	if (cmd & EC_PD_TRACE_VDM_UNSTRUCTURED) {
+		printf(" unstructured");
+		return;
+	}
+	if (command < ARRAY_SIZE(cmd_names))
+		printf(" %s", cmd_names[command]);
+	else
+		printf(" command %d", command);
+	printf(" %s", cmd_types[cmd >> 6]);
+}
+
+/* Name of a PE or TC state, asked to the EC once per state */
+static const char *pd_trace_state_name(int port, uint8_t action,
+				       uint16_t state)
+{
+	static std::map<uint32_t, std::string> names;
+	const uint32_t key = action << 16 | state;
+	auto it = names.find(key);
+
+	if (it == names.end()) {
+		struct ec_params_pd_trace p = {};
+		struct ec_response_pd_trace_state_name r;
+		std::string name;
+
+		p.port = port;
+		p.action = action;
+		p.seq = state;
+		if (ec_command(EC_CMD_PD_TRACE, 0, &p, sizeof(p), &r,
+			       sizeof(r)) >= 0) {
+			r.name[sizeof(r.name) - 1] = '\0';
+			name = r.name;
+		}
+		it = names.emplace(key, name).first;
+	}
+
+	return it->second.c_str();
+}
+
+static void pd_trace_print_state(const char *sm, int port, uint8_t action,
+				 uint16_t state)
+{
+	const char *name = pd_trace_state_name(port, action, state);
+
+	if (*name)
+		printf("%s %s", sm, name);
+	else
+		printf("%s state %u", sm, state);
+}
+
+int cmd_pd_trace(int argc, char *argv[])
+{
+	static const char *const tx_status[] = {
+		"GoodCRC",
+		"discarded",
+		"failed",
+	};
+	struct ec_params_pd_trace p;
+	struct ec_response_pd_trace *r =
+		(struct ec_response_pd_trace *)ec_inbuf;
+	uint32_t start = 0, prev = 0;
+	uint32_t req_time = 0, tx_time = 0, request_time = 0;
+	uint32_t enter_time = 0;
+	bool first = true, queued = false, requested = false;
+	bool entering = false;
+	char *e;
+	int rv;
+	int i;
+
+	if (argc == 3 && !strcasecmp(argv[2], "reset")) {
+		p.action = EC_PD_TRACE_RESET;
+	} else if (argc == 2) {
+		p.action = EC_PD_TRACE_GET;
+	} else {
+		fprintf(stderr, "Usage: %s <port> [reset]\n", argv[0]);
+		return -1;
+	}
+
+	p.port = strtol(argv[1], &e, 0);
+	if (e && *e) {
+		fprintf(stderr, "Bad port number '%s'.\n", argv[1]);
+		return -1;
+	}
+	p.reserved = 0;
+	p.seq = 0;
+
+	if (p.action == EC_PD_TRACE_RESET)
+		return ec_command(EC_CMD_PD_TRACE, 0, &p, sizeof(p), NULL, 0);
+
+	printf("  time(us) delta(us) event\n");
+	do {
+		rv = ec_command(EC_CMD_PD_TRACE, 0, &p, sizeof(p), ec_inbuf,
+				ec_max_insize);
+		if (rv < 0)
+			return rv;
+
+		if (!first && r->seq != p.seq)
+			printf("--- %u entries lost ---\n", r->seq - p.seq);
+
+		for (i = 0; i < r->count; i++) {
+			const struct ec_pd_trace_entry *t = &r->entries[i];
+			const uint32_t now = t->time_us;
+			const int type = t->data & 0x1f;
+			const int cnt = (t->data >> 12) & 7;
+			bool msg = false;
+
+			if (first) {
+				start = now;
+				prev = now;
+				first = false;
+			}
+			printf("%10u %9u ", now - start, now - prev);
+			prev = now;
+
+			switch (t->type) {
+			case EC_PD_TRACE_TX_REQUEST:
+				printf("TX request %s %s",
+				       pd_trace_sop_name(t->sop),
+				       pd_trace_msg_name(
+					       type,
+					       t->data & EC_PD_TRACE_REQ_DATA,
+					       t->data & EC_PD_TRACE_REQ_EXT));
+				req_time = now;
+				queued = true;
+				break;
+			case EC_PD_TRACE_TX_START:
+				printf("TX %s", pd_trace_sop_name(t->sop));
+				msg = t->sop <= PD_TRACE_SOP_MSG_LAST;
+				if (msg)
+					pd_trace_print_header(t->data);
+				if (queued)
+					printf(", queued %u us",
+					       now - req_time);
+				tx_time = now;
+				break;
+			case EC_PD_TRACE_TX_STATUS:
+				printf("TX %s %s after %u us",
+				       pd_trace_sop_name(t->sop),
+				       t->data < ARRAY_SIZE(tx_status) ?
+					       tx_status[t->data] :
+					       "???",
+				       now - tx_time);
+				break;
+			case EC_PD_TRACE_TX_COMPLETE:
+				printf("TX %s %s",
+				       pd_trace_sop_name(t->sop),
+				       t->data == EC_PD_TRACE_TX_SUCCESS ?
+					       "sent" :
+					       "error");
+				if (queued)
+					printf(", %u us after request",
+					       now - req_time);
+				queued = false;
+				break;
+			case EC_PD_TRACE_RX:
+				printf("RX %s", pd_trace_sop_name(t->sop));
+				pd_trace_print_header(t->data);
+				msg = true;
+				break;
+			case EC_PD_TRACE_PE_STATE:
+				pd_trace_print_state("PE", p.port,
+						     EC_PD_TRACE_PE_STATE_NAME,
+						     t->data);
+				break;
+			case EC_PD_TRACE_TC_STATE:
+				pd_trace_print_state("TC", p.port,
+						     EC_PD_TRACE_TC_STATE_NAME,
+						     t->data);
+				break;
+			case EC_PD_TRACE_VDM:
+				pd_trace_print_vdm(t->sop, t->data);
+				if (t->sop & EC_PD_TRACE_VDM_UNSTRUCTURED ||
+				    (t->sop & 0x1f) != PD_TRACE_VDM_ENTER_MODE)
+					break;
+
+				/* Time from Enter Mode to its reply */
+				if (!(t->sop >> 6)) {
+					enter_time = now;
+					entering = true;
+				} else if (entering) {
+					printf(", %u us after Enter_Mode",
+					       now - enter_time);
+					entering = false;
+				}
+				break;
+			default:
+				printf("event %u data 0x%04x", t->type,
+				       t->data);
+				break;
+			}
+
+			/* Time from a Request to its PS_RDY, either way */
+			if (msg && t->sop == 0 && !(t->data >> 15)) {
+				if (cnt && type == PD_TRACE_MSG_REQUEST) {
+					request_time = now;
+					requested = true;
+				} else if (!cnt && requested &&
+					   type == PD_TRACE_MSG_PS_RDY) {
+					printf(", %u us after Request",
+					       now - request_time);
+					requested = false;
+				}
+			}
+			printf("\n");
+		}
+		p.seq = r->seq + r->count;
+	} while (r->count);
+
+	return 0;
+}
+
 int cmd_pd_control(int argc, char *argv[])
 {
 	struct ec_params_pd_control p;
@@ -12333,6 +12776,7 @@ const struct command commands[] = {
 	{ "gpioget", cmd_gpio_get },
 	{ "gpioset", cmd_gpio_set },
 	{ "hangdetect", cmd_hang_detect },
+	{ "hcstats", cmd_hcstats },
 	{ "hello", cmd_hello },
 	{ "hibdelay", cmd_hibdelay },
 	{ "hostevent", cmd_hostevent },
@@ -12341,6 +12785,7 @@ const struct command commands[] = {
 	{ "i2cprotect", cmd_i2c_protect },
 	{ "i2cread", cmd_i2c_read },
 	{ "i2cspeed", cmd_i2c_speed },
+	{ "i2cstats", cmd_i2c_stats },
 	{ "i2cwrite", cmd_i2c_write },
 	{ "i2cxfer", cmd_i2c_xfer },
 	{ "infopddev", cmd_pd_device_info },
@@ -12364,6 +12809,7 @@ const struct command commands[] = {
 	{ "pdsetmode", cmd_pd_set_amode },
 	{ "port80read", cmd_port80_read },
 	{ "pdlog", cmd_pd_log },
+	{ "pdtrace", cmd_pd_trace },
 	{ "pdcontrol", cmd_pd_control },
 	{ "pdchipinfo", cmd_pd_chip_info },
 	{ "pdwritelog", cmd_pd_write_log },
@@ -5,8 +5,10 @@
 
 #include "comm-host.h"
 #include "ectool.h"
+#include "histogram.h"
 
 #include <ctype.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -396,3 +398,56 @@ int cmd_i2c_speed(int argc, char *argv[])
 
 	return i2c_set(port, speed);
 }
+
+int cmd_i2c_stats(int argc, char *argv[])
+{
+	struct ec_params_i2c_stats p;
+	struct ec_response_i2c_stats *r =
+		(struct ec_response_i2c_stats *)ec_inbuf;
+	int rv;
+	int i;
+
+	memset(&p, 0, sizeof(p));
+
+	if (argc == 2 && !strcasecmp(argv[1], "reset")) {
+		p.action = EC_I2C_STATS_RESET;
+		return ec_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p), NULL, 0);
+	} else if (argc != 1) {
+		fprintf(stderr, "Usage: %s [reset]\n", argv[0]);
+		return -1;
+	}
+
+	p.action = EC_I2C_STATS_GET;
+	printf("port addr    count     bytes  busy(us) retries timeouts errors"
+	       "   avg(us)   p99(us)   max(us)\n");
+	do {
+		rv = ec_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p), ec_inbuf,
+				ec_max_insize);
+		if (rv < 0)
+			return rv;
+
+		for (i = 0; i < r->count; i++) {
+			const struct ec_i2c_stats_slot *s = &r->slots[i];
+
+			if (!s->count)
+				continue;
+
+			printf("%4u 0x%02x %8u %9u %9" PRIu64
+			       " %7u %8u %6u %9" PRIu64 " %9u %9u\n",
+			       s->port, s->addr, s->count, s->bytes,
+			       s->busy_us, s->retries, s->timeouts, s->errors,
+			       s->busy_us / s->count,
+			       histogram_percentile(s->histogram,
+						    EC_I2C_STATS_BUCKETS,
+						    s->max_us, 99),
+			       s->max_us);
+		}
+		p.index += r->count;
+	} while (r->count && p.index < r->num_slots);
+
+	if (r->untracked)
+		printf("%u transactions with untracked peripherals\n",
+		       r->untracked);
+
+	return 0;
+}
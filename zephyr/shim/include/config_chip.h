@@ -218,6 +218,16 @@
 #define CONFIG_BATTERY_SMART
 #endif
 
+#undef CONFIG_BATTERY_SMART_CACHE
+#ifdef CONFIG_PLATFORM_EC_BATTERY_SMART_CACHE
+#define CONFIG_BATTERY_SMART_CACHE
+#endif
+
+#undef CONFIG_BATTERY_SMART_BURST_READ
+#ifdef CONFIG_PLATFORM_EC_BATTERY_SMART_BURST_READ
+#define CONFIG_BATTERY_SMART_BURST_READ
+#endif
+
 #undef CONFIG_I2C_VIRTUAL_BATTERY
 #undef I2C_PORT_VIRTUAL_BATTERY
 #ifdef CONFIG_PLATFORM_EC_I2C_VIRTUAL_BATTERY
@@ -235,6 +245,11 @@
 #define CONFIG_I2C_PASSTHRU_RESTRICTED
 #endif
 
+#undef CONFIG_I2C_XFER_ASYNC
+#ifdef CONFIG_PLATFORM_EC_I2C_XFER_ASYNC
+#define CONFIG_I2C_XFER_ASYNC
+#endif
+
 #undef CONFIG_CMD_I2C_SPEED
 #ifdef CONFIG_PLATFORM_EC_CONSOLE_CMD_I2C_SPEED
 #define CONFIG_CMD_I2C_SPEED
@@ -783,6 +798,13 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_I2C_DEBUG
 #endif
 
+#undef CONFIG_I2C_STATS
+#undef CONFIG_I2C_STATS_SLOTS
+#ifdef CONFIG_PLATFORM_EC_I2C_STATS
+#define CONFIG_I2C_STATS
+#define CONFIG_I2C_STATS_SLOTS CONFIG_PLATFORM_EC_I2C_STATS_SLOTS
+#endif
+
 #undef CONFIG_I2C_DEBUG_PASSTHRU
 #ifdef CONFIG_PLATFORM_EC_I2C_DEBUG_PASSTHRU
 #define CONFIG_I2C_DEBUG_PASSTHRU
@@ -1245,6 +1267,14 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_CHARGE_STATE_DEBUG
 #endif
 
+#undef CONFIG_CHARGE_STATE_EVENT_DRIVEN
+#undef CONFIG_CHARGE_STATE_MAX_POLL_SHIFT
+#ifdef CONFIG_PLATFORM_EC_CHARGE_STATE_EVENT_DRIVEN
+#define CONFIG_CHARGE_STATE_EVENT_DRIVEN
+#define CONFIG_CHARGE_STATE_MAX_POLL_SHIFT \
+	CONFIG_PLATFORM_EC_CHARGE_STATE_MAX_POLL_SHIFT
+#endif
+
 #undef CONFIG_CHARGE_DEBUG
 #ifdef CONFIG_PLATFORM_EC_CHARGE_DEBUG
 #define CONFIG_CHARGE_DEBUG
@@ -1640,6 +1670,18 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_USB_DPM_SM
 #endif
 
+#undef CONFIG_USB_SM_STATS
+#ifdef CONFIG_PLATFORM_EC_USB_SM_STATS
+#define CONFIG_USB_SM_STATS
+#endif
+
+#undef CONFIG_USB_PD_TRACE
+#undef CONFIG_USB_PD_TRACE_ENTRIES
+#ifdef CONFIG_PLATFORM_EC_USB_PD_TRACE
+#define CONFIG_USB_PD_TRACE
+#define CONFIG_USB_PD_TRACE_ENTRIES CONFIG_PLATFORM_EC_USB_PD_TRACE_ENTRIES
+#endif
+
 #undef CONFIG_USB_PD_DECODE_SOP
 #ifdef CONFIG_PLATFORM_EC_USB_PD_DECODE_SOP
 #define CONFIG_USB_PD_DECODE_SOP
@@ -1730,6 +1772,11 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_USB_PD_TCPM_TCPCI
 #endif
 
+#undef CONFIG_USB_PD_TCPCI_REG_CACHE
+#ifdef CONFIG_PLATFORM_EC_USB_PD_TCPCI_REG_CACHE
+#define CONFIG_USB_PD_TCPCI_REG_CACHE
+#endif
+
 #undef CONFIG_USB_PD_TCPM_ITE_ON_CHIP
 #ifdef CONFIG_PLATFORM_EC_USB_PD_TCPM_ITE_ON_CHIP
 #define CONFIG_USB_PD_TCPM_ITE_ON_CHIP
@@ -1804,7 +1851,9 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 
 /* USBC-PD Port 1 */
 #if CONFIG_USB_PD_PORT_MAX_COUNT > 1
+#ifndef CONFIG_PLATFORM_EC_USB_PD_TASK_SHARED
 #define HAS_TASK_PD_C1 1
+#endif
 
 #ifndef CONFIG_PLATFORM_EC_USB_PD_PORT_1_SHARED
 #define HAS_TASK_PD_INT_C1 1
@@ -1814,7 +1863,9 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 
 /* USBC-PD Port 2 */
 #if CONFIG_USB_PD_PORT_MAX_COUNT > 2
+#ifndef CONFIG_PLATFORM_EC_USB_PD_TASK_SHARED
 #define HAS_TASK_PD_C2 1
+#endif
 
 #ifndef CONFIG_PLATFORM_EC_USB_PD_PORT_2_SHARED
 #define HAS_TASK_PD_INT_C2 1
@@ -1824,7 +1875,9 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 
 /* USBC-PD Port 3 */
 #if CONFIG_USB_PD_PORT_MAX_COUNT > 3
+#ifndef CONFIG_PLATFORM_EC_USB_PD_TASK_SHARED
 #define HAS_TASK_PD_C3 1
+#endif
 
 #ifndef CONFIG_PLATFORM_EC_USB_PD_PORT_3_SHARED
 #define HAS_TASK_PD_INT_C3 1
@@ -2186,6 +2239,16 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 	CONFIG_PLATFORM_EC_USB_PD_STARTUP_DELAY_MS
 #endif
 
+#undef CONFIG_USB_PD_TASK_TICKLESS
+#ifdef CONFIG_PLATFORM_EC_USB_PD_TASK_TICKLESS
+#define CONFIG_USB_PD_TASK_TICKLESS
+#endif
+
+#undef CONFIG_USB_PD_TASK_SHARED
+#ifdef CONFIG_PLATFORM_EC_USB_PD_TASK_SHARED
+#define CONFIG_USB_PD_TASK_SHARED
+#endif
+
 #undef CONFIG_USB_PD_3A_PORTS
 #ifdef CONFIG_PLATFORM_EC_CONFIG_USB_PD_3A_PORTS
 #define CONFIG_USB_PD_3A_PORTS CONFIG_PLATFORM_EC_CONFIG_USB_PD_3A_PORTS
@@ -2653,6 +2716,19 @@ BUILD_ASSERT((DT_NUM_INST_STATUS_OKAY(maxim_max695x)) == 1,
 #define CONFIG_HOST_COMMAND_STATUS
 #endif
 
+#undef CONFIG_HOST_COMMAND_STATS
+#undef CONFIG_HOST_COMMAND_STATS_SLOTS
+#ifdef CONFIG_PLATFORM_EC_HOST_COMMAND_STATS
+#define CONFIG_HOST_COMMAND_STATS
+#define CONFIG_HOST_COMMAND_STATS_SLOTS \
+	CONFIG_PLATFORM_EC_HOST_COMMAND_STATS_SLOTS
+#endif
+
+#undef CONFIG_TASK_WAKE_LATENCY
+#ifdef CONFIG_PLATFORM_EC_TASK_WAKE_LATENCY
+#define CONFIG_TASK_WAKE_LATENCY
+#endif
+
 #undef CONFIG_SWITCH
 #ifdef CONFIG_PLATFORM_EC_SWITCH
 #define CONFIG_SWITCH
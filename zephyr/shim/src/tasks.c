@@ -205,6 +205,13 @@ task_id_t thread_id_to_task_id(k_tid_t thread_id)
 	return TASK_ID_INVALID;
 }
 
+const char *task_get_name(task_id_t tskid)
+{
+	const char *name = k_thread_name_get(task_id_to_thread_id(tskid));
+
+	return name ? name : "";
+}
+
 task_id_t task_get_current(void)
 {
 	return thread_id_to_task_id(k_current_get());
@@ -226,6 +233,9 @@ void task_set_event(task_id_t cros_task_id, uint32_t event)
 	data = task_get_base_data(cros_task_id);
 
 	if (data != NULL) {
+#ifdef CONFIG_TASK_WAKE_LATENCY
+		task_wake_latency_start(cros_task_id);
+#endif
 		atomic_or(&data->event_mask, event);
 		k_poll_signal_raise(&data->new_event, 0);
 	}
@@ -253,6 +263,9 @@ uint32_t task_wait_event(int timeout_us)
 	/* Wait for signal, then clear it before reading events */
 	const int rv = k_poll(poll_events, ARRAY_SIZE(poll_events), timeout);
 
+#ifdef CONFIG_TASK_WAKE_LATENCY
+	task_wake_latency_end(task_get_current());
+#endif
 	k_poll_signal_reset(&data->new_event);
 	uint32_t events = atomic_set(&data->event_mask, 0);
 